@@ -0,0 +1,226 @@
+#include "SyntheticHits.h"
+#include <algorithm>
+#include <cmath>
+#include "icetray/I3Units.h"
+#include "dataclasses/I3Constants.h"
+
+namespace {
+  const double STRING_SPACING = 125*I3Units::m;
+  const double DOM_SPACING = 17*I3Units::m;
+  const unsigned int N_ICECUBE_STRINGS = 78;
+  const unsigned int N_DEEPCORE_STRINGS = 8;
+  const unsigned int N_ICETOP_STATIONS = 81;
+
+  // in-ice LC: 2 DOMs up and down the string, 1 microsecond
+  const int LC_SPAN = 2;
+  const double LC_WINDOW = 1*I3Units::microsecond;
+
+  // Tracks: a DOM at distance d sees the track with probability
+  // exp(-d/TRACK_ATTENUATION), late by scattering on the order of
+  // d*TRACK_SCATTER_DELAY
+  const double TRACK_RADIUS = 600*I3Units::m;
+  const double TRACK_HALF_HEIGHT = 500*I3Units::m;
+  const double TRACK_MAX_DISTANCE = 200*I3Units::m;
+  const double TRACK_ATTENUATION = 30*I3Units::m;
+  const double TRACK_SCATTER_DELAY = 1*I3Units::ns/I3Units::m;
+
+  // Whether a hit of times is within window of time
+  bool HasHitNear(const std::vector<double>& times, double time, double window){
+    std::vector<double>::const_iterator i = std::lower_bound(times.begin(), times.end(), time - window);
+    return i != times.end() && *i <= time + window;
+  }
+}
+
+SyntheticHitConfig::SyntheticHitConfig() :
+  duration(100*I3Units::microsecond),
+  noiseRate(500*I3Units::hertz),
+  iceTopNoiseRate(1500*I3Units::hertz),
+  burstRate(20*I3Units::hertz),
+  burstHits(4),
+  burstLength(3*I3Units::microsecond),
+  trackRate(3*I3Units::kilohertz)
+{
+}
+
+SyntheticHitGenerator::SyntheticHitGenerator(const SyntheticHitConfig& config,
+                                             I3GeometryConstPtr geometry,
+                                             I3RandomServicePtr random) :
+  config_(config),
+  geometry_(geometry),
+  random_(random)
+{
+  if(!geometry_)
+    log_fatal("SyntheticHitGenerator needs a geometry");
+  if(!random_)
+    log_fatal("SyntheticHitGenerator needs a random service");
+
+  for(I3OMGeoMap::const_iterator iter = geometry_->omgeo.begin(); iter != geometry_->omgeo.end(); iter++){
+    if(iter->second.omtype == I3OMGeo::IceTop)
+      icetopDOMs_.push_back(iter->first);
+    else
+      iniceDOMs_.push_back(iter->first);
+  }
+}
+
+I3GeometryPtr SyntheticHitGenerator::MakeIC86Geometry()
+{
+  // The points of a triangular grid closest to the center, numbered row
+  // by row like the IceCube strings
+  std::vector<std::pair<double, double> > grid;
+  for(int q = -6; q <= 6; q++){
+    for(int r = -6; r <= 6; r++){
+      grid.push_back(std::make_pair(STRING_SPACING*(q + 0.5*r), STRING_SPACING*(r*std::sqrt(3.)/2)));
+    }
+  }
+  std::stable_sort(grid.begin(), grid.end(),
+                   [](const std::pair<double, double>& a, const std::pair<double, double>& b){
+                     return std::hypot(a.first, a.second) < std::hypot(b.first, b.second);
+                   });
+  grid.resize(N_ICECUBE_STRINGS);
+  std::sort(grid.begin(), grid.end(),
+            [](const std::pair<double, double>& a, const std::pair<double, double>& b){
+              return a.second != b.second ? a.second > b.second : a.first < b.first;
+            });
+
+  // DeepCore strings on a ring around the center string
+  for(unsigned int i = 0; i < N_DEEPCORE_STRINGS; i++){
+    double angle = 2*M_PI*i/N_DEEPCORE_STRINGS;
+    grid.push_back(std::make_pair(70*I3Units::m*std::cos(angle), 70*I3Units::m*std::sin(angle)));
+  }
+
+  I3GeometryPtr geometry(new I3Geometry());
+  for(unsigned int i = 0; i < grid.size(); i++){
+    int string = i + 1;
+    double x = grid[i].first;
+    double y = grid[i].second;
+
+    for(unsigned int om = 1; om <= 60; om++){
+      I3OMGeo omgeo;
+      omgeo.omtype = I3OMGeo::IceCube;
+      if(i < N_ICECUBE_STRINGS)
+        omgeo.position = I3Position(x, y, 500*I3Units::m - DOM_SPACING*(om - 1));
+      else if(om <= 10)
+        omgeo.position = I3Position(x, y, 190*I3Units::m - 10*I3Units::m*(om - 1));
+      else
+        omgeo.position = I3Position(x, y, -160*I3Units::m - 7*I3Units::m*(om - 11));
+      geometry->omgeo[OMKey(string, om)] = omgeo;
+    }
+
+    if(static_cast<unsigned int>(string) <= N_ICETOP_STATIONS){
+      // two tanks of two DOMs
+      for(unsigned int om = 61; om <= 64; om++){
+        I3OMGeo omgeo;
+        omgeo.omtype = I3OMGeo::IceTop;
+        double tank = om < 63 ? -5*I3Units::m : 5*I3Units::m;
+        omgeo.position = I3Position(x + tank, y, I3Constants::zIceTop);
+        geometry->omgeo[OMKey(string, om)] = omgeo;
+      }
+    }
+  }
+  return geometry;
+}
+
+void SyntheticHitGenerator::Generate(I3DOMLaunchSeriesMap& inice, I3DOMLaunchSeriesMap& icetop)
+{
+  HitTimes iniceHits;
+  HitTimes icetopHits;
+
+  AddNoise(iniceHits, iniceDOMs_, config_.noiseRate);
+  AddNoise(icetopHits, icetopDOMs_, config_.iceTopNoiseRate);
+  AddBursts(iniceHits);
+  int nTracks = random_->Poisson(config_.trackRate*config_.duration);
+  for(int i = 0; i < nTracks; i++)
+    AddTrack(iniceHits);
+
+  MakeLaunches(iniceHits, inice, false);
+  MakeLaunches(icetopHits, icetop, true);
+}
+
+void SyntheticHitGenerator::AddNoise(HitTimes& hits, const std::vector<OMKey>& doms, double rate)
+{
+  double mean = rate*config_.duration;
+  for(std::vector<OMKey>::const_iterator dom = doms.begin(); dom != doms.end(); dom++){
+    int n = random_->Poisson(mean);
+    for(int i = 0; i < n; i++)
+      hits[*dom].push_back(random_->Uniform(0, config_.duration));
+  }
+}
+
+void SyntheticHitGenerator::AddBursts(HitTimes& hits)
+{
+  double mean = config_.burstRate*config_.duration;
+  for(std::vector<OMKey>::const_iterator dom = iniceDOMs_.begin(); dom != iniceDOMs_.end(); dom++){
+    int n = random_->Poisson(mean);
+    for(int i = 0; i < n; i++){
+      double start = random_->Uniform(0, config_.duration);
+      int nHits = 1 + random_->Poisson(std::max(config_.burstHits - 1, 0.));
+      for(int j = 0; j < nHits; j++)
+        hits[*dom].push_back(start + random_->Uniform(0, config_.burstLength));
+    }
+  }
+}
+
+void SyntheticHitGenerator::AddTrack(HitTimes& hits)
+{
+  // Down-going, through a random point of the detector at a random time
+  double zenith = std::acos(random_->Uniform(0, 1));
+  double azimuth = random_->Uniform(0, 2*M_PI);
+  double dir[3] = {-std::sin(zenith)*std::cos(azimuth),
+                   -std::sin(zenith)*std::sin(azimuth),
+                   -std::cos(zenith)};
+  double r = TRACK_RADIUS*std::sqrt(random_->Uniform(0, 1));
+  double phi = random_->Uniform(0, 2*M_PI);
+  double vertex[3] = {r*std::cos(phi), r*std::sin(phi),
+                      random_->Uniform(-TRACK_HALF_HEIGHT, TRACK_HALF_HEIGHT)};
+  double t0 = random_->Uniform(0, config_.duration);
+
+  const double tanCherenkov = std::tan(I3Constants::theta_cherenkov);
+  const double sinCherenkov = std::sin(I3Constants::theta_cherenkov);
+
+  for(std::vector<OMKey>::const_iterator dom = iniceDOMs_.begin(); dom != iniceDOMs_.end(); dom++){
+    const I3Position& pos = geometry_->omgeo.find(*dom)->second.position;
+    double v[3] = {pos.GetX() - vertex[0], pos.GetY() - vertex[1], pos.GetZ() - vertex[2]};
+    double along = v[0]*dir[0] + v[1]*dir[1] + v[2]*dir[2];
+    double d2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2] - along*along;
+    double d = std::sqrt(std::max(d2, 0.));
+    if(d > TRACK_MAX_DISTANCE || random_->Uniform(0, 1) >= std::exp(-d/TRACK_ATTENUATION))
+      continue;
+
+    // direct Cherenkov light, plus the delay of scattering
+    double time = t0 + (along - d/tanCherenkov)/I3Constants::c
+      + d/sinCherenkov/I3Constants::c_ice
+      + random_->Exp(d*TRACK_SCATTER_DELAY + 1*I3Units::ns);
+    hits[*dom].push_back(time);
+  }
+}
+
+void SyntheticHitGenerator::MakeLaunches(HitTimes& hits, I3DOMLaunchSeriesMap& launches, bool icetop) const
+{
+  for(HitTimes::iterator iter = hits.begin(); iter != hits.end(); iter++)
+    std::sort(iter->second.begin(), iter->second.end());
+
+  launches.clear();
+  for(HitTimes::const_iterator iter = hits.begin(); iter != hits.end(); iter++){
+    const OMKey& dom = iter->first;
+
+    // the neighbours that make a launch HLC
+    std::vector<const std::vector<double>*> neighbours;
+    for(HitTimes::const_iterator other = hits.lower_bound(OMKey(dom.GetString(), 0));
+        other != hits.end() && other->first.GetString() == dom.GetString(); other++){
+      int distance = std::abs(static_cast<int>(other->first.GetOM()) - static_cast<int>(dom.GetOM()));
+      if(other->first != dom && (icetop || distance <= LC_SPAN))
+        neighbours.push_back(&other->second);
+    }
+
+    I3DOMLaunchSeries& series = launches[dom];
+    series.resize(iter->second.size());
+    for(size_t i = 0; i < iter->second.size(); i++){
+      double time = iter->second[i];
+      bool lc = false;
+      for(size_t j = 0; j < neighbours.size() && !lc; j++)
+        lc = HasHitNear(*neighbours[j], time, LC_WINDOW);
+      series[i].SetStartTime(time);
+      series[i].SetLCBit(lc);
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#ifndef SYNTHETIC_HITS_H
+#define SYNTHETIC_HITS_H
+
+#include <map>
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "icetray/OMKey.h"
+#include "dataclasses/geometry/I3Geometry.h"
+#include "dataclasses/physics/I3DOMLaunch.h"
+#include "phys-services/I3RandomService.h"
+
+/**
+ * @brief Settings of the synthetic hit streams.  Rates are in I3Units,
+ * so rate*duration is the mean number of hits (or bursts, or tracks).
+ */
+struct SyntheticHitConfig
+{
+  SyntheticHitConfig();
+
+  // length of the stream of one frame
+  double duration;
+  // Poisson dark noise of each in-ice and IceTop DOM
+  double noiseRate;
+  double iceTopNoiseRate;
+  // correlated noise: bursts of SLC hits of a single in-ice DOM
+  double burstRate;
+  double burstHits;
+  double burstLength;
+  // muon-like tracks through the in-ice detector
+  double trackRate;
+};
+
+/**
+ * @brief Reproducible synthetic launches over an IC86-like detector, for
+ * the trigger benchmarks.
+ *
+ * The launches of a frame are the dark noise, the correlated noise bursts
+ * and the Cherenkov hits of muon-like tracks.  The LC bit of a launch is
+ * set like in the detector: in-ice if a DOM within 2 on the same string
+ * has a launch within 1 microsecond, IceTop if another DOM of the station
+ * has one.
+ */
+class SyntheticHitGenerator
+{
+ public:
+
+  SyntheticHitGenerator(const SyntheticHitConfig& config,
+                        I3GeometryConstPtr geometry,
+                        I3RandomServicePtr random);
+
+  ~SyntheticHitGenerator() = default;
+
+  /**
+   * Replace the maps with the launches of the next frame.
+   */
+  void Generate(I3DOMLaunchSeriesMap& inice, I3DOMLaunchSeriesMap& icetop);
+
+  /**
+   * 78 strings of 60 DOMs on a 125 m triangular grid, 8 denser DeepCore
+   * strings in its center and an IceTop station of 4 DOMs on strings 1-81.
+   */
+  static I3GeometryPtr MakeIC86Geometry();
+
+ private:
+
+  SyntheticHitGenerator();
+
+  typedef std::map<OMKey, std::vector<double> > HitTimes;
+
+  void AddNoise(HitTimes& hits, const std::vector<OMKey>& doms, double rate);
+  void AddBursts(HitTimes& hits);
+  void AddTrack(HitTimes& hits);
+  void MakeLaunches(HitTimes& hits, I3DOMLaunchSeriesMap& launches, bool icetop) const;
+
+  SyntheticHitConfig config_;
+  I3GeometryConstPtr geometry_;
+  I3RandomServicePtr random_;
+
+  std::vector<OMKey> iniceDOMs_;
+  std::vector<OMKey> icetopDOMs_;
+
+  SET_LOGGER("SyntheticHitGenerator");
+};
+
+#endif // SYNTHETIC_HITS_H
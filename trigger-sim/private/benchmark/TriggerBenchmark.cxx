@@ -0,0 +1,562 @@
+/**
+ * Benchmarks of the triggers on synthetic launches over an IC86-like
+ * detector.
+ *
+ * The micro benchmarks time FillHits and Trigger of each TriggerService
+ * with the IC86 settings, the chain benchmark runs I3TriggerSimModule,
+ * I3GlobalTriggerSim and I3Pruner in an I3Tray.  Both report the hits per
+ * second and the heap allocations per frame, and --json writes the
+ * results for tracking them over time.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "icetray/I3Tray.h"
+#include "icetray/I3Module.h"
+#include "icetray/I3Frame.h"
+#include "icetray/I3Units.h"
+#include "dataclasses/TriggerKey.h"
+#include "dataclasses/status/I3DetectorStatus.h"
+#include "phys-services/I3GSLRandomService.h"
+
+#include "trigger-sim/algorithms/TriggerHitCache.h"
+#include "trigger-sim/algorithms/SimpleMajorityTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/ClusterTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/CylinderTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/SlowMonopoleTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/FaintParticleTriggerAlgorithm.h"
+#include "trigger-sim/utilities/DOMSetFunctions.h"
+#include "trigger-sim/utilities/DOMSetTable.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+
+#include "SyntheticHits.h"
+
+//*****************************
+// Count the heap allocations of the whole program
+//*****************************
+namespace {
+  std::atomic<unsigned long> allocations(0);
+}
+
+void* operator new(std::size_t size)
+{
+  allocations++;
+  void* p = std::malloc(size ? size : 1);
+  if(!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+  typedef std::chrono::steady_clock Clock;
+
+  double Seconds(Clock::duration duration){
+    return std::chrono::duration<double>(duration).count();
+  }
+
+  struct Options
+  {
+    Options() : frames(200), seed(1), threads(1), micro(true), chain(true) {}
+
+    unsigned int frames;
+    unsigned int seed;
+    unsigned int threads;
+    SyntheticHitConfig hits;
+    std::string json;
+    bool micro;
+    bool chain;
+  };
+
+  struct Result
+  {
+    Result(const std::string& n) : name(n), frames(0), hits(0), triggers(0), seconds(0), allocations(0) {}
+
+    std::string name;
+    unsigned long frames;
+    unsigned long hits;
+    unsigned long triggers;
+    double seconds;
+    unsigned long allocations;
+  };
+
+  // What the synthetic source did in the chain benchmark, so that it can
+  // be taken out of the numbers of the trigger modules
+  struct SourceStatistics
+  {
+    unsigned long frames;
+    unsigned long hits;
+    double seconds;
+    unsigned long allocations;
+  };
+  SourceStatistics sourceStatistics = {0, 0, 0., 0};
+
+  void Usage(const char* program)
+  {
+    SyntheticHitConfig defaults;
+    printf("Usage: %s [options]\n"
+           "  --frames N             frames to run (200)\n"
+           "  --duration US          length of a frame in microseconds (%g)\n"
+           "  --noise-rate HZ        dark noise rate of an in-ice DOM (%g)\n"
+           "  --icetop-noise-rate HZ dark noise rate of an IceTop DOM (%g)\n"
+           "  --burst-rate HZ        correlated noise bursts of an in-ice DOM (%g)\n"
+           "  --burst-hits N         mean number of hits of a burst (%g)\n"
+           "  --track-rate HZ        rate of muon-like tracks (%g)\n"
+           "  --seed N               random seed (1)\n"
+           "  --threads N            NumThreads of I3TriggerSimModule (1)\n"
+           "  --json FILE            also write the results to FILE\n"
+           "  --micro-only           skip the I3Tray chain\n"
+           "  --chain-only           skip the single triggers\n",
+           program,
+           defaults.duration/I3Units::microsecond,
+           defaults.noiseRate/I3Units::hertz,
+           defaults.iceTopNoiseRate/I3Units::hertz,
+           defaults.burstRate/I3Units::hertz,
+           defaults.burstHits,
+           defaults.trackRate/I3Units::hertz);
+  }
+
+  bool ParseOptions(int argc, char** argv, Options& options)
+  {
+    for(int i = 1; i < argc; i++){
+      std::string option(argv[i]);
+      if(option == "--micro-only"){
+        options.chain = false;
+        continue;
+      }
+      if(option == "--chain-only"){
+        options.micro = false;
+        continue;
+      }
+      if(i + 1 >= argc)
+        return false;
+      const char* value = argv[++i];
+
+      if(option == "--frames")
+        options.frames = std::strtoul(value, NULL, 10);
+      else if(option == "--duration")
+        options.hits.duration = std::atof(value)*I3Units::microsecond;
+      else if(option == "--noise-rate")
+        options.hits.noiseRate = std::atof(value)*I3Units::hertz;
+      else if(option == "--icetop-noise-rate")
+        options.hits.iceTopNoiseRate = std::atof(value)*I3Units::hertz;
+      else if(option == "--burst-rate")
+        options.hits.burstRate = std::atof(value)*I3Units::hertz;
+      else if(option == "--burst-hits")
+        options.hits.burstHits = std::atof(value);
+      else if(option == "--track-rate")
+        options.hits.trackRate = std::atof(value)*I3Units::hertz;
+      else if(option == "--seed")
+        options.seed = std::strtoul(value, NULL, 10);
+      else if(option == "--threads")
+        options.threads = std::strtoul(value, NULL, 10);
+      else if(option == "--json")
+        options.json = value;
+      else
+        return false;
+    }
+    return options.frames > 0;
+  }
+
+  //*****************************
+  // The IC86 trigger settings
+  //*****************************
+  void AddTrigger(I3DetectorStatus& status, TriggerKey::SourceID source, TriggerKey::TypeID type,
+                  int configID, const std::map<std::string, std::string>& settings)
+  {
+    I3TriggerStatus triggerStatus;
+    triggerStatus.GetTriggerSettings() = settings;
+
+    I3TriggerReadoutConfig inice;
+    inice.readoutTimeMinus = 4*I3Units::microsecond;
+    inice.readoutTimePlus = 6*I3Units::microsecond;
+    inice.readoutTimeOffset = 0;
+    I3TriggerReadoutConfig icetop;
+    icetop.readoutTimeMinus = 10*I3Units::microsecond;
+    icetop.readoutTimePlus = 10*I3Units::microsecond;
+    icetop.readoutTimeOffset = 0;
+    triggerStatus.GetReadoutSettings()[I3TriggerStatus::INICE] = inice;
+    triggerStatus.GetReadoutSettings()[I3TriggerStatus::ICETOP] = icetop;
+
+    status.triggerStatus[TriggerKey(source, type, configID)] = triggerStatus;
+  }
+
+  I3DetectorStatusPtr MakeDetectorStatus()
+  {
+    I3DetectorStatusPtr status(new I3DetectorStatus());
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::SIMPLE_MULTIPLICITY, 1006,
+               {{"timeWindow", "5000"}, {"threshold", "8"}, {"domSet", "2"}});
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::SIMPLE_MULTIPLICITY, 1011,
+               {{"timeWindow", "2500"}, {"threshold", "3"}, {"domSet", "5"}});
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::STRING, 1007,
+               {{"timeWindow", "1500"}, {"multiplicity", "5"}, {"coherenceLength", "7"}, {"domSet", "2"}});
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::VOLUME, 21001,
+               {{"timeWindow", "1000"}, {"multiplicity", "4"}, {"simpleMultiplicity", "8"},
+                {"radius", "175"}, {"height", "75"}, {"domSet", "2"}});
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::SLOW_PARTICLE, 24002,
+               {{"t_proximity", "2500"}, {"t_min", "0"}, {"t_max", "500000"}, {"delta_d", "100"},
+                {"alpha_min", "140"}, {"dc_algo", "1"}, {"rel_v", "0.5"}, {"min_n_tuples", "1"},
+                {"max_event_length", "5000000"}, {"domSet", "2"}});
+    AddTrigger(*status, TriggerKey::IN_ICE, TriggerKey::FAINT_PARTICLE, 33001,
+               {{"time_window", "2000"}, {"time_window_separation", "500"}, {"max_trigger_length", "6000"},
+                {"hit_min", "4"}, {"hit_max", "80"}, {"double_velocity_min", "100000"},
+                {"double_velocity_max", "3000000"}, {"double_min", "5"}, {"azimuth_histogram_min", "6"},
+                {"zenith_histogram_min", "5"}, {"histogram_binning", "10"}, {"slcfraction_min", "0"},
+                {"domSet", "2"}});
+    AddTrigger(*status, TriggerKey::ICE_TOP, TriggerKey::SIMPLE_MULTIPLICITY, 102,
+               {{"timeWindow", "200"}, {"threshold", "6"}, {"domSet", "3"}});
+    return status;
+  }
+
+  //*****************************
+  // Micro benchmarks: one TriggerService at a time
+  //*****************************
+  struct BenchmarkedService
+  {
+    std::string name;
+    bool icetop;
+    bool useSLC;
+    std::unique_ptr<TriggerService> service;
+  };
+
+  void AddService(std::vector<BenchmarkedService>& services, const std::string& name,
+                  bool icetop, bool useSLC, TriggerService* service,
+                  DOMSetTableConstPtr domSetTable)
+  {
+    service->SetDOMSetTable(domSetTable);
+    services.push_back(BenchmarkedService{name, icetop, useSLC, std::unique_ptr<TriggerService>(service)});
+  }
+
+  std::vector<Result> RunMicroBenchmarks(const Options& options)
+  {
+    I3GeometryConstPtr geometry = SyntheticHitGenerator::MakeIC86Geometry();
+    DOMPositionTableConstPtr positions(new DOMPositionTable(*geometry));
+    I3MapKeyVectorIntConstPtr domSets(DOMSetFunctions::GetDefaultDOMSets());
+    DOMSetTableConstPtr domSetTable(new DOMSetTable(domSets));
+
+    // The same settings as MakeDetectorStatus
+    std::vector<BenchmarkedService> services;
+    AddService(services, "SMT8", false, false,
+               new SimpleMajorityTriggerAlgorithm(5000, 8, 2, domSets), domSetTable);
+    AddService(services, "SMT3", false, false,
+               new SimpleMajorityTriggerAlgorithm(2500, 3, 5, domSets), domSetTable);
+    AddService(services, "String", false, false,
+               new ClusterTriggerAlgorithm(1500, 5, 7, 2, domSets), domSetTable);
+    AddService(services, "Volume", false, false,
+               new CylinderTriggerAlgorithm(1000, 4, 8, geometry, 175, 75, 2, domSets, positions),
+               domSetTable);
+    AddService(services, "SLOP", false, false,
+               new SlowMonopoleTriggerAlgorithm(2500, 0, 500000, 100., 140., true, 0.5, 1, 5000000,
+                                                geometry, 2, domSets),
+               domSetTable);
+    AddService(services, "FPT", false, true,
+               new FaintParticleTriggerAlgorithm(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                                 geometry, 2, domSets, positions),
+               domSetTable);
+    AddService(services, "IceTopSMT", true, false,
+               new SimpleMajorityTriggerAlgorithm(200, 6, 3, domSets), domSetTable);
+
+    // All frames up front, so that generating them is not timed
+    SyntheticHitGenerator generator(options.hits, geometry,
+                                    I3RandomServicePtr(new I3GSLRandomService(options.seed)));
+    std::vector<I3DOMLaunchSeriesMapConstPtr> inice(options.frames);
+    std::vector<I3DOMLaunchSeriesMapConstPtr> icetop(options.frames);
+    std::vector<unsigned long> iniceHits(options.frames, 0);
+    std::vector<unsigned long> icetopHits(options.frames, 0);
+    for(unsigned int frame = 0; frame < options.frames; frame++){
+      I3DOMLaunchSeriesMapPtr iniceLaunches(new I3DOMLaunchSeriesMap());
+      I3DOMLaunchSeriesMapPtr icetopLaunches(new I3DOMLaunchSeriesMap());
+      generator.Generate(*iniceLaunches, *icetopLaunches);
+      for(I3DOMLaunchSeriesMap::const_iterator iter = iniceLaunches->begin(); iter != iniceLaunches->end(); iter++)
+        iniceHits[frame] += iter->second.size();
+      for(I3DOMLaunchSeriesMap::const_iterator iter = icetopLaunches->begin(); iter != icetopLaunches->end(); iter++)
+        icetopHits[frame] += iter->second.size();
+      inice[frame] = iniceLaunches;
+      icetop[frame] = icetopLaunches;
+    }
+
+    // Like in I3TriggerSimModule, the hits of a frame are extracted once
+    // for all triggers
+    std::vector<Result> results;
+    results.push_back(Result("TriggerHitCache"));
+    for(size_t i = 0; i < services.size(); i++)
+      results.push_back(Result(services[i].name));
+
+    TriggerHitCache iniceCache;
+    TriggerHitCache icetopCache;
+    for(unsigned int frame = 0; frame < options.frames; frame++){
+      Result& cacheResult = results[0];
+      unsigned long allocationsBefore = allocations;
+      Clock::time_point start = Clock::now();
+      iniceCache.Fill(inice[frame], domSetTable);
+      icetopCache.Fill(icetop[frame], domSetTable);
+      cacheResult.seconds += Seconds(Clock::now() - start);
+      cacheResult.allocations += allocations - allocationsBefore;
+      cacheResult.hits += iniceHits[frame] + icetopHits[frame];
+      cacheResult.frames++;
+
+      for(size_t i = 0; i < services.size(); i++){
+        BenchmarkedService& benchmarked = services[i];
+        Result& result = results[i + 1];
+        allocationsBefore = allocations;
+        start = Clock::now();
+        benchmarked.service->FillHits(benchmarked.icetop ? icetopCache : iniceCache, benchmarked.useSLC);
+        benchmarked.service->Trigger();
+        result.seconds += Seconds(Clock::now() - start);
+        result.allocations += allocations - allocationsBefore;
+        result.hits += benchmarked.icetop ? icetopHits[frame] : iniceHits[frame];
+        result.triggers += benchmarked.service->GetNumberOfTriggers();
+        result.frames++;
+      }
+    }
+    return results;
+  }
+
+  //*****************************
+  // Chain benchmark: the trigger modules in an I3Tray
+  //*****************************
+  std::vector<Result> RunChainBenchmark(const Options& options,
+                                        std::map<std::string, I3PhysicsUsage>& usage)
+  {
+    I3Tray tray;
+    tray.AddModule("SyntheticHitSource", "source")
+      ("Seed", options.seed)
+      ("Duration", options.hits.duration)
+      ("NoiseRate", options.hits.noiseRate)
+      ("IceTopNoiseRate", options.hits.iceTopNoiseRate)
+      ("BurstRate", options.hits.burstRate)
+      ("BurstHits", options.hits.burstHits)
+      ("TrackRate", options.hits.trackRate);
+    tray.AddModule("I3TriggerSimModule", "triggersim")
+      ("NumThreads", options.threads);
+    tray.AddModule("I3GlobalTriggerSim", "globaltrigger")
+      ("RunID", 12345u);
+    tray.AddModule("I3Pruner", "pruner");
+
+    unsigned long allocationsBefore = allocations;
+    Clock::time_point start = Clock::now();
+    tray.Execute(options.frames);
+    double seconds = Seconds(Clock::now() - start);
+    unsigned long chainAllocations = allocations - allocationsBefore;
+
+    usage = tray.Usage();
+    tray.Finish();
+
+    std::vector<Result> results;
+    results.push_back(Result("SyntheticHitSource"));
+    results.back().frames = sourceStatistics.frames;
+    results.back().hits = sourceStatistics.hits;
+    results.back().seconds = sourceStatistics.seconds;
+    results.back().allocations = sourceStatistics.allocations;
+
+    // Everything but the source: the trigger modules and the tray itself
+    results.push_back(Result("TriggerChain"));
+    results.back().frames = sourceStatistics.frames;
+    results.back().hits = sourceStatistics.hits;
+    results.back().seconds = seconds - sourceStatistics.seconds;
+    results.back().allocations = chainAllocations - sourceStatistics.allocations;
+    return results;
+  }
+
+  //*****************************
+  // Output
+  //*****************************
+  void PrintResults(const char* title, const std::vector<Result>& results)
+  {
+    printf("\n%s\n", title);
+    printf("%-20s %8s %10s %10s %12s %14s %12s\n",
+           "name", "frames", "hits", "triggers", "seconds", "hits/s", "allocs/frame");
+    for(std::vector<Result>::const_iterator result = results.begin(); result != results.end(); result++){
+      printf("%-20s %8lu %10lu %10lu %12.6f %14.0f %12.1f\n",
+             result->name.c_str(), result->frames, result->hits, result->triggers, result->seconds,
+             result->seconds > 0 ? result->hits/result->seconds : 0.,
+             result->frames > 0 ? double(result->allocations)/result->frames : 0.);
+    }
+  }
+
+  void WriteResults(FILE* out, const char* key, const std::vector<Result>& results)
+  {
+    fprintf(out, "  \"%s\": [\n", key);
+    for(size_t i = 0; i < results.size(); i++){
+      const Result& result = results[i];
+      fprintf(out,
+              "    {\"name\": \"%s\", \"frames\": %lu, \"hits\": %lu, \"triggers\": %lu, "
+              "\"seconds\": %.9g, \"hits_per_second\": %.9g, \"allocations\": %lu, "
+              "\"allocations_per_frame\": %.9g}%s\n",
+              result.name.c_str(), result.frames, result.hits, result.triggers, result.seconds,
+              result.seconds > 0 ? result.hits/result.seconds : 0., result.allocations,
+              result.frames > 0 ? double(result.allocations)/result.frames : 0.,
+              i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]");
+  }
+
+  bool WriteJSON(const Options& options,
+                 const std::vector<Result>& micro,
+                 const std::vector<Result>& chain,
+                 const std::map<std::string, I3PhysicsUsage>& usage)
+  {
+    FILE* out = std::fopen(options.json.c_str(), "w");
+    if(!out)
+      return false;
+
+    fprintf(out, "{\n");
+    fprintf(out,
+            "  \"config\": {\"frames\": %u, \"seed\": %u, \"threads\": %u, \"duration_ns\": %.9g, "
+            "\"noise_rate_hz\": %.9g, \"icetop_noise_rate_hz\": %.9g, \"burst_rate_hz\": %.9g, "
+            "\"burst_hits\": %.9g, \"track_rate_hz\": %.9g},\n",
+            options.frames, options.seed, options.threads, options.hits.duration/I3Units::ns,
+            options.hits.noiseRate/I3Units::hertz, options.hits.iceTopNoiseRate/I3Units::hertz,
+            options.hits.burstRate/I3Units::hertz, options.hits.burstHits,
+            options.hits.trackRate/I3Units::hertz);
+    WriteResults(out, "micro", micro);
+    fprintf(out, ",\n");
+    WriteResults(out, "chain", chain);
+    fprintf(out, ",\n  \"modules\": [\n");
+    for(std::map<std::string, I3PhysicsUsage>::const_iterator iter = usage.begin(); iter != usage.end(); iter++){
+      fprintf(out, "    {\"name\": \"%s\", \"usertime\": %.9g, \"systime\": %.9g, \"ncall\": %u}%s\n",
+              iter->first.c_str(), iter->second.usertime, iter->second.systime, iter->second.ncall,
+              std::next(iter) != usage.end() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    return std::fclose(out) == 0;
+  }
+}
+
+/**
+ * Source of the chain benchmark: a G and a D frame with the synthetic
+ * detector and the IC86 triggers, then one Q frame of synthetic launches
+ * per call.
+ */
+class SyntheticHitSource : public I3Module
+{
+ public:
+  SyntheticHitSource(const I3Context& context);
+
+  void Configure();
+  void Process();
+
+ private:
+  unsigned int seed_;
+  SyntheticHitConfig config_;
+  I3GeometryConstPtr geometry_;
+  boost::shared_ptr<SyntheticHitGenerator> generator_;
+
+  SET_LOGGER("SyntheticHitSource");
+};
+
+I3_MODULE(SyntheticHitSource);
+
+SyntheticHitSource::SyntheticHitSource(const I3Context& context) :
+  I3Module(context),
+  seed_(1)
+{
+  AddParameter("Seed", "Seed of the random numbers", seed_);
+  AddParameter("Duration", "Length of a frame", config_.duration);
+  AddParameter("NoiseRate", "Dark noise rate of an in-ice DOM", config_.noiseRate);
+  AddParameter("IceTopNoiseRate", "Dark noise rate of an IceTop DOM", config_.iceTopNoiseRate);
+  AddParameter("BurstRate", "Rate of correlated noise bursts of an in-ice DOM", config_.burstRate);
+  AddParameter("BurstHits", "Mean number of hits of a burst", config_.burstHits);
+  AddParameter("TrackRate", "Rate of muon-like tracks", config_.trackRate);
+  AddOutBox("OutBox");
+}
+
+void SyntheticHitSource::Configure()
+{
+  GetParameter("Seed", seed_);
+  GetParameter("Duration", config_.duration);
+  GetParameter("NoiseRate", config_.noiseRate);
+  GetParameter("IceTopNoiseRate", config_.iceTopNoiseRate);
+  GetParameter("BurstRate", config_.burstRate);
+  GetParameter("BurstHits", config_.burstHits);
+  GetParameter("TrackRate", config_.trackRate);
+}
+
+void SyntheticHitSource::Process()
+{
+  unsigned long allocationsBefore = allocations;
+  Clock::time_point start = Clock::now();
+
+  if(!generator_){
+    geometry_ = SyntheticHitGenerator::MakeIC86Geometry();
+    generator_ = boost::shared_ptr<SyntheticHitGenerator>(
+      new SyntheticHitGenerator(config_, geometry_, I3RandomServicePtr(new I3GSLRandomService(seed_))));
+
+    I3FramePtr gframe(new I3Frame(I3Frame::Geometry));
+    gframe->Put("I3Geometry", geometry_);
+    PushFrame(gframe);
+
+    I3FramePtr dframe(new I3Frame(I3Frame::DetectorStatus));
+    dframe->Put("I3DetectorStatus", I3DetectorStatusConstPtr(MakeDetectorStatus()));
+    dframe->Put("DOMSets", I3MapKeyVectorIntConstPtr(DOMSetFunctions::GetDefaultDOMSets()));
+    PushFrame(dframe);
+  }
+
+  I3DOMLaunchSeriesMapPtr inice(new I3DOMLaunchSeriesMap());
+  I3DOMLaunchSeriesMapPtr icetop(new I3DOMLaunchSeriesMap());
+  generator_->Generate(*inice, *icetop);
+  for(I3DOMLaunchSeriesMap::const_iterator iter = inice->begin(); iter != inice->end(); iter++)
+    sourceStatistics.hits += iter->second.size();
+  for(I3DOMLaunchSeriesMap::const_iterator iter = icetop->begin(); iter != icetop->end(); iter++)
+    sourceStatistics.hits += iter->second.size();
+
+  I3FramePtr qframe(new I3Frame(I3Frame::DAQ));
+  qframe->Put("InIceRawData", inice);
+  qframe->Put("IceTopRawData", icetop);
+  sourceStatistics.frames++;
+  sourceStatistics.seconds += Seconds(Clock::now() - start);
+  sourceStatistics.allocations += allocations - allocationsBefore;
+
+  PushFrame(qframe);
+}
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if(!ParseOptions(argc, argv, options)){
+    Usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<Result> micro;
+  std::vector<Result> chain;
+  std::map<std::string, I3PhysicsUsage> usage;
+
+  if(options.micro){
+    micro = RunMicroBenchmarks(options);
+    PrintResults("TriggerService::FillHits + Trigger", micro);
+  }
+
+  if(options.chain){
+    chain = RunChainBenchmark(options, usage);
+    PrintResults("I3TriggerSimModule + I3GlobalTriggerSim + I3Pruner", chain);
+    printf("\n%-20s %12s %12s %8s\n", "module", "usertime", "systime", "ncall");
+    for(std::map<std::string, I3PhysicsUsage>::const_iterator iter = usage.begin(); iter != usage.end(); iter++)
+      printf("%-20s %12.6f %12.6f %8u\n", iter->first.c_str(), iter->second.usertime,
+             iter->second.systime, iter->second.ncall);
+  }
+
+  if(!options.json.empty() && !WriteJSON(options, micro, chain, usage)){
+    fprintf(stderr, "Could not write %s\n", options.json.c_str());
+    return 1;
+  }
+  return 0;
+}
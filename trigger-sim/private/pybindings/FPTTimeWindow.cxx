@@ -0,0 +1,44 @@
+#include <trigger-sim/algorithms/FPTTimeWindow.h>
+
+#include <tuple>
+#include <boost/python.hpp>
+
+namespace bp=boost::python;
+
+namespace {
+  /**
+   * The windows that pass the first and fourth FPT cut, as a list of
+   * (first, end) hit indices, end excluded like in a slice, and a list of
+   * the (start, stop) times of the same windows.  The hits have to be
+   * time ordered, like the ones of TriggerHitsFromArrays.
+   */
+  bp::tuple FPTFixedTimeWindows(FPTTimeWindow& timeWindow, TriggerHitVectorPtr hits, double separation){
+    if(!hits)
+      hits = TriggerHitVectorPtr(new TriggerHitVector());
+
+    TriggerHitIterPairVectorPtr windows;
+    std::vector<std::pair<double, double> > ranges;
+    std::tie(windows, ranges) = timeWindow.FPTFixedTimeWindows(hits, separation);
+
+    bp::list hitRanges;
+    bp::list timeRanges;
+    for(size_t i = 0; i < windows->size(); i++){
+      hitRanges.append(bp::make_tuple((*windows)[i].first - hits->begin(),
+                                      (*windows)[i].second - hits->begin()));
+      timeRanges.append(bp::make_tuple(ranges[i].first, ranges[i].second));
+    }
+    return bp::make_tuple(hitRanges, timeRanges);
+  }
+}
+
+void register_FPTTimeWindow(){
+  bp::class_<FPTTimeWindow, boost::shared_ptr<FPTTimeWindow> >
+    ("FPTTimeWindow", bp::init<unsigned int, unsigned int, double, double, double>
+     (bp::args("hitMin", "hitMax", "slcFractionMin", "timeWindow", "timeWindowSeparation")))
+    .def("FPTFixedTimeWindows", &FPTFixedTimeWindows, bp::args("hits", "separation"),
+         "The windows of the hits that pass the hit count and SLC fraction cuts, as a tuple of\n"
+         "the (first, end) hit indices and the (start, stop) times of each window.")
+    .def("GetNumberOfWindows", &FPTTimeWindow::GetNumberOfWindows)
+    .def("GetNumberPassingHitCount", &FPTTimeWindow::GetNumberPassingHitCount)
+    ;
+}
@@ -0,0 +1,153 @@
+#include <trigger-sim/algorithms/TriggerHit.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdint.h>
+#include <boost/python.hpp>
+#include <boost/python/suite/indexing/vector_indexing_suite.hpp>
+
+namespace bp=boost::python;
+
+namespace {
+
+  void RaiseError(PyObject* err, const std::string& message){
+    PyErr_SetString(err, message.c_str());
+    bp::throw_error_already_set();
+  }
+
+  /**
+   * A 1-d array of the array protocol, e.g. a numpy array, read in place.
+   * Any byte order native, bool, integer or float type will do, and the
+   * array may be strided.
+   */
+  class ArrayColumn
+  {
+   public:
+    ArrayColumn(bp::object obj, const std::string& name) : array_(obj) {
+      if(!PyObject_HasAttrString(obj.ptr(), "__array_interface__"))
+        RaiseError(PyExc_TypeError, "'" + name + "' does not support the array protocol");
+
+      bp::dict iface(bp::getattr(obj, "__array_interface__"));
+      bp::tuple shape(iface["shape"]);
+      if(bp::len(shape) != 1)
+        RaiseError(PyExc_ValueError, "'" + name + "' has to be 1-dimensional");
+      size_ = bp::extract<size_t>(shape[0]);
+
+      std::string typestr = bp::extract<std::string>(iface["typestr"]);
+      if(typestr.size() < 3 || (typestr[0] != '<' && typestr[0] != '|'))
+        RaiseError(PyExc_TypeError, "'" + name + "' has an unsupported type '" + typestr + "'");
+      kind_ = typestr[1];
+      itemsize_ = std::atoi(typestr.c_str() + 2);
+      bool supported = (kind_ == 'b' && itemsize_ == 1) ||
+        ((kind_ == 'i' || kind_ == 'u') &&
+         (itemsize_ == 1 || itemsize_ == 2 || itemsize_ == 4 || itemsize_ == 8)) ||
+        (kind_ == 'f' && (itemsize_ == 4 || itemsize_ == 8));
+      if(!supported)
+        RaiseError(PyExc_TypeError, "'" + name + "' has an unsupported type '" + typestr + "'");
+
+      stride_ = itemsize_;
+      if(iface.has_key("strides") && iface["strides"])
+        stride_ = bp::extract<ptrdiff_t>(bp::tuple(iface["strides"])[0]);
+      data_ = reinterpret_cast<const char*>(
+        static_cast<uintptr_t>(bp::extract<uintptr_t>(bp::tuple(iface["data"])[0])));
+    }
+
+    size_t size() const { return size_; }
+
+    double operator[](size_t i) const {
+      const char* item = data_ + static_cast<ptrdiff_t>(i)*stride_;
+      switch(kind_){
+        case 'b': return Read<uint8_t>(item) != 0;
+        case 'i':
+          switch(itemsize_){
+            case 1: return Read<int8_t>(item);
+            case 2: return Read<int16_t>(item);
+            case 4: return Read<int32_t>(item);
+            default: return Read<int64_t>(item);
+          }
+        case 'u':
+          switch(itemsize_){
+            case 1: return Read<uint8_t>(item);
+            case 2: return Read<uint16_t>(item);
+            case 4: return Read<uint32_t>(item);
+            default: return Read<uint64_t>(item);
+          }
+        default:
+          return itemsize_ == 4 ? Read<float>(item) : Read<double>(item);
+      }
+    }
+
+   private:
+    template <typename T>
+    static double Read(const char* item){
+      // the data does not have to be aligned
+      T value;
+      std::memcpy(&value, item, sizeof(T));
+      return static_cast<double>(value);
+    }
+
+    // keeps the array alive while its data is read
+    bp::object array_;
+    size_t size_;
+    char kind_;
+    int itemsize_;
+    ptrdiff_t stride_;
+    const char* data_;
+  };
+
+  // The hits of numpy arrays (or anything else with the array protocol)
+  // of the same length, sorted by time
+  TriggerHitVectorPtr TriggerHitsFromArrays(bp::object time, bp::object string,
+                                            bp::object om, bp::object lc){
+    ArrayColumn times(time, "time");
+    ArrayColumn strings(string, "string");
+    ArrayColumn oms(om, "om");
+    ArrayColumn lcs(lc, "lc");
+    if(strings.size() != times.size() || oms.size() != times.size() || lcs.size() != times.size()){
+      std::ostringstream message;
+      message << "The arrays have different lengths: time " << times.size()
+              << ", string " << strings.size() << ", om " << oms.size()
+              << ", lc " << lcs.size();
+      RaiseError(PyExc_ValueError, message.str());
+    }
+
+    TriggerHitVectorPtr hits(new TriggerHitVector());
+    hits->reserve(times.size());
+    for(size_t i = 0; i < times.size(); i++)
+      hits->push_back(TriggerHit(times[i], static_cast<unsigned int>(oms[i]),
+                                 static_cast<int>(strings[i]), lcs[i] != 0));
+    std::stable_sort(hits->begin(), hits->end());
+    return hits;
+  }
+
+  std::string TriggerHitRepr(const TriggerHit& hit){
+    std::ostringstream repr;
+    repr << "TriggerHit(time=" << hit.time << ", string=" << hit.string
+         << ", om=" << hit.pos << ", lc=" << (hit.lc ? "True" : "False") << ")";
+    return repr.str();
+  }
+}
+
+void register_TriggerHit(){
+  bp::class_<TriggerHit, boost::shared_ptr<TriggerHit> >("TriggerHit")
+    .def(bp::init<double, unsigned int, int, bool>(bp::args("time", "om", "string", "lc")))
+    .def_readwrite("time", &TriggerHit::time)
+    .def_readwrite("om", &TriggerHit::pos)
+    .def_readwrite("string", &TriggerHit::string)
+    .def_readwrite("lc", &TriggerHit::lc)
+    .def("__eq__", &TriggerHit::operator==)
+    .def("__repr__", &TriggerHitRepr)
+    ;
+
+  bp::class_<TriggerHitVector, TriggerHitVectorPtr>("TriggerHitVector")
+    .def(bp::vector_indexing_suite<TriggerHitVector>())
+    ;
+
+  bp::def("TriggerHitsFromArrays", &TriggerHitsFromArrays,
+          bp::args("time", "string", "om", "lc"),
+          "Hits of the same length arrays (e.g. numpy arrays) of the launch times, strings, OMs\n"
+          "and LC bits, sorted by time.  Hits like these can be given to TriggerService.FillHits\n"
+          "and FPTTimeWindow.FPTFixedTimeWindows without going through an I3DOMLaunchSeriesMap.");
+}
@@ -2,20 +2,110 @@
 #include <trigger-sim/algorithms/ClusterTriggerAlgorithm.h>
 #include <trigger-sim/algorithms/CylinderTriggerAlgorithm.h>
 #include <trigger-sim/algorithms/SimpleMajorityTriggerAlgorithm.h>
+#include <trigger-sim/algorithms/FaintParticleTriggerAlgorithm.h>
+#include <trigger-sim/algorithms/SlowMonopoleTriggerAlgorithm.h>
 
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include <boost/python/suite/indexing/map_indexing_suite.hpp>
 
+// The FaintParticleTrigger constructor needs one more argument than the
+// default, CMakeLists.txt raises the limit for all files of the bindings
+#if BOOST_PYTHON_MAX_ARITY < 16
+#error "The trigger_sim bindings need BOOST_PYTHON_MAX_ARITY=16"
+#endif
+
 namespace bp=boost::python;
+
+// FillHits is overloaded, bind the version that takes the maps
+typedef void (TriggerService::*FillHitsFromMaps)(I3DOMLaunchSeriesMapConstPtr,
+                                                 I3RecoPulseSeriesMapConstPtr,
+                                                 bool);
+
+namespace {
+  // and the one that takes hits, e.g. from TriggerHitsFromArrays
+  void FillHitsFromVector(TriggerService& service, const TriggerHitVector& hits, bool useSLC){
+    service.FillHits(hits.data(), hits.size(), useSLC);
+  }
+
+  template <typename T>
+  bp::list ToList(const std::vector<T>& values){
+    bp::list list;
+    for(const T& value : values)
+      list.append(value);
+    return list;
+  }
+
+  bp::list GetCutPassCounts(const TriggerService& service){
+    return ToList(service.GetCutPassCounts());
+  }
+
+  bp::list GetCutTimes(const TriggerService& service){
+    return ToList(service.GetCutTimes());
+  }
+
+  bp::list GetCutNames(const TriggerService& service){
+    bp::list names;
+    for(size_t cut = 0; cut < service.GetCutPassCounts().size(); cut++)
+      names.append(service.GetCutName(cut));
+    return names;
+  }
+
+  boost::shared_ptr<FaintParticleTriggerAlgorithm>
+  MakeFaintParticleTrigger(double time_window, double time_window_separation, double max_trigger_length,
+                           unsigned int hit_min, unsigned int hit_max,
+                           double double_velocity_min, double double_velocity_max, unsigned int double_min,
+                           unsigned int azimuth_histogram_min, unsigned int zenith_histogram_min,
+                           double histogram_binning, double slcfraction_min,
+                           I3GeometryConstPtr geometry, int domSet,
+                           I3MapKeyVectorIntConstPtr customDomSets){
+    return boost::shared_ptr<FaintParticleTriggerAlgorithm>
+      (new FaintParticleTriggerAlgorithm(time_window, time_window_separation, max_trigger_length,
+                                         hit_min, hit_max, double_velocity_min, double_velocity_max,
+                                         double_min, azimuth_histogram_min, zenith_histogram_min,
+                                         histogram_binning, slcfraction_min,
+                                         geometry, domSet, customDomSets));
+  }
+
+  // The optional settings of SLOP are None if not set
+  template <typename T>
+  boost::optional<T> ToOptional(const bp::object& value){
+    if(value.is_none())
+      return boost::optional<T>();
+    return boost::optional<T>(bp::extract<T>(value)());
+  }
+
+  boost::shared_ptr<SlowMonopoleTriggerAlgorithm>
+  MakeSlowMonopoleTrigger(double t_proximity, double t_min, double t_max,
+                          bp::object deltad, bp::object alpha_min, bp::object dc_algo,
+                          double relv, int min_tuples, double max_event_length,
+                          I3GeometryConstPtr geometry, int domSet,
+                          I3MapKeyVectorIntConstPtr customDomSets){
+    return boost::shared_ptr<SlowMonopoleTriggerAlgorithm>
+      (new SlowMonopoleTriggerAlgorithm(t_proximity, t_min, t_max,
+                                        ToOptional<double>(deltad),
+                                        ToOptional<double>(alpha_min),
+                                        ToOptional<bool>(dc_algo),
+                                        relv, min_tuples, max_event_length,
+                                        geometry, domSet, customDomSets));
+  }
+}
+
 void register_TriggerService(){
   bp::class_<TriggerService, boost::shared_ptr<TriggerService>, boost::noncopyable>("TriggerService", bp::no_init)
-    .def("FillHits", &TriggerService::FillHits, bp::args("launches", "pulses"), bp::arg("useSLC")=false)
+    .def("FillHits", (FillHitsFromMaps)&TriggerService::FillHits, bp::args("launches", "pulses"), bp::arg("useSLC")=false)
+    .def("FillHits", &FillHitsFromVector, (bp::arg("hits"), bp::arg("useSLC")=false))
     .def("Trigger", &TriggerService::Trigger)
     .def("GetNumberOfTriggers", &TriggerService::GetNumberOfTriggers)
     .def("GetNextTrigger", &TriggerService::GetNextTrigger)
+    .def("GetNumberOfHits", &TriggerService::GetNumberOfHits)
+    .def("GetNumberOfWindows", &TriggerService::GetNumberOfWindows)
+    .def("GetCutNames", &GetCutNames)
+    .def("GetCutPassCounts", &GetCutPassCounts)
+    .def("GetCutTimes", &GetCutTimes)
+    .def("SetCutTiming", &TriggerService::SetCutTiming)
     ;
-    
+
   // ClusterTrigger
   bp::class_<ClusterTriggerAlgorithm, boost::shared_ptr<ClusterTriggerAlgorithm>, bp::bases<TriggerService>, boost::noncopyable >
     ("ClusterTrigger", bp::init<double, unsigned int, unsigned int, unsigned int, I3MapKeyVectorIntConstPtr>
@@ -23,7 +113,7 @@ void register_TriggerService(){
 
   // CylinderTrigger
   bp::class_<CylinderTriggerAlgorithm, boost::shared_ptr<CylinderTriggerAlgorithm>, bp::bases<TriggerService>, boost::noncopyable >
-    ("CylinderTrigger", bp::init<double, unsigned int, unsigned int, I3GeometryConstPtr, 
+    ("CylinderTrigger", bp::init<double, unsigned int, unsigned int, I3GeometryConstPtr,
                                  double, double, unsigned int, I3MapKeyVectorIntConstPtr>
      (bp::args("triggerWindow", "triggerThreshold", "simpleMultiplicity", "geometry", "radius", "height", "domSet", "customDomSets")));
 
@@ -31,4 +121,31 @@ void register_TriggerService(){
   bp::class_<SimpleMajorityTriggerAlgorithm, boost::shared_ptr<SimpleMajorityTriggerAlgorithm>, bp::bases<TriggerService>, boost::noncopyable >
     ("SimpleMajorityTrigger", bp::init<double, unsigned int, unsigned int, I3MapKeyVectorIntConstPtr>
      (bp::args("triggerWindow", "triggerThreshold", "domSet", "customDomSets")));
+
+  // FPT, it takes the SLC hits too, so fill it with useSLC=True
+  bp::class_<FaintParticleTriggerAlgorithm, boost::shared_ptr<FaintParticleTriggerAlgorithm>, bp::bases<TriggerService>, boost::noncopyable >
+    ("FaintParticleTrigger", bp::no_init)
+    .def("__init__", bp::make_constructor(&MakeFaintParticleTrigger, bp::default_call_policies(),
+                                          bp::args("timeWindow", "timeWindowSeparation", "maxTriggerLength", "hitMin", "hitMax",
+                                                   "doubleVelocityMin", "doubleVelocityMax", "doubleMin",
+                                                   "azimuthHistogramMin", "zenithHistogramMin", "histogramBinning", "slcFractionMin",
+                                                   "geometry", "domSet", "customDomSets")))
+    .def("SetEvaluationMode", &FaintParticleTriggerAlgorithm::SetEvaluationMode)
+    .def("GetEvaluationMode", &FaintParticleTriggerAlgorithm::GetEvaluationMode)
+    ;
+
+  bp::enum_<FaintParticleTriggerAlgorithm::EvaluationMode>("FPTEvaluationMode")
+    .value("FULL_EVALUATION", FaintParticleTriggerAlgorithm::FULL_EVALUATION)
+    .value("ROLLING_PAIR_CACHE", FaintParticleTriggerAlgorithm::ROLLING_PAIR_CACHE)
+    .value("EARLY_EXIT", FaintParticleTriggerAlgorithm::EARLY_EXIT)
+    ;
+
+  // SLOP, None for the settings the trigger configuration doesn't have
+  bp::class_<SlowMonopoleTriggerAlgorithm, boost::shared_ptr<SlowMonopoleTriggerAlgorithm>, bp::bases<TriggerService>, boost::noncopyable >
+    ("SlowMonopoleTrigger", bp::no_init)
+    .def("__init__", bp::make_constructor(&MakeSlowMonopoleTrigger, bp::default_call_policies(),
+                                          bp::args("tProximity", "tMin", "tMax", "deltaD", "alphaMin", "dcAlgo",
+                                                   "relv", "minTuples", "maxEventLength",
+                                                   "geometry", "domSet", "customDomSets")))
+    ;
 }
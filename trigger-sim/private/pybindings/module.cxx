@@ -40,7 +40,7 @@ namespace bp = boost::python;
 #include <trigger-sim/utilities/DOMSetFunctions.h>
 #include <trigger-sim/utilities/TimeShifterUtils.h>
 #define REGISTER_THESE_THINGS						\
-  (GlobalTriggerSim)(TriggerService)
+  (GlobalTriggerSim)(TriggerHit)(TriggerService)(FPTTimeWindow)
 
 #define I3_REGISTRATION_FN_DECL(r, data, t) void BOOST_PP_CAT(register_,t)();
 #define I3_REGISTER(r, data, t) BOOST_PP_CAT(register_,t)();
@@ -52,7 +52,8 @@ I3_PYTHON_MODULE(trigger_sim)
 
   BOOST_PP_SEQ_FOR_EACH(I3_REGISTER, ~, REGISTER_THESE_THINGS);
 
-  def("InDOMSet", &DOMSetFunctions::InDOMSet);
+  def("InDOMSet", (bool (*)(const OMKey&, const unsigned&, const I3MapKeyVectorIntConstPtr&))
+      &DOMSetFunctions::InDOMSet);
 
   def("GetDefaultDOMSets", &DOMSetFunctions::GetDefaultDOMSets);
 
@@ -61,6 +61,38 @@ void TestPruningHits() {
 
 }
 
+void TestPrunedHits() {
+
+  // Only string 1 has sites over threshold, and the
+  // hits on strings 2 and 3 are pruned from the trigger
+  ClusterTriggerAlgorithm stringTrigger(1500, 3, 7, 2, I3MapKeyVectorIntConstPtr());
+  I3DOMLaunchSeriesMapPtr hits(new I3DOMLaunchSeriesMap());
+
+  AddLaunch(hits,1,1,1);
+  AddLaunch(hits,2,2,2);
+  AddLaunch(hits,3,3,2);
+  AddLaunch(hits,4,1,1);
+  AddLaunch(hits,5,2,1);
+  AddLaunch(hits,6,3,1);
+  AddLaunch(hits,7,4,3);
+  // outside of the coherence sites, but in the window
+  AddLaunch(hits,8,64,1);
+
+  stringTrigger.FillHits(I3DOMLaunchSeriesMapConstPtr(hits),
+                         I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()),false);
+  stringTrigger.Trigger();
+  ENSURE(stringTrigger.GetNumberOfTriggers() == 1);
+
+  TriggerHitVectorPtr triggerHits = stringTrigger.GetNextTrigger();
+  ENSURE(triggerHits->size() == 4);
+  double times[] = {1, 4, 5, 6};
+  for (unsigned int i = 0; i < triggerHits->size(); i++) {
+    ENSURE((*triggerHits)[i].string == 1);
+    ENSURE((*triggerHits)[i].time == times[i]);
+  }
+
+}
+
 void TestNoTrigger() {
 
   ClusterTriggerAlgorithm stringTrigger(1500, 3, 7, 2, I3MapKeyVectorIntConstPtr());
@@ -81,24 +113,6 @@ void TestNoTrigger() {
 
 }
 
-void TestHashing() {
-
-  ClusterTriggerAlgorithm stringTrigger(1500, 3, 7, 2, I3MapKeyVectorIntConstPtr());
-
-  for (int s = 1; s < 100; s++) {
-    for (unsigned int p = 1; p <= 60; p++) {
-      int hash = stringTrigger.GetHash(s, p);
-
-      int string = stringTrigger.GetString(hash);
-      unsigned int position = stringTrigger.GetPosition(hash);
-
-      ENSURE( string == s );
-      ENSURE( position == p );
-    }
-  }
-}
-
-
 void TriggerTest() {
 
   ClusterTriggerAlgorithm stringTrigger(2500, 5, 7, 2, I3MapKeyVectorIntConstPtr());
@@ -128,15 +142,14 @@ TEST(test_pruning_hits) {
   TestPruningHits();
 }
 
-TEST(test_no_trigger) {
-  TestNoTrigger();
+TEST(test_pruned_hits) {
+  TestPrunedHits();
 }
 
-TEST(test_hashing) {
-  TestHashing();
+TEST(test_no_trigger) {
+  TestNoTrigger();
 }
 
-
 TEST(at_threshold){
   for( int i(0); i < 10000; i++)
     TriggerTest();
@@ -0,0 +1,88 @@
+#include <I3Test.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "trigger-sim/algorithms/CylinderHitQueue.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+#include <dataclasses/geometry/I3Geometry.h>
+#include <phys-services/I3GSLRandomService.h>
+#include "TestGeometry.h"
+
+TEST_GROUP(CylinderHitQueueTests);
+
+namespace CylinderHitQueueTests{
+  // Brute force search over all hit pairs, like the old PosWindow
+  bool Reference(std::deque<TriggerHit>& queue, const DOMPositionTable& positions,
+                 double radius, double height, unsigned threshold){
+    for(size_t i = 0; i < queue.size(); i++){
+      const double* pos1 = positions.GetPosition(positions.GetIndex(queue[i].string, queue[i].pos));
+      TriggerHitVector volume(1, queue[i]);
+      for(size_t j = 0; j < queue.size(); j++){
+        if(j == i) continue;
+        const double* pos2 = positions.GetPosition(positions.GetIndex(queue[j].string, queue[j].pos));
+        double dx = pos2[0] - pos1[0];
+        double dy = pos2[1] - pos1[1];
+        if(sqrt(dx*dx + dy*dy) < radius && fabs(pos2[2] - pos1[2]) < 0.5*height)
+          volume.push_back(queue[j]);
+      }
+      if(volume.size() >= threshold){
+        std::stable_sort(volume.begin(), volume.end());
+        queue.assign(volume.begin(), volume.end());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // hits compare on time and DOM
+  bool SameHits(const CylinderHitQueue& queue, const std::deque<TriggerHit>& reference){
+    TriggerHitVector hits;
+    queue.CopyHits(hits);
+    return hits.size() == reference.size() && std::equal(hits.begin(), hits.end(), reference.begin());
+  }
+}
+
+TEST(SameVolumesAsAllPairs){
+  I3GeometryPtr geo = TestGeometry::MakeGeometry(20, 30, 5, 0);
+  DOMPositionTable positions(*geo);
+  I3GSLRandomService rand(1618);
+
+  double radii[] = {0., 50., 125., 175., 400., 1e6};
+  for(int trial = 0; trial < 60; trial++){
+    double radius = radii[trial % 6];
+    double height = rand.Uniform(10, 600);
+    unsigned threshold = 1 + rand.Integer(8);
+
+    CylinderHitQueue queue(radius, height);
+    queue.Reset(positions);
+    std::deque<TriggerHit> reference;
+
+    // Random pushes and pops, so that the ring buffer wraps and grows
+    for(int step = 0; step < 400; step++){
+      if(rand.Uniform(0, 1) < 0.6 || reference.empty()){
+        TriggerHit hit;
+        hit.string = 1 + rand.Integer(20);
+        hit.pos = 1 + rand.Integer(30);
+        hit.time = floor(rand.Uniform(0, 100));
+        queue.PushBack(hit);
+        reference.push_back(hit);
+      }else{
+        queue.PopFront();
+        reference.pop_front();
+      }
+      ENSURE(queue.Size() == reference.size());
+      ENSURE(reference.empty() || queue.Front() == reference.front());
+
+      if(step % 25 == 0){
+        bool found = queue.FindVolume(threshold);
+        ENSURE(found == CylinderHitQueueTests::Reference(reference, positions, radius, height, threshold),
+               "FindVolume disagrees with the pair search");
+        ENSURE(CylinderHitQueueTests::SameHits(queue, reference), "Different hits in the volume");
+      }
+    }
+    queue.Clear();
+    ENSURE(queue.Empty());
+  }
+}
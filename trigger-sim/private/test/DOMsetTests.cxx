@@ -410,3 +410,39 @@ TEST(DOMSet11Test)   // This is the InIce (IC86) detector, including all strings
      ENSURE(!DOMSetFunctions::InDOMSet(test_om,11,I3MapKeyVectorIntConstPtr()));
    }
  }
+
+TEST(DOMSetTableMatchesMap)
+{
+  I3MapKeyVectorIntPtr domSets = DOMSetFunctions::GetDefaultDOMSets();
+
+  // Upgrade and Gen2 like sets with large IDs, enough of
+  // them that some don't get a bit in the mask
+  for(int str = 87; str <= 93; str++)
+    for(unsigned om = 1; om <= 100; om++)
+      (*domSets)[OMKey(str, om)].push_back(1000 + om % 40);
+  (*domSets)[OMKey(1000, 1)].push_back(1002);
+  (*domSets)[OMKey(1, 1)].push_back(-1);
+  // a PMT key, which the table leaves to the map
+  (*domSets)[OMKey(5, 5, 1)].push_back(7);
+
+  DOMSetTable table(domSets);
+  ENSURE(!table.HasAllDOMSets());
+
+  std::vector<unsigned> sets;
+  for(unsigned domSet = 0; domSet <= 12; domSet++) sets.push_back(domSet);
+  for(unsigned domSet = 1000; domSet <= 1042; domSet++) sets.push_back(domSet);
+
+  std::vector<OMKey> doms;
+  for(int str = 0; str <= 100; str++)
+    for(unsigned om = 0; om <= 101; om++)
+      doms.push_back(OMKey(str, om));
+  doms.push_back(OMKey(1000, 1));
+  doms.push_back(OMKey(5, 5, 1));
+  doms.push_back(OMKey(-3, 1));
+
+  BOOST_FOREACH(const OMKey& dom, doms)
+    BOOST_FOREACH(unsigned domSet, sets)
+      ENSURE(DOMSetFunctions::InDOMSet(dom, domSet, table) ==
+             DOMSetFunctions::InDOMSet(dom, domSet, I3MapKeyVectorIntConstPtr(domSets)),
+             "DOMSetTable and DOMSets map disagree");
+}
@@ -0,0 +1,122 @@
+#include <I3Test.h>
+
+#include <cmath>
+#include <vector>
+#include "trigger-sim/algorithms/FPTDoubleKernel.h"
+#include <phys-services/I3GSLRandomService.h>
+
+TEST_GROUP(FPTDoubleKernelTests);
+
+namespace FPTDoubleKernelTests{
+  // The pair loop as it was written in FaintParticleTriggerAlgorithm::DoubleThreshold
+  std::vector<int> ReferenceDoubles(const FPTHitArrays& hits, double vmin, double vmax){
+    std::vector<int> doubles;
+    for(size_t i = 0; i < hits.Size(); i++){
+      for(size_t j = i + 1; j < hits.Size(); j++){
+        if(hits.string[i] == hits.string[j] && hits.om[i] == hits.om[j]) continue;
+        double distance = sqrt(pow(hits.x[j] - hits.x[i], 2) + pow(hits.y[j] - hits.y[i], 2) + pow(hits.z[j] - hits.z[i], 2));
+        double time = fabs(hits.t[j] - hits.t[i]);
+        double velocity = 1e6*distance/time;
+        if(velocity > vmin && velocity < vmax){
+          doubles.push_back(i);
+          doubles.push_back(j);
+        }
+      }
+    }
+    return doubles;
+  }
+
+  void Compare(const FPTHitArrays& hits, double vmin, double vmax){
+    FPTDoubleKernel kernel(vmin, vmax);
+    std::vector<int> reference = ReferenceDoubles(hits, vmin, vmax);
+    std::vector<int> dispatched;
+    std::vector<int> scalar;
+    kernel.FindDoubles(hits, dispatched);
+    kernel.FindDoublesScalar(hits, scalar);
+    ENSURE(dispatched == reference, "Dispatched kernel differs from the reference pair loop");
+    ENSURE(scalar == reference, "Scalar kernel differs from the reference pair loop");
+  }
+}
+
+TEST(RandomWindows){
+  I3GSLRandomService rand(31415);
+  const double vmins[] = {0., 1e5, 5e5, -1.};
+  const double vmaxs[] = {1e6, 3e6, INFINITY};
+
+  for(int trial = 0; trial < 200; trial++){
+    FPTHitArrays hits;
+    int nhits = rand.Integer(60);
+    for(int i = 0; i < nhits; i++){
+      int string = 1 + rand.Integer(10);
+      unsigned om = 1 + rand.Integer(10);
+      // integer times, so that some pairs have dt == 0
+      hits.PushBack(125.*(string % 4), 125.*(string / 4), -17.*om,
+                    floor(rand.Uniform(0, 2000)), string, om);
+    }
+    for(double vmin : vmins)
+      for(double vmax : vmaxs)
+        FPTDoubleKernelTests::Compare(hits, vmin, vmax);
+  }
+}
+
+TEST(VelocityOnTheBoundary){
+  // 125 m in 125 ns is exactly 1e6 km/s, which must fail both strict cuts
+  FPTHitArrays hits;
+  for(int i = 0; i < 9; i++)
+    hits.PushBack(125.*i, 0., 0., 125.*i, i + 1, 1);
+
+  FPTDoubleKernelTests::Compare(hits, 1e6, 2e6);
+  FPTDoubleKernelTests::Compare(hits, 0., 1e6);
+  FPTDoubleKernelTests::Compare(hits, nextafter(1e6, 0.), nextafter(1e6, 2e6));
+
+  FPTDoubleKernel kernel(0., 2e6);
+  std::vector<int> doubles;
+  kernel.FindDoubles(hits, doubles);
+  ENSURE(doubles.size() == 2*36, "Every pair is a Double");
+}
+
+TEST(SameDOMAndSameTime){
+  FPTHitArrays hits;
+  // same DOM twice, then two DOMs at the same time
+  for(int i = 0; i < 6; i++){
+    hits.PushBack(0., 0., 0., 100.*i, 1, 1);
+    hits.PushBack(50., 0., 0., 100.*i, 2, 1);
+  }
+  FPTDoubleKernelTests::Compare(hits, 0., 1e6);
+  FPTDoubleKernelTests::Compare(hits, 0., INFINITY);
+  FPTDoubleKernelTests::Compare(hits, -1., INFINITY);
+  FPTDoubleKernelTests::Compare(hits, 1e6, 1e5);
+}
+
+TEST(FixedBoundsMatchRuntimeBounds){
+  I3GSLRandomService rand(27182);
+  FPTDoubleKernel runtime(1e5, 3e6);
+  FPTFixedDoubleKernel<100000, 3000000> fixed;
+
+  for(int trial = 0; trial < 200; trial++){
+    FPTHitArrays hits;
+    int nhits = rand.Integer(60);
+    for(int i = 0; i < nhits; i++){
+      int string = 1 + rand.Integer(10);
+      unsigned om = 1 + rand.Integer(10);
+      hits.PushBack(125.*(string % 4), 125.*(string / 4), -17.*om,
+                    floor(rand.Uniform(0, 2000)), string, om);
+    }
+    // and a pair exactly on each bound
+    hits.PushBack(0., 0., 0., 3000., 11, 1);
+    hits.PushBack(100., 0., 0., 4000., 12, 1);
+    hits.PushBack(300., 0., 0., 3100., 13, 1);
+
+    std::vector<int> expected, doubles;
+    runtime.FindDoubles(hits, expected);
+    fixed.FindDoubles(hits, doubles);
+    ENSURE(doubles == expected, "Fixed bounds found other Doubles");
+
+    for(int anchor = 0; anchor < (int)hits.Size(); anchor++){
+      std::vector<int> expected_partners, partners;
+      runtime.FindPartners(hits, anchor, anchor + 1, hits.Size(), expected_partners);
+      fixed.FindPartners(hits, anchor, anchor + 1, hits.Size(), partners);
+      ENSURE(partners == expected_partners, "Fixed bounds found other partners");
+    }
+  }
+}
@@ -0,0 +1,160 @@
+#include <I3Test.h>
+
+#include <algorithm>
+#include <vector>
+#include "trigger-sim/algorithms/FPTPairCache.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+#include <dataclasses/I3Direction.h>
+#include <dataclasses/geometry/I3Geometry.h>
+#include <icetray/I3Units.h>
+#include <phys-services/I3GSLRandomService.h>
+#include "TestGeometry.h"
+
+TEST_GROUP(FPTPairCacheTests);
+
+namespace FPTPairCacheTests{
+  // Brute force Double count and max bins of the hits [first, last)
+  void Reference(const TriggerHitVector& hits, int first, int last,
+                 const DOMPositionTable& positions, const FPTDoubleKernel& kernel, int bin_size,
+                 unsigned& ndoubles, unsigned& nazimuth, unsigned& nzenith){
+    FPTAngleBinning zenith_binning(0, 180, bin_size);
+    FPTAngleBinning azimuth_binning(0, 360, bin_size);
+    std::vector<unsigned> zenith(zenith_binning.GetNumberOfBins(), 0);
+    std::vector<unsigned> azimuth(azimuth_binning.GetNumberOfBins(), 0);
+    ndoubles = 0;
+    for(int i = first; i < last; i++){
+      const double* pos1 = positions.GetPosition(positions.GetIndex(hits[i].string, hits[i].pos));
+      for(int j = i + 1; j < last; j++){
+        if(hits[i].string == hits[j].string && hits[i].pos == hits[j].pos) continue;
+        const double* pos2 = positions.GetPosition(positions.GetIndex(hits[j].string, hits[j].pos));
+        if(!kernel.IsDouble(pos2[0] - pos1[0], pos2[1] - pos1[1], pos2[2] - pos1[2], hits[j].time - hits[i].time))
+          continue;
+        ndoubles++;
+        I3Direction dir(pos2[0] - pos1[0], pos2[1] - pos1[1], pos2[2] - pos1[2]);
+        int zbin = zenith_binning.Bin(dir.GetZenith()/I3Units::degree);
+        int abin = azimuth_binning.Bin(dir.GetAzimuth()/I3Units::degree);
+        if(zbin >= 0) zenith[zbin]++;
+        if(abin >= 0) azimuth[abin]++;
+      }
+    }
+    nzenith = *std::max_element(zenith.begin(), zenith.end());
+    nazimuth = *std::max_element(azimuth.begin(), azimuth.end());
+  }
+}
+
+TEST(BinningMatchesCalcHistogram){
+  // 0-180 in steps of 20: the last bin [160, 181) is closed on the right
+  FPTAngleBinning closed(0, 180, 20);
+  ENSURE(closed.GetNumberOfBins() == 9);
+  ENSURE(closed.Bin(0.) == 0);
+  ENSURE(closed.Bin(19.999999) == 0);
+  ENSURE(closed.Bin(20.) == 1);
+  ENSURE(closed.Bin(180.) == 8);
+  ENSURE(closed.Bin(180.999) == 8);
+  ENSURE(closed.Bin(181.) == -1);
+  ENSURE(closed.Bin(-0.001) == -1);
+  ENSURE(closed.Bin(NAN) == -1);
+
+  // 0-180 in steps of 7: the last bin is [175, 182)
+  FPTAngleBinning open(0, 180, 7);
+  ENSURE(open.GetNumberOfBins() == 26);
+  ENSURE(open.Bin(181.5) == 25);
+  ENSURE(open.Bin(182.) == -1);
+}
+
+TEST(FixedBinningMatchesRuntimeBinning){
+  FPTFixedAngleBinning<0, 180, 10> zenith10;
+  FPTFixedAngleBinning<0, 360, 10> azimuth10;
+  FPTFixedAngleBinning<0, 180, 7> zenith7;
+  FPTFixedAngleBinning<0, 360, 1> azimuth1;
+  FPTAngleBinning runtime_zenith10(0, 180, 10);
+  FPTAngleBinning runtime_azimuth10(0, 360, 10);
+  FPTAngleBinning runtime_zenith7(0, 180, 7);
+  FPTAngleBinning runtime_azimuth1(0, 360, 1);
+  ENSURE(zenith10.GetNumberOfBins() == runtime_zenith10.GetNumberOfBins());
+  ENSURE(zenith7.GetNumberOfBins() == runtime_zenith7.GetNumberOfBins());
+
+  // every bin edge and its neighbours, then random angles
+  std::vector<double> angles;
+  for(int edge = -1; edge <= 362; edge++){
+    angles.push_back(edge);
+    angles.push_back(nextafter(double(edge), -INFINITY));
+    angles.push_back(nextafter(double(edge), INFINITY));
+  }
+  angles.push_back(NAN);
+  angles.push_back(INFINITY);
+  I3GSLRandomService rand(1618);
+  for(int i = 0; i < 100000; i++)
+    angles.push_back(rand.Uniform(-1, 362));
+
+  for(double angle : angles){
+    ENSURE(zenith10.Bin(angle) == runtime_zenith10.Bin(angle));
+    ENSURE(azimuth10.Bin(angle) == runtime_azimuth10.Bin(angle));
+    ENSURE(zenith7.Bin(angle) == runtime_zenith7.Bin(angle));
+    ENSURE(azimuth1.Bin(angle) == runtime_azimuth1.Bin(angle));
+  }
+
+  FPTFixedAngleHistogram<0, 180, 7> fixed_histogram;
+  FPTAngleHistogram histogram(runtime_zenith7);
+  for(double angle : angles)
+    ENSURE(fixed_histogram.Fill(angle) == histogram.Fill(angle));
+  ENSURE(fixed_histogram.GetMaxCount() == histogram.GetMaxCount());
+}
+
+TEST(DirectionMatchesI3Direction){
+  I3GSLRandomService rand(1414);
+  for(int trial = 0; trial < 10000; trial++){
+    // include the axis aligned and degenerate directions
+    double dx = trial % 7 == 0 ? 0. : floor(rand.Uniform(-500, 500));
+    double dy = trial % 5 == 0 ? 0. : floor(rand.Uniform(-500, 500));
+    double dz = trial % 3 == 0 ? 0. : floor(rand.Uniform(-500, 500))*17.;
+    I3Direction dir(dx, dy, dz);
+    double zenith, azimuth;
+    FPTPairDirection(dx, dy, dz, zenith, azimuth);
+    ENSURE(zenith == dir.GetZenith()/I3Units::degree);
+    ENSURE(azimuth == dir.GetAzimuth()/I3Units::degree);
+  }
+}
+
+TEST(RollingWindows){
+  I3GeometryPtr geo = TestGeometry::MakeGeometry(10, 20, 4, 0);
+  DOMPositionTable positions(*geo);
+  I3GSLRandomService rand(2718);
+
+  for(int trial = 0; trial < 50; trial++){
+    TriggerHitVector hits;
+    int nhits = 20 + rand.Integer(100);
+    for(int i = 0; i < nhits; i++){
+      TriggerHit hit;
+      hit.string = 1 + rand.Integer(10);
+      hit.pos = 1 + rand.Integer(20);
+      hit.time = floor(rand.Uniform(0, 20000));
+      hit.lc = false;
+      hits.push_back(hit);
+    }
+    std::sort(hits.begin(), hits.end());
+
+    int bin_size = 1 + rand.Integer(40);
+    FPTDoubleKernel kernel(0., 2e6);
+    FPTPairCache cache(kernel, bin_size);
+    cache.Reset(hits, positions);
+
+    // windows of 2000 ns every 500 ns, like FPTTimeWindow
+    for(double start = 0; start < 20000; start += 500){
+      int first = std::lower_bound(hits.begin(), hits.end(), start,
+                                   [](const TriggerHit& h, double t){ return h.time < t; }) - hits.begin();
+      int last = std::lower_bound(hits.begin(), hits.end(), start + 2000,
+                                  [](const TriggerHit& h, double t){ return h.time < t; }) - hits.begin();
+      if(first == last) continue;
+      cache.Advance(first, last);
+
+      unsigned ndoubles, nazimuth, nzenith;
+      FPTPairCacheTests::Reference(hits, first, last, positions, kernel, bin_size,
+                                   ndoubles, nazimuth, nzenith);
+      ENSURE(cache.GetNumberOfDoubles() == ndoubles);
+      ENSURE(cache.GetMaxAzimuthCount() == nazimuth);
+      ENSURE(cache.GetMaxZenithCount() == nzenith);
+    }
+  }
+}
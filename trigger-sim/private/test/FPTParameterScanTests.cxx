@@ -0,0 +1,111 @@
+#include <I3Test.h>
+
+#include <vector>
+#include "trigger-sim/algorithms/FaintParticleTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/FPTParameterScan.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include <icetray/OMKey.h>
+#include <dataclasses/geometry/I3Geometry.h>
+#include <dataclasses/physics/I3DOMLaunch.h>
+#include <dataclasses/physics/I3RecoPulse.h>
+#include <phys-services/I3GSLRandomService.h>
+#include "TestGeometry.h"
+
+TEST_GROUP(FPTParameterScanTests);
+
+namespace FPTParameterScanTests{
+  // Two values of every setting but hitMax and doubleVelocityMax
+  std::vector<FPTConfiguration> MakeGrid(){
+    std::vector<FPTConfiguration> grid;
+    for(int i = 0; i < 1 << 10; i++){
+      FPTConfiguration configuration;
+      configuration.timeWindow = (i & 1) ? 1000 : 2000;
+      configuration.timeWindowSeparation = (i & 2) ? 250 : 500;
+      configuration.maxTriggerLength = (i & 4) ? 1500 : 6000;
+      configuration.hitMin = (i & 8) ? 3 : 4;
+      configuration.hitMax = 80;
+      configuration.doubleVelocityMin = (i & 16) ? 5e4 : 1e5;
+      configuration.doubleVelocityMax = 3e6;
+      configuration.doubleMin = (i & 32) ? 3 : 5;
+      configuration.azimuthHistogramMin = (i & 64) ? 2 : 6;
+      configuration.zenithHistogramMin = 5;
+      configuration.histogramBinning = (i & 128) ? 15 : 10;
+      configuration.slcFractionMin = (i & 256) ? 0.4 : 0.;
+      // the hits never pass a maximum velocity of 0
+      if(i & 512) configuration.doubleVelocityMax = 0;
+      grid.push_back(configuration);
+    }
+    return grid;
+  }
+
+  // GetNextTrigger hands out the last trigger first
+  bool SameTriggers(const TriggerHitVectorVector& a, FaintParticleTriggerAlgorithm& fpt){
+    if(a.size() != fpt.GetNumberOfTriggers()) return false;
+    for(size_t i = a.size(); i-- > 0; ){
+      TriggerHitVectorPtr trigger = fpt.GetNextTrigger();
+      if(a[i].size() != trigger->size()) return false;
+      for(size_t j = 0; j < a[i].size(); j++)
+        if(!(a[i][j] == (*trigger)[j])) return false;
+    }
+    return true;
+  }
+}
+
+TEST(SameAsTheTrigger){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(2024);
+  std::vector<FPTConfiguration> grid = FPTParameterScanTests::MakeGrid();
+  FPTParameterScan scan(*geo);
+
+  unsigned int ntriggered = 0;
+  for(int event = 0; event < 10; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+    I3RecoPulseSeriesMapConstPtr pulses(new I3RecoPulseSeriesMap());
+
+    // any FPT gives the hits of the DOM set
+    FaintParticleTriggerAlgorithm hits(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                       geo, 2, I3MapKeyVectorIntConstPtr());
+    hits.FillHits(launches, pulses, true);
+    std::vector<FPTScanResult> results;
+    scan.Run(hits.GetHits(), grid, results, 4);
+    ENSURE_EQUAL(results.size(), grid.size());
+
+    for(size_t i = 0; i < grid.size(); i++){
+      const FPTConfiguration& c = grid[i];
+      FaintParticleTriggerAlgorithm fpt(c.timeWindow, c.timeWindowSeparation, c.maxTriggerLength,
+                                        c.hitMin, c.hitMax, c.doubleVelocityMin, c.doubleVelocityMax,
+                                        c.doubleMin, c.azimuthHistogramMin, c.zenithHistogramMin,
+                                        c.histogramBinning, c.slcFractionMin,
+                                        geo, 2, I3MapKeyVectorIntConstPtr());
+      fpt.FillHits(launches, pulses, true);
+      fpt.Trigger();
+
+      ENSURE_EQUAL(results[i].windows, fpt.GetNumberOfWindows(), "Different windows");
+      ENSURE_EQUAL(results[i].hitCountPassed, fpt.GetCutPassCounts()[0]);
+      ENSURE_EQUAL(results[i].doublesPassed, fpt.GetCutPassCounts()[1]);
+      ENSURE_EQUAL(results[i].directionPassed, fpt.GetCutPassCounts()[2]);
+      ENSURE_EQUAL(results[i].slcFractionPassed, fpt.GetCutPassCounts()[3]);
+      if(!results[i].triggers.empty()) ntriggered++;
+      ENSURE(FPTParameterScanTests::SameTriggers(results[i].triggers, fpt),
+             "The scan and the trigger found different triggers");
+    }
+  }
+  // make sure the comparison is not trivial
+  ENSURE(ntriggered > 0);
+  ENSURE(ntriggered < 10*grid.size());
+}
+
+TEST(TooFewHits){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  FPTParameterScan scan(*geo);
+  std::vector<FPTConfiguration> grid = FPTParameterScanTests::MakeGrid();
+  std::vector<FPTScanResult> results;
+
+  TriggerHitVector hits(1, TriggerHit(100, 1, 1, false));
+  scan.Run(hits, grid, results);
+  ENSURE_EQUAL(results.size(), grid.size());
+  for(size_t i = 0; i < results.size(); i++){
+    ENSURE_EQUAL(results[i].windows, 0ul);
+    ENSURE(results[i].triggers.empty());
+  }
+}
@@ -0,0 +1,205 @@
+#include <I3Test.h>
+
+#include <vector>
+#include "trigger-sim/algorithms/FaintParticleTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include <icetray/OMKey.h>
+#include <dataclasses/geometry/I3Geometry.h>
+#include <dataclasses/physics/I3DOMLaunch.h>
+#include <dataclasses/physics/I3RecoPulse.h>
+#include <phys-services/I3GSLRandomService.h>
+#include "TestGeometry.h"
+
+TEST_GROUP(FaintParticleTriggerTests);
+
+namespace FaintParticleTriggerTests{
+  std::vector<TriggerHitVector> RunFPT(FaintParticleTriggerAlgorithm& fpt, I3DOMLaunchSeriesMapConstPtr launches){
+    fpt.FillHits(launches, I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()), true);
+    fpt.Trigger();
+    std::vector<TriggerHitVector> triggers;
+    unsigned int ntriggers = fpt.GetNumberOfTriggers();
+    for(unsigned int i = 0; i < ntriggers; i++)
+      triggers.push_back(*fpt.GetNextTrigger());
+    return triggers;
+  }
+
+  bool SameTriggers(const std::vector<TriggerHitVector>& a, const std::vector<TriggerHitVector>& b){
+    if(a.size() != b.size()) return false;
+    for(size_t i = 0; i < a.size(); i++){
+      if(a[i].size() != b[i].size()) return false;
+      for(size_t j = 0; j < a[i].size(); j++)
+        if(!(a[i][j] == b[i][j])) return false;
+    }
+    return true;
+  }
+}
+
+TEST(EvaluationModesAgree){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(4242);
+
+  const FaintParticleTriggerAlgorithm::EvaluationMode modes[] = {
+    FaintParticleTriggerAlgorithm::ROLLING_PAIR_CACHE,
+    FaintParticleTriggerAlgorithm::EARLY_EXIT
+  };
+
+  unsigned int ntriggered = 0;
+  for(int event = 0; event < 100; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+
+    // time_window, separation, max_length, hit_min, hit_max, vmin, vmax,
+    // double_min, azimuth_min, zenith_min, binning, slc_fraction
+    FaintParticleTriggerAlgorithm reference(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                            geo, 2, I3MapKeyVectorIntConstPtr());
+    std::vector<TriggerHitVector> expected = FaintParticleTriggerTests::RunFPT(reference, launches);
+    if(!expected.empty()) ntriggered++;
+
+    for(FaintParticleTriggerAlgorithm::EvaluationMode mode : modes){
+      FaintParticleTriggerAlgorithm fpt(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                        geo, 2, I3MapKeyVectorIntConstPtr());
+      fpt.SetEvaluationMode(mode);
+      ENSURE(FaintParticleTriggerTests::SameTriggers(expected, FaintParticleTriggerTests::RunFPT(fpt, launches)),
+             "Evaluation mode changed the triggers");
+    }
+  }
+  // make sure the comparison is not trivial
+  ENSURE(ntriggered > 0);
+  ENSURE(ntriggered < 100);
+}
+
+TEST(ReusedAcrossFrames){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(1717);
+
+  // one instance runs over all frames, like in I3TriggerSimModule
+  FaintParticleTriggerAlgorithm reused(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                       geo, 2, I3MapKeyVectorIntConstPtr());
+  I3DOMLaunchSeriesMapPtr empty(new I3DOMLaunchSeriesMap());
+
+  unsigned int ntriggered = 0;
+  for(int event = 0; event < 50; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+
+    FaintParticleTriggerAlgorithm fresh(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                        geo, 2, I3MapKeyVectorIntConstPtr());
+    std::vector<TriggerHitVector> expected = FaintParticleTriggerTests::RunFPT(fresh, launches);
+    if(!expected.empty()) ntriggered++;
+
+    ENSURE(FaintParticleTriggerTests::SameTriggers(expected, FaintParticleTriggerTests::RunFPT(reused, launches)),
+           "A reused service gave different triggers");
+
+    // an empty frame never triggers, whatever the frame before it did
+    reused.FillHits(empty, I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()), true);
+    reused.Trigger();
+    ENSURE(reused.GetNumberOfTriggers() == 0u, "Triggers leaked into the next frame");
+  }
+  ENSURE(ntriggered > 0);
+}
+
+TEST(CutStatistics){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(2323);
+
+  const FaintParticleTriggerAlgorithm::EvaluationMode modes[] = {
+    FaintParticleTriggerAlgorithm::ROLLING_PAIR_CACHE,
+    FaintParticleTriggerAlgorithm::EARLY_EXIT
+  };
+
+  unsigned long npassed = 0;
+  for(int event = 0; event < 50; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+
+    FaintParticleTriggerAlgorithm reference(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                            geo, 2, I3MapKeyVectorIntConstPtr());
+    reference.SetCutTiming(true);
+    FaintParticleTriggerTests::RunFPT(reference, launches);
+
+    // the cuts are applied in the order 1, 4, 2, 3
+    const std::vector<unsigned long>& passed = reference.GetCutPassCounts();
+    ENSURE(passed.size() == 4u);
+    ENSURE(reference.GetNumberOfWindows() >= passed[0]);
+    ENSURE(passed[0] >= passed[3]);
+    ENSURE(passed[3] >= passed[1]);
+    ENSURE(passed[1] >= passed[2]);
+    ENSURE(reference.GetCutTimes().size() == 4u);
+    npassed += passed[2];
+
+    // the evaluation modes only change how the cuts are computed
+    for(FaintParticleTriggerAlgorithm::EvaluationMode mode : modes){
+      FaintParticleTriggerAlgorithm fpt(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                        geo, 2, I3MapKeyVectorIntConstPtr());
+      fpt.SetEvaluationMode(mode);
+      FaintParticleTriggerTests::RunFPT(fpt, launches);
+      ENSURE(fpt.GetNumberOfWindows() == reference.GetNumberOfWindows());
+      ENSURE(fpt.GetCutPassCounts() == passed, "Evaluation mode changed the cut statistics");
+    }
+  }
+  ENSURE(npassed > 0);
+}
+
+TEST(FractionalBinning){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(3131);
+
+  const FaintParticleTriggerAlgorithm::EvaluationMode modes[] = {
+    FaintParticleTriggerAlgorithm::FULL_EVALUATION,
+    FaintParticleTriggerAlgorithm::ROLLING_PAIR_CACHE,
+    FaintParticleTriggerAlgorithm::EARLY_EXIT
+  };
+
+  // the binning is dropped to whole degrees in every mode
+  for(int event = 0; event < 20; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+    FaintParticleTriggerAlgorithm reference(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 2, 2, 10, 0.,
+                                            geo, 2, I3MapKeyVectorIntConstPtr());
+    std::vector<TriggerHitVector> expected = FaintParticleTriggerTests::RunFPT(reference, launches);
+
+    for(FaintParticleTriggerAlgorithm::EvaluationMode mode : modes){
+      FaintParticleTriggerAlgorithm fpt(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 2, 2, 10.7, 0.,
+                                        geo, 2, I3MapKeyVectorIntConstPtr());
+      fpt.SetEvaluationMode(mode);
+      ENSURE(FaintParticleTriggerTests::SameTriggers(expected, FaintParticleTriggerTests::RunFPT(fpt, launches)),
+             "A fractional binning gave different triggers");
+    }
+  }
+}
+
+TEST(CompiledKernelsAgree){
+  I3GeometryPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(5151);
+
+  const FaintParticleTriggerAlgorithm::EvaluationMode modes[] = {
+    FaintParticleTriggerAlgorithm::FULL_EVALUATION,
+    FaintParticleTriggerAlgorithm::EARLY_EXIT
+  };
+
+  // binning 7 has no compiled kernels
+  FaintParticleTriggerAlgorithm other(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 7, 0.,
+                                      geo, 2, I3MapKeyVectorIntConstPtr());
+  ENSURE(!other.HasCompiledKernels());
+
+  unsigned int ntriggered = 0;
+  for(int event = 0; event < 50; event++){
+    I3DOMLaunchSeriesMapPtr launches = TestGeometry::MakeSlowTrackLaunches(rand);
+
+    for(FaintParticleTriggerAlgorithm::EvaluationMode mode : modes){
+      // the settings of config ID 33001
+      FaintParticleTriggerAlgorithm runtime(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                            geo, 2, I3MapKeyVectorIntConstPtr());
+      runtime.SetUseCompiledKernels(false);
+      runtime.SetEvaluationMode(mode);
+      std::vector<TriggerHitVector> expected = FaintParticleTriggerTests::RunFPT(runtime, launches);
+      if(!expected.empty()) ntriggered++;
+
+      FaintParticleTriggerAlgorithm compiled(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                             geo, 2, I3MapKeyVectorIntConstPtr());
+      ENSURE(compiled.HasCompiledKernels());
+      compiled.SetEvaluationMode(mode);
+      ENSURE(FaintParticleTriggerTests::SameTriggers(expected, FaintParticleTriggerTests::RunFPT(compiled, launches)),
+             "The compiled kernels changed the triggers");
+      ENSURE(compiled.GetCutPassCounts() == runtime.GetCutPassCounts(),
+             "The compiled kernels changed the cut statistics");
+    }
+  }
+  ENSURE(ntriggered > 0);
+}
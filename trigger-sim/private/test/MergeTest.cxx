@@ -193,3 +193,43 @@ TEST(test_merged_length_long_enough){
   ENSURE(merged_iterator->GetTriggerLength() == 28000);
   
 }
+
+// Throughput triggers from different readout windows don't have to come
+// in order of their start.  A window that overlaps an earlier one has to
+// end up in the same merged trigger anyway.
+
+TEST(test_merge_unsorted_windows){
+
+  I3DetectorStatus d;
+  GlobalTriggerSim gts(d);
+
+  TriggerKey global_key=TriggerKey(TriggerKey::GLOBAL, TriggerKey::THROUGHPUT);
+
+  double times[] = {2000., 0., 400., 10000.};
+  double lengths[] = {1000., 500., 1700., 1000.};
+
+  I3TriggerPairVector tTriggers;
+  for(int i = 0; i < 4; i++){
+    I3Trigger tt;
+    tt.GetTriggerKey() = global_key;
+    tt.SetTriggerFired(true);
+    tt.SetTriggerTime(times[i]);
+    tt.SetTriggerLength(lengths[i]);
+    tTriggers.push_back( I3TriggerPair( tt, I3Trigger() ) );
+  }
+
+  I3TriggerHierarchyPtr gTriggers = gts.Merge(tTriggers);
+
+  ENSURE(gTriggers->number_of_siblings(gTriggers->begin()) == 1);
+
+  // the latest window comes first
+  I3TriggerHierarchy::sibling_iterator top(gTriggers->begin());
+  ENSURE(top->GetTriggerKey().GetType() == TriggerKey::THROUGHPUT);
+  ENSURE(top->GetTriggerTime() == 10000.);
+
+  ++top;
+  ENSURE(top->GetTriggerKey().GetType() == TriggerKey::MERGED);
+  ENSURE(top->GetTriggerTime() == 0.);
+  ENSURE(top->GetTriggerLength() == 3000.);
+  ENSURE(gTriggers->number_of_children(top) == 3);
+}
@@ -1,5 +1,6 @@
 
 #include <I3Test.h>
+#include <algorithm>
 #include <iostream>
 #include <boost/foreach.hpp>
 #include <trigger-sim/algorithms/SimpleMajorityTriggerAlgorithm.h>
@@ -211,3 +212,98 @@ TEST(connector_test){
   ConnectorTest();
 }
 
+
+TEST(trigger_records) {
+  I3GSLRandomService rand(4711);
+  I3RecoPulseSeriesMapPtr hits(new I3RecoPulseSeriesMap());
+  for(unsigned int n(0); n < 5; n++){
+    for(unsigned int nHits(0); nHits < 10; nHits++)
+      AddPulse(hits, rand.Uniform(0, 1000) + n*10000, rand.Uniform(1,60), rand.Uniform(1,86));
+  }
+
+  SimpleMajorityTriggerAlgorithm copied(1000, 8, 11, I3MapKeyVectorIntConstPtr());
+  copied.FillHits(I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap()),
+                  I3RecoPulseSeriesMapConstPtr(hits), false);
+  copied.Trigger();
+  SimpleMajorityTriggerAlgorithm viewed(1000, 8, 11, I3MapKeyVectorIntConstPtr());
+  viewed.FillHits(I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap()),
+                  I3RecoPulseSeriesMapConstPtr(hits), false);
+  viewed.Trigger();
+
+  unsigned int nTrig = copied.GetNumberOfTriggers();
+  ENSURE(nTrig == 5);
+  TriggerRecord record;
+  for(unsigned int i(0); i < nTrig; i++){
+    TriggerHitVectorPtr triggerHits = copied.GetNextTrigger();
+    ENSURE(viewed.GetNextTriggerRecord(record));
+    ENSURE(record.nHits == triggerHits->size());
+    ENSURE(std::equal(triggerHits->begin(), triggerHits->end(), record.hits));
+    ENSURE(record.startTime == triggerHits->front().time);
+    ENSURE(record.stopTime == triggerHits->back().time);
+  }
+  ENSURE(!viewed.GetNextTriggerRecord(record));
+}
+
+namespace {
+  // The triggers of the service in time order
+  std::vector<TriggerHitVector> TakeTriggers(TriggerService& service){
+    std::vector<TriggerHitVector> triggers;
+    TriggerRecord record;
+    while(service.GetNextTriggerRecord(record))
+      triggers.insert(triggers.begin(), TriggerHitVector(record.hits, record.hits + record.nHits));
+    return triggers;
+  }
+}
+
+// Pushing the hits in chunks gives the triggers of the whole frame, if the
+// frame ends with a hit that no window reaches, since the stream has no
+// last hit.
+TEST(streaming_matches_frames) {
+  I3GSLRandomService rand(2718);
+  for(unsigned int trial(0); trial < 200; trial++){
+    double timeWindow(rand.Uniform(100, 2000));
+    unsigned int multiplicity(1 + rand.Integer(8));
+
+    I3RecoPulseSeriesMapPtr pulses(new I3RecoPulseSeriesMap());
+    unsigned int nHits(rand.Integer(300));
+    for(unsigned int n(0); n < nHits; n++)
+      AddPulse(pulses, floor(rand.Uniform(0, 100000)/25)*25, rand.Uniform(1,60), rand.Uniform(1,86));
+    AddPulse(pulses, 1e7, 1, 1);
+
+    SimpleMajorityTriggerAlgorithm frame(timeWindow, multiplicity, 11, I3MapKeyVectorIntConstPtr());
+    frame.FillHits(I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap()),
+                   I3RecoPulseSeriesMapConstPtr(pulses), false);
+    frame.Trigger();
+    std::vector<TriggerHitVector> expected = TakeTriggers(frame);
+
+    // the same hits, in the same order as FillHits, without the last one
+    TriggerHitVector hits;
+    BOOST_FOREACH(const I3RecoPulseSeriesMap::value_type& series, *pulses){
+      BOOST_FOREACH(const I3RecoPulse& pulse, series.second)
+        hits.push_back(TriggerHit(pulse.GetTime(), series.first.GetOM(), series.first.GetString(), true));
+    }
+    std::stable_sort(hits.begin(), hits.end());
+    hits.pop_back();
+
+    // the second stream on the same service has to start over
+    SimpleMajorityTriggerAlgorithm stream(timeWindow, multiplicity, 11, I3MapKeyVectorIntConstPtr());
+    for(int pass(0); pass < 2; pass++){
+      std::vector<TriggerHitVector> streamed;
+      size_t pushed(0);
+      while(pushed < hits.size()){
+        size_t chunk = std::min<size_t>(rand.Integer(20), hits.size() - pushed);
+        stream.PushHits(hits.data() + pushed, chunk);
+        pushed += chunk;
+        std::vector<TriggerHitVector> triggers = TakeTriggers(stream);
+        streamed.insert(streamed.end(), triggers.begin(), triggers.end());
+      }
+      stream.Flush();
+      std::vector<TriggerHitVector> triggers = TakeTriggers(stream);
+      streamed.insert(streamed.end(), triggers.begin(), triggers.end());
+
+      ENSURE(streamed == expected, "Streaming and frame triggers differ");
+      ENSURE_EQUAL(stream.GetNumberOfWindows(), frame.GetNumberOfWindows(),
+                   "Streaming and frame windows differ");
+    }
+  }
+}
@@ -0,0 +1,300 @@
+#include <I3Test.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "trigger-sim/algorithms/SlowMonopoleTriggerAlgorithm.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include <icetray/I3Units.h>
+#include <dataclasses/geometry/I3Geometry.h>
+#include <phys-services/I3GSLRandomService.h>
+#include "TestGeometry.h"
+
+TEST_GROUP(SlowMonopoleTriggerTests);
+
+namespace SlowMonopoleTriggerTests{
+  typedef std::vector<std::pair<double, double> > Windows;
+
+  struct Settings{
+    double t_proximity, t_min, t_max;
+    boost::optional<double> deltad, alpha_min;
+    boost::optional<bool> dc_algo;
+    double relv;
+    int min_tuples;
+    double max_event_length;
+  };
+
+  // IC2012 settings, and IC2011 ones with the angle instead of delta_d
+  Settings IC2012(){
+    Settings s = {2500, 0, 500000, 100., boost::none, true, 0.5, 5, 5000000};
+    return s;
+  }
+  Settings IC2011(){
+    Settings s = {2500, 0, 500000, boost::none, 140., false, 0.5, 3, 5000000};
+    return s;
+  }
+
+  /*
+   * The SLOP algorithm as it was before the triple search used the time
+   * windows: every triple of the pair list is checked, with a geometry
+   * lookup for each of its distances.
+   */
+  class Baseline{
+  public:
+    Baseline(const Settings& s, I3GeometryConstPtr geo) : s_(s), geo_(geo) {
+      if(s_.alpha_min) cos_alpha_min_ = cos(s_.alpha_min.get()*I3Units::degree);
+    }
+
+    Windows Run(const TriggerHitVector& hits){
+      windows_.clear();
+      containers_.clear();
+      TriggerHitVector one_hit_list;
+      TriggerHitVector two_hit_list;
+      double muon_time_window = -1;
+      for(size_t i = 0; i < hits.size(); i++)
+        RunTrigger(one_hit_list, two_hit_list, muon_time_window, hits[i]);
+      CheckTriggerStatus(two_hit_list);
+      return windows_;
+    }
+
+  private:
+    struct Container{ double start; double length; int ntuples; };
+
+    void AddPair(TriggerHitVector& two_hit_list, double& muon_time_window, const TriggerHit& check){
+      if(two_hit_list.empty()){
+        if(muon_time_window == -1)
+          two_hit_list.push_back(check);
+        else if(check.time - muon_time_window <= s_.t_proximity)
+          muon_time_window = check.time;
+        else{
+          two_hit_list.push_back(check);
+          muon_time_window = -1;
+        }
+        return;
+      }
+      if(muon_time_window == -1 && check.time - two_hit_list.back().time <= s_.t_proximity){
+        muon_time_window = check.time;
+        two_hit_list.pop_back();
+        return;
+      }
+      if(muon_time_window != -1){
+        if(check.time - muon_time_window <= s_.t_proximity){
+          muon_time_window = check.time;
+          return;
+        }
+        muon_time_window = -1;
+      }
+      if(!(check.time - two_hit_list.back().time < s_.t_max &&
+           check.time - two_hit_list.front().time < s_.max_event_length))
+        CheckTriggerStatus(two_hit_list);
+      two_hit_list.push_back(check);
+    }
+
+    void RunTrigger(TriggerHitVector& one_hit_list, TriggerHitVector& two_hit_list,
+                    double& muon_time_window, const TriggerHit& new_hit){
+      if(one_hit_list.empty()){
+        one_hit_list.push_back(new_hit);
+        return;
+      }
+      while(fabs(new_hit.time - one_hit_list.front().time) > 1000.0){
+        one_hit_list.erase(one_hit_list.begin());
+        if(one_hit_list.empty()) break;
+      }
+      for(TriggerHitVector::iterator one_hit = one_hit_list.begin(); one_hit != one_hit_list.end(); ){
+        if(one_hit->string == new_hit.string && abs(int(one_hit->pos) - int(new_hit.pos)) <= 2){
+          AddPair(two_hit_list, muon_time_window, *one_hit);
+          one_hit = one_hit_list.erase(one_hit);
+        }
+        else
+          one_hit++;
+      }
+      one_hit_list.push_back(new_hit);
+      if(!two_hit_list.empty() && one_hit_list.front().time - two_hit_list.back().time > s_.t_max)
+        CheckTriggerStatus(two_hit_list);
+    }
+
+    void CheckTriggerStatus(TriggerHitVector& two_hit_list){
+      for(size_t i = 0; i + 2 < two_hit_list.size(); i++)
+        for(size_t j = i + 1; j + 1 < two_hit_list.size(); j++)
+          for(size_t k = j + 1; k < two_hit_list.size(); k++)
+            CheckTriple(two_hit_list[i], two_hit_list[j], two_hit_list[k]);
+      for(size_t i = 0; i < containers_.size(); i++)
+        windows_.push_back(std::make_pair(containers_[i].start, containers_[i].start + containers_[i].length));
+      containers_.clear();
+      two_hit_list.clear();
+    }
+
+    double Distance(const TriggerHit& hit1, const TriggerHit& hit2){
+      const I3Position& pos1 = geo_->omgeo.find(OMKey(hit1.string, hit1.pos))->second.position;
+      const I3Position& pos2 = geo_->omgeo.find(OMKey(hit2.string, hit2.pos))->second.position;
+      return sqrt(pow(pos2.GetX() - pos1.GetX(), 2) + pow(pos2.GetY() - pos1.GetY(), 2) +
+                  pow(pos2.GetZ() - pos1.GetZ(), 2));
+    }
+
+    void CheckTriple(const TriggerHit& hit1, const TriggerHit& hit2, const TriggerHit& hit3){
+      double t_diff1 = hit2.time - hit1.time;
+      double t_diff2 = hit3.time - hit2.time;
+      if(!(t_diff1 > s_.t_min && t_diff2 > s_.t_min && t_diff1 < s_.t_max && t_diff2 < s_.t_max))
+        return;
+      double t_diff3 = hit3.time - hit1.time;
+      double p_diff1 = Distance(hit1, hit2);
+      double p_diff2 = Distance(hit2, hit3);
+      double p_diff3 = Distance(hit1, hit3);
+      if(!(p_diff1 > 0 && p_diff2 > 0 && p_diff3 > 0))
+        return;
+      double cos_alpha = (pow(p_diff1,2) + pow(p_diff2,2) - pow(p_diff3,2))/(2*p_diff1*p_diff2);
+      if(!((s_.deltad && p_diff1 + p_diff2 - p_diff3 <= s_.deltad.get()) ||
+           (s_.alpha_min && cos_alpha <= cos_alpha_min_)))
+        return;
+      double inv_v1 = t_diff1/p_diff1;
+      double inv_v2 = t_diff2/p_diff2;
+      double inv_v3 = t_diff3/p_diff3;
+      double inv_v_mean = (inv_v1 + inv_v2 + inv_v3)/3.0;
+      if(!(fabs(inv_v2 - inv_v1)/inv_v_mean <= s_.relv))
+        return;
+
+      double start = hit1.time;
+      double end = hit3.time;
+      if(containers_.empty()){
+        Container c = {start, end - start, 1};
+        containers_.push_back(c);
+        return;
+      }
+      Container& last = containers_.back();
+      double last_end = last.start + last.length;
+      if(start >= last.start && start <= last_end && end > last_end){
+        last.length = end - last.start;
+        last.ntuples++;
+      }
+      else if(start >= last.start && end <= last_end)
+        last.ntuples++;
+      else if(start > last_end){
+        Container c = {start, end - start, 1};
+        containers_.push_back(c);
+      }
+    }
+
+    Settings s_;
+    I3GeometryConstPtr geo_;
+    double cos_alpha_min_;
+    std::vector<Container> containers_;
+    Windows windows_;
+  };
+
+  Windows RunSLOP(const Settings& s, I3GeometryConstPtr geo, const TriggerHitVector& hits){
+    SlowMonopoleTriggerAlgorithm slop(s.t_proximity, s.t_min, s.t_max, s.deltad, s.alpha_min,
+                                      s.dc_algo, s.relv, s.min_tuples, s.max_event_length,
+                                      geo, 2, I3MapKeyVectorIntConstPtr());
+    slop.FillHits(hits.data(), hits.size(), false);
+    slop.Trigger();
+    // GetNextTrigger hands out the last trigger first
+    Windows windows(slop.GetNumberOfTriggers());
+    for(size_t i = windows.size(); i-- > 0; ){
+      TriggerHitVectorPtr trigger = slop.GetNextTrigger();
+      windows[i] = std::make_pair(trigger->front().time, trigger->back().time);
+    }
+    return windows;
+  }
+
+  // An HLC pair on neighbouring DOMs of a string
+  void AddPair(TriggerHitVector& hits, double time, int string, unsigned om){
+    hits.push_back(TriggerHit(time, om, string, true));
+    hits.push_back(TriggerHit(time + 200, om + 1, string, true));
+  }
+
+  // A slow particle going down a string, one HLC pair every step
+  TriggerHitVector MakeTrack(double t0, int string, unsigned om0, int npairs, double step){
+    TriggerHitVector hits;
+    for(int i = 0; i < npairs; i++)
+      AddPair(hits, t0 + step*i, string, om0 + 3*i);
+    return hits;
+  }
+
+  // Random HLC pairs, bursts of pairs within t_proximity like a muon,
+  // and single hits, on the strings 1 to 78 of DOM set 2
+  TriggerHitVector MakeRandomHits(I3GSLRandomService& rand){
+    TriggerHitVector hits;
+    int npairs = rand.Integer(40);
+    for(int i = 0; i < npairs; i++){
+      double time = floor(rand.Uniform(0, 3e6));
+      int string = 1 + rand.Integer(78);
+      unsigned om = 1 + rand.Integer(58);
+      int nburst = rand.Uniform(0, 1) < 0.2 ? 2 + rand.Integer(3) : 1;
+      for(int j = 0; j < nburst; j++)
+        AddPair(hits, time + 1500*j, string, std::min(58u, om + 2*j));
+    }
+    int nsingle = rand.Integer(40);
+    for(int i = 0; i < nsingle; i++)
+      hits.push_back(TriggerHit(floor(rand.Uniform(0, 3e6)), 1 + rand.Integer(60), 1 + rand.Integer(78), true));
+    std::stable_sort(hits.begin(), hits.end());
+    return hits;
+  }
+}
+
+// A clean track forms tuples that merge into one trigger
+TEST(tuples){
+  I3GeometryConstPtr geo = TestGeometry::MakeDetector();
+  TriggerHitVector hits = SlowMonopoleTriggerTests::MakeTrack(1000, 36, 1, 8, 50000);
+  SlowMonopoleTriggerTests::Settings settings[] = {SlowMonopoleTriggerTests::IC2012(),
+                                                    SlowMonopoleTriggerTests::IC2011()};
+  for(const SlowMonopoleTriggerTests::Settings& s : settings){
+    SlowMonopoleTriggerTests::Windows expected = SlowMonopoleTriggerTests::Baseline(s, geo).Run(hits);
+    ENSURE_EQUAL(expected.size(), 1u, "The track has to trigger");
+    ENSURE(SlowMonopoleTriggerTests::RunSLOP(s, geo, hits) == expected,
+           "SLOP and the baseline found different triggers");
+  }
+}
+
+// Several tracks and muon bursts in one frame: lists that are checked
+// when a pair is too late for them, and lists left out of time order
+// by the muon time window
+TEST(multiple_hits){
+  I3GeometryConstPtr geo = TestGeometry::MakeDetector();
+  TriggerHitVector hits = SlowMonopoleTriggerTests::MakeTrack(1000, 36, 1, 6, 40000);
+  TriggerHitVector second = SlowMonopoleTriggerTests::MakeTrack(2e6, 45, 10, 6, 60000);
+  hits.insert(hits.end(), second.begin(), second.end());
+  // a muon in the middle of the first track
+  for(int i = 0; i < 4; i++)
+    SlowMonopoleTriggerTests::AddPair(hits, 101500 + 1000*i, 50, 20 + 2*i);
+  std::stable_sort(hits.begin(), hits.end());
+
+  SlowMonopoleTriggerTests::Settings s = SlowMonopoleTriggerTests::IC2012();
+  SlowMonopoleTriggerTests::Windows expected = SlowMonopoleTriggerTests::Baseline(s, geo).Run(hits);
+  ENSURE(expected.size() >= 2u, "Both tracks have to trigger");
+  ENSURE(SlowMonopoleTriggerTests::RunSLOP(s, geo, hits) == expected,
+         "SLOP and the baseline found different triggers");
+}
+
+// The last pairs of the frame are only checked by the final
+// CheckTriggerStatus of Trigger
+TEST(last_hit){
+  I3GeometryConstPtr geo = TestGeometry::MakeDetector();
+  SlowMonopoleTriggerTests::Settings s = SlowMonopoleTriggerTests::IC2012();
+  for(int npairs = 2; npairs <= 5; npairs++){
+    TriggerHitVector hits = SlowMonopoleTriggerTests::MakeTrack(1000, 36, 1, npairs, 50000);
+    SlowMonopoleTriggerTests::Windows expected = SlowMonopoleTriggerTests::Baseline(s, geo).Run(hits);
+    ENSURE_EQUAL(expected.size(), npairs >= 3 ? 1u : 0u);
+    ENSURE(SlowMonopoleTriggerTests::RunSLOP(s, geo, hits) == expected,
+           "SLOP and the baseline found different triggers");
+  }
+}
+
+TEST(random_hits){
+  I3GeometryConstPtr geo = TestGeometry::MakeDetector();
+  I3GSLRandomService rand(1997);
+  unsigned int ntriggered = 0;
+  for(int event = 0; event < 300; event++){
+    SlowMonopoleTriggerTests::Settings s = event % 2 ? SlowMonopoleTriggerTests::IC2011() :
+      SlowMonopoleTriggerTests::IC2012();
+    s.relv = rand.Uniform(0.2, 3.);
+    s.t_max = rand.Uniform(1e5, 1e6);
+    TriggerHitVector hits = SlowMonopoleTriggerTests::MakeRandomHits(rand);
+    SlowMonopoleTriggerTests::Windows expected = SlowMonopoleTriggerTests::Baseline(s, geo).Run(hits);
+    if(!expected.empty()) ntriggered++;
+    ENSURE(SlowMonopoleTriggerTests::RunSLOP(s, geo, hits) == expected,
+           "SLOP and the baseline found different triggers");
+  }
+  // make sure the comparison is not trivial
+  ENSURE(ntriggered > 0);
+}
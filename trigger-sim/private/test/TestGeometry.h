@@ -0,0 +1,72 @@
+#ifndef TRIGGER_SIM_TEST_GEOMETRY_H
+#define TRIGGER_SIM_TEST_GEOMETRY_H
+
+/**
+ * Geometries and launches shared by the trigger tests.
+ */
+
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <icetray/OMKey.h>
+#include <dataclasses/geometry/I3Geometry.h>
+#include <dataclasses/physics/I3DOMLaunch.h>
+#include <phys-services/I3GSLRandomService.h>
+
+namespace TestGeometry{
+  /**
+   * Strings 1 to nstrings with DOMs 1 to noms.  String s stands in column
+   * (s + shift) % perRow and row (s + shift) / perRow of a grid with 125 m
+   * spacing that starts at origin.  Its DOMs go down from origin, 17 m apart.
+   */
+  inline I3GeometryPtr MakeGeometry(int nstrings, unsigned noms, int perRow, int shift,
+                                    const I3Position& origin = I3Position(0, 0, 0)){
+    I3GeometryPtr geo(new I3Geometry());
+    for(int string = 1; string <= nstrings; string++){
+      for(unsigned om = 1; om <= noms; om++){
+        I3OMGeo omgeo;
+        omgeo.position = I3Position(origin.GetX() + 125.*((string + shift) % perRow),
+                                    origin.GetY() + 125.*((string + shift) / perRow),
+                                    origin.GetZ() - 17.*om);
+        geo->omgeo[OMKey(string, om)] = omgeo;
+      }
+    }
+    return geo;
+  }
+
+  /**
+   * 86 strings of 60 DOMs, about the size of IceCube.
+   */
+  inline I3GeometryPtr MakeDetector(){
+    return MakeGeometry(86, 60, 10, -1, I3Position(-560, -500, 500));
+  }
+
+  /**
+   * Noise plus a slow track of SLC and HLC launches in MakeDetector.
+   */
+  inline I3DOMLaunchSeriesMapPtr MakeSlowTrackLaunches(I3GSLRandomService& rand){
+    I3DOMLaunchSeriesMapPtr launches(new I3DOMLaunchSeriesMap());
+    std::vector<std::pair<OMKey, I3DOMLaunch> > all;
+    int nnoise = 20 + rand.Integer(80);
+    for(int i = 0; i < nnoise; i++){
+      I3DOMLaunch launch;
+      launch.SetStartTime(floor(rand.Uniform(0, 20000)));
+      launch.SetLCBit(rand.Uniform(0, 1) < 0.3);
+      all.push_back(std::make_pair(OMKey(1 + rand.Integer(86), 1 + rand.Integer(60)), launch));
+    }
+    int string = 1 + rand.Integer(80);
+    double t0 = rand.Uniform(0, 10000);
+    int ntrack = 3 + rand.Integer(15);
+    for(int i = 0; i < ntrack; i++){
+      I3DOMLaunch launch;
+      launch.SetStartTime(t0 + 100*i + floor(rand.Uniform(0, 30)));
+      launch.SetLCBit(rand.Uniform(0, 1) < 0.5);
+      all.push_back(std::make_pair(OMKey(string + i % 3, 1 + (4*i) % 60), launch));
+    }
+    for(size_t i = 0; i < all.size(); i++)
+      (*launches)[all[i].first].push_back(all[i].second);
+    return launches;
+  }
+}
+
+#endif // TRIGGER_SIM_TEST_GEOMETRY_H
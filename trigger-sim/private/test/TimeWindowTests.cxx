@@ -351,3 +351,20 @@ TEST(theshold_equal) {
 TEST(theshold_low) {
   TimeWindowTests::TestThreshold(9);
 }
+
+TEST(repeated_hits) {
+  // The same hit twice at the end of the window, then a hit far away.
+  // The window runs up to the first hit at the time of its last hit.
+  TimeWindow timeWindowClass(3, 100);
+  TriggerHitVector hits;
+  hits.push_back(TriggerHit(0,1,1,1));
+  hits.push_back(TriggerHit(10,2,1,1));
+  hits.push_back(TriggerHit(20,3,1,1));
+  hits.push_back(TriggerHit(20,3,1,1));
+  hits.push_back(TriggerHit(1000,4,1,1));
+
+  TriggerHitIterPairVectorPtr timeWindows = timeWindowClass.SlidingTimeWindows(hits);
+  ENSURE(timeWindows->size() == 1);
+  ENSURE(timeWindows->at(0).first == hits.begin());
+  ENSURE(timeWindows->at(0).second == hits.begin() + 3);
+}
@@ -0,0 +1,103 @@
+#include <I3Test.h>
+
+#include <vector>
+#include <boost/foreach.hpp>
+#include "trigger-sim/algorithms/TriggerHitCache.h"
+#include "trigger-sim/algorithms/TriggerService.h"
+#include "trigger-sim/utilities/DOMSetFunctions.h"
+#include <dataclasses/physics/I3DOMLaunch.h>
+#include <dataclasses/physics/I3RecoPulse.h>
+#include <phys-services/I3GSLRandomService.h>
+
+TEST_GROUP(TriggerHitCacheTests);
+
+namespace TriggerHitCacheTests{
+  // A service that only collects its hits
+  class HitCollector : public TriggerService
+  {
+  public:
+    HitCollector(int domSet, I3MapKeyVectorIntConstPtr domSets) : TriggerService(domSet, domSets) {}
+    void Trigger() {}
+    const TriggerHitVector& GetHits() const { return *hits_; }
+  };
+
+  OMKey RandomDOM(I3GSLRandomService& rand){
+    return OMKey(1 + rand.Integer(86), 1 + rand.Integer(64));
+  }
+
+  // hits compare on time, DOM and LC bit
+  bool SameHits(const TriggerHitVector& a, const TriggerHitVector& b){
+    if(a.size() != b.size()) return false;
+    for(size_t i = 0; i < a.size(); i++)
+      if(!(a[i] == b[i]) || a[i].lc != b[i].lc) return false;
+    return true;
+  }
+}
+
+TEST(SameHitsAsFromTheMaps){
+  I3GSLRandomService rand(31415);
+  I3MapKeyVectorIntConstPtr customDomSets(DOMSetFunctions::GetDefaultDOMSets());
+  DOMSetTableConstPtr table(new DOMSetTable(customDomSets));
+
+  for(int trial = 0; trial < 20; trial++){
+    // integer times, so that there are hits with equal times
+    I3DOMLaunchSeriesMapPtr launches(new I3DOMLaunchSeriesMap());
+    I3RecoPulseSeriesMapPtr pulses(new I3RecoPulseSeriesMap());
+    int nhits = rand.Integer(500);
+    for(int i = 0; i < nhits; i++){
+      I3DOMLaunch launch;
+      launch.SetStartTime(floor(rand.Uniform(0, 1000)));
+      launch.SetLCBit(rand.Uniform(0, 1) < 0.5);
+      (*launches)[TriggerHitCacheTests::RandomDOM(rand)].push_back(launch);
+
+      I3RecoPulse pulse;
+      pulse.SetTime(floor(rand.Uniform(0, 1000)));
+      pulse.SetFlags(rand.Uniform(0, 1) < 0.5 ? I3RecoPulse::LC : 0);
+      (*pulses)[TriggerHitCacheTests::RandomDOM(rand)].push_back(pulse);
+    }
+    // every launch, in the order of the map, like the python bindings get them
+    TriggerHitVector launchHits;
+    BOOST_FOREACH(const I3DOMLaunchSeriesMap::value_type& entry, *launches){
+      BOOST_FOREACH(const I3DOMLaunch& launch, entry.second)
+        launchHits.push_back(TriggerHit(launch.GetStartTime(), entry.first.GetOM(),
+                                        entry.first.GetString(), launch.GetLCBit()));
+    }
+
+    I3DOMLaunchSeriesMapConstPtr noLaunches(new I3DOMLaunchSeriesMap());
+    I3RecoPulseSeriesMapConstPtr noPulses(new I3RecoPulseSeriesMap());
+
+    // with the DOMSets from the frame and their table, and with the default DOM sets
+    for(int compiled = 0; compiled < 2; compiled++){
+      I3MapKeyVectorIntConstPtr domSets = compiled ? customDomSets : I3MapKeyVectorIntConstPtr();
+      DOMSetTableConstPtr domSetTable = compiled ? table : DOMSetTableConstPtr();
+
+      TriggerHitCache launchCache;
+      launchCache.Fill(launches, domSetTable);
+      TriggerHitCache pulseCache;
+      pulseCache.Fill(pulses, domSetTable);
+
+      BOOST_FOREACH(unsigned domSet, DOMSetFunctions::DOMSETS){
+        for(int useSLC = 0; useSLC < 2; useSLC++){
+          TriggerHitCacheTests::HitCollector fromMaps(domSet, domSets);
+          TriggerHitCacheTests::HitCollector fromCache(domSet, domSets);
+          fromCache.SetDOMSetTable(domSetTable);
+
+          fromMaps.FillHits(launches, noPulses, useSLC);
+          fromCache.FillHits(launchCache, useSLC);
+          ENSURE(TriggerHitCacheTests::SameHits(fromMaps.GetHits(), fromCache.GetHits()),
+                 "Launch hits differ");
+
+          TriggerHitCacheTests::HitCollector fromHits(domSet, domSets);
+          fromHits.FillHits(launchHits.data(), launchHits.size(), useSLC);
+          ENSURE(TriggerHitCacheTests::SameHits(fromMaps.GetHits(), fromHits.GetHits()),
+                 "Hits given directly differ");
+
+          fromMaps.FillHits(noLaunches, pulses, useSLC);
+          fromCache.FillHits(pulseCache, useSLC);
+          ENSURE(TriggerHitCacheTests::SameHits(fromMaps.GetHits(), fromCache.GetHits()),
+                 "Pulse hits differ");
+        }
+      }
+    }
+  }
+}
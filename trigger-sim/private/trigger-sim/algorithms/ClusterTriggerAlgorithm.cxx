@@ -11,17 +11,25 @@
 
 #include <trigger-sim/algorithms/ClusterTriggerAlgorithm.h>
 #include <trigger-sim/algorithms/TimeWindow.h>
+#include <algorithm>
 #include <boost/foreach.hpp>
 #include <boost/assign/std/vector.hpp>
 
 using namespace boost::assign;
 
+namespace {
+  // Highest position of a coherence site on a string
+  const int MAX_POSITION = 60;
+}
+
 ClusterTriggerAlgorithm::ClusterTriggerAlgorithm(double triggerWindow, unsigned int triggerThreshold,
 						 unsigned int coherenceLength,
                                                  int domSet, I3MapKeyVectorIntConstPtr customDomSets):
   TriggerService(domSet, customDomSets),
   triggerWindow_(triggerWindow),
-  triggerThreshold_(triggerThreshold)
+  triggerThreshold_(triggerThreshold),
+  queueStart_(0),
+  queueEnd_(0)
 {
 
   coherenceUp_   = (coherenceLength - 1) / 2;
@@ -32,8 +40,6 @@ ClusterTriggerAlgorithm::ClusterTriggerAlgorithm(double triggerWindow, unsigned
   log_debug("  TriggerThreshold = %d", triggerThreshold_);
   log_debug("  CoherenceUp = %d", coherenceUp_);
   log_debug("  CoherenceDown = %d", coherenceDown_);
-
-  hitQueue_.clear();
 }
 
 void ClusterTriggerAlgorithm::Trigger()
@@ -47,35 +53,31 @@ void ClusterTriggerAlgorithm::Trigger()
   triggers_.clear();
   triggerCount_ = 0;
 
-  hitQueue_.clear();
+  IndexStrings();
+  queueStart_ = 0;
+  queueEnd_ = 0;
 
   // Iterate over all the hits
-  TriggerHitVector::const_iterator nextHit;
-  for (nextHit = hits_->begin(); nextHit != hits_->end(); nextHit++) {
-    double nextTime = nextHit->time;
+  for (; queueEnd_ < hits_->size(); queueEnd_++) {
+    double nextTime = (*hits_)[queueEnd_].time;
     log_debug("  Processing hit at time %f", nextTime);
 
     // Check for an empty queue
-    if (hitQueue_.empty()) {  
+    if (queueStart_ == queueEnd_) {  
       log_debug("Queue is empty, adding new hit");
-      hitQueue_.push_back(*nextHit);
       continue;  
     }      
 
-    // Check time window
- //   double startTime = hitQueue_.front().time;
- //   double stopTime = startTime + triggerWindow_;
- //   log_debug("    Current time window = (%f, %f)", startTime, stopTime); // Commented these 3 lines out, no use for them anymore
-
     // Slide the window until next time is in window
-    while ( (nextTime - hitQueue_.front().time)  > triggerWindow_) {  // Changed here to DAQ analogue - Thorsten
+    while ( (nextTime - (*hits_)[queueStart_].time)  > triggerWindow_) {  // Changed here to DAQ analogue - Thorsten
 
       log_debug("    Hit is outside window, checking for trigger...");
 
-      bool timeTrigger = (hitQueue_.size() >= triggerThreshold_);
+      bool timeTrigger = (queueEnd_ - queueStart_ >= triggerThreshold_);
       log_debug("     TimeTrigger = %s", timeTrigger ? "T" : "F");
 
-      bool posTrigger = PosWindow();
+      TriggerHitVector triggerHits;
+      bool posTrigger = PosWindow(triggerHits);
 
       log_debug("     PosTrigger = %s", posTrigger ? "T" : "F");
 
@@ -85,24 +87,19 @@ void ClusterTriggerAlgorithm::Trigger()
 	// We have a trigger
 	log_debug("  We have a trigger!");
 
-	// Copy hits in hitQueue into the vector of vectors
-	TriggerHitVectorPtr triggerHits(new TriggerHitVector);
-	TriggerHitList::const_iterator queueIter;
-	for (queueIter = hitQueue_.begin(); queueIter != hitQueue_.end(); queueIter++)
-	  triggerHits->push_back(*queueIter);
-	triggers_.push_back(*triggerHits);
-	triggerCount_++;
+	// The pruned hits of the queue
+	AddTrigger(triggerHits);
 
-	hitQueue_.clear();
+	queueStart_ = queueEnd_;
 	break;
 
       } else {
 
 	// remove the head
 	log_debug("    No trigger, shift the queue");
-	if(hitQueue_.size() > 0) //////////////// CHANGE THORSTEN --- Here error occured before
+	if(queueStart_ < queueEnd_)
 	{
-		hitQueue_.pop_front();
+		queueStart_++;
 	}
 	else // if size  is 0 break!!!
 	{
@@ -114,17 +111,16 @@ void ClusterTriggerAlgorithm::Trigger()
 
     // Add nextHit to queue
     log_debug("    Hit is in window, adding it to queue");
-    hitQueue_.push_back(*nextHit);  
-
   }
 
   // After the last hit, check the queue again
   log_debug("    Last hit, checking for trigger...");
 
-  bool timeTrigger = (hitQueue_.size() >= triggerThreshold_);
+  bool timeTrigger = (queueEnd_ - queueStart_ >= triggerThreshold_);
   log_debug("     TimeTrigger = %s", timeTrigger ? "T" : "F");
       
-  bool posTrigger = PosWindow();
+  TriggerHitVector triggerHits;
+  bool posTrigger = PosWindow(triggerHits);
 
   log_debug("     PosTrigger = %s", posTrigger ? "T" : "F");
 
@@ -133,138 +129,97 @@ void ClusterTriggerAlgorithm::Trigger()
 
     // We have a trigger
     log_debug("  We have a trigger!");
-    // Copy hits in hitQueue into the vector of vectors
-    TriggerHitVectorPtr triggerHits(new TriggerHitVector);
-    TriggerHitList::const_iterator queueIter;
-    for (queueIter = hitQueue_.begin(); queueIter != hitQueue_.end(); queueIter++)
-      triggerHits->push_back(*queueIter);
-    triggers_.push_back(*triggerHits);
-    triggerCount_++;
+    AddTrigger(triggerHits);
   }
   
 }
 
-bool ClusterTriggerAlgorithm::PosWindow()
+void ClusterTriggerAlgorithm::IndexStrings()
+{
+  // Number the strings of this frame 0, 1, ..., so the coherence counts
+  // fit in one array whatever the string numbers are.
+  std::vector<int> strings;
+  strings.reserve(hits_->size());
+  BOOST_FOREACH(const TriggerHit& hit, *hits_)
+    strings.push_back(hit.string);
+  std::sort(strings.begin(), strings.end());
+  strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+  stringIndex_.resize(hits_->size());
+  for (size_t i = 0; i < hits_->size(); i++)
+    stringIndex_[i] = std::lower_bound(strings.begin(), strings.end(), (*hits_)[i].string) - strings.begin();
+
+  siteCounts_.assign(strings.size()*(MAX_POSITION + 1), 0);
+  touchedSites_.clear();
+}
+
+bool ClusterTriggerAlgorithm::PosWindow(TriggerHitVector& triggerHits)
 {
   log_debug("    Checking position window trigger...");
+  windowCount_++;
 
   bool trigger = false;
 
-  std::map<int, unsigned> coherenceMap;
-
   // Iterate over the hit queue
-  TriggerHitList::iterator centralHit;
-  for (centralHit = hitQueue_.begin(); centralHit != hitQueue_.end(); centralHit++) {
+  for (size_t centralHit = queueStart_; centralHit < queueEnd_; centralHit++) {
 
     // Get the lower and upper bounds
-    unsigned int centralPos = centralHit->pos;
-    int centralString = centralHit->string;
+    unsigned int centralPos = (*hits_)[centralHit].pos;
     int lower = centralPos - coherenceUp_;
     if (lower < 1) lower = 1;
     int upper = centralPos + coherenceDown_;
-    if (upper > 60) upper = 60;
+    if (upper > MAX_POSITION) upper = MAX_POSITION;
 
-    log_debug("      Central hit at (%d, %d)   Pos window = (%d, %d)", centralString, centralPos, lower, upper);
+    log_debug("      Central hit at (%d, %d)   Pos window = (%d, %d)",
+              (*hits_)[centralHit].string, centralPos, lower, upper);
 
     // Iterate over the doms in the coherence window
+    size_t stringSites = stringIndex_[centralHit]*(MAX_POSITION + 1);
     for (int dom = lower; dom <= upper; dom++) {
 
-      // create the key
-      int key = GetHash(centralString, dom);
-
       // Update counter for this dom
-      unsigned counter = 0;
-      std::map<int, unsigned>::const_iterator iter = coherenceMap.find(key);
-      if (iter != coherenceMap.end()) counter = iter->second;
+      unsigned int& counter = siteCounts_[stringSites + dom];
+      if (counter == 0) touchedSites_.push_back(stringSites + dom);
       counter += 1;
-      coherenceMap[key] = counter;
 
-      log_debug("        Dom (%d, %d) now has count %d", centralString, dom, counter);
+      log_debug("        Dom (%d, %d) now has count %d", (*hits_)[centralHit].string, dom, counter);
 
       if (counter >= triggerThreshold_) trigger = true;
     }
     
   }
 
-  if (!trigger) return false;
-
-  // Now remove sites from the map that are below threshold
-  std::map<int, unsigned>::iterator mapIter;
-  for (mapIter = coherenceMap.begin(); mapIter != coherenceMap.end();) {
-    if (mapIter->second < triggerThreshold_) {
-      // must increment iterator before erasing it
-      coherenceMap.erase(mapIter++);
-    } else {
-      ++mapIter;
-    }
-  }
-
-  log_debug("Pruned coherence map:");
-  for (mapIter = coherenceMap.begin(); mapIter != coherenceMap.end(); mapIter++) {
-    int string __attribute__((unused)) = GetString(mapIter->first);
-    int pos __attribute__((unused)) = GetPosition(mapIter->first);
-    log_debug("  Count(%d,%d) = %d", string, pos, mapIter->second);
-  }
-
-  // Now remove hits from the queue that are not at valid sites in the map
-  log_debug("Pruning the hit queue:");
-  TriggerHitList::iterator hitIter;
-  for (hitIter = hitQueue_.begin(); hitIter != hitQueue_.end();) { // CHANGE THORSTEN remove hitIter++ from the loop start to the end
-
-    // check hit
-    unsigned int hitPos = hitIter->pos;
-    int hitString = hitIter->string;
-
-    log_debug("  Hit at (%d,%d)", hitString, hitPos);
-
-    bool near = false;
-
-    // check the map
-    std::map<int, unsigned>::iterator mapIter;
-    for (mapIter = coherenceMap.begin(); mapIter != coherenceMap.end(); mapIter++) {
-      int string = GetString(mapIter->first);
-      int pos = GetPosition(mapIter->first);
-
-      int delta = hitPos - pos;
+  if (trigger) {
+    // Keep the hits of the queue that are near a site over threshold,
+    // i.e. that have one within coherenceDown_ below and coherenceUp_
+    // above their position.  Only the counted sites are sites.
+    log_debug("Pruning the hit queue:");
+    for (size_t hit = queueStart_; hit < queueEnd_; hit++) {
+      long long hitPos = (*hits_)[hit].pos;
+      long long lower = std::max(hitPos - static_cast<long long>(coherenceDown_), 1LL);
+      long long upper = std::min(hitPos + static_cast<long long>(coherenceUp_),
+                                 static_cast<long long>(MAX_POSITION));
+
+      size_t stringSites = stringIndex_[hit]*(MAX_POSITION + 1);
+      bool near = false;
+      for (long long pos = lower; pos <= upper && !near; pos++) {
+        unsigned int counter = siteCounts_[stringSites + pos];
+        near = counter > 0 && counter >= triggerThreshold_;
+      }
 
-      bool sameString = (hitString == string);
-      bool closePos = false;
-      if (delta < 0) 
-	closePos = (-delta <= static_cast<int>(coherenceUp_));
-      else if (delta > 0)
-	closePos = (delta <= static_cast<int>(coherenceDown_));
-      else
-	closePos = true;
-      
-      if (sameString && closePos) {
-	near = true;
-	log_debug("    is near site (%d,%d)", string, pos);
+      if (near) {
+        log_debug("  Hit at (%d,%d) is near a site, keep it", (*hits_)[hit].string, (*hits_)[hit].pos);
+        triggerHits.push_back((*hits_)[hit]);
       } else {
-	log_debug("    is NOT near site (%d,%d)", string, pos);
+        log_debug("  Hit at (%d,%d) is not near a site, deleting from queue", (*hits_)[hit].string, (*hits_)[hit].pos);
       }
     }
-    
-    if (!near) {
-      log_debug("  Hit is not near a site, deleting from queue");
-      hitIter = hitQueue_.erase(hitIter);
-    } else {
-      hitIter++;
-      log_debug("  Hit is near a site, keep it");
-    }
-    
   }
-  
-  return true;
-}
 
-int ClusterTriggerAlgorithm::GetHash(int string, unsigned int position) {
-  return string*100 + position;
-}
-
-int ClusterTriggerAlgorithm::GetString(int hash) {
-  return hash/100;
-}
+  // Reset the counts for the next window
+  BOOST_FOREACH(size_t site, touchedSites_)
+    siteCounts_[site] = 0;
+  touchedSites_.clear();
 
-unsigned int ClusterTriggerAlgorithm::GetPosition(int hash) {
-  return hash - 100*GetString(hash);
+  return trigger;
 }
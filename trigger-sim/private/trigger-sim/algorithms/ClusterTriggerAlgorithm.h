@@ -12,6 +12,7 @@
 #ifndef CLUSTER_TRIGGER_ALGORITHM_H
 #define CLUSTER_TRIGGER_ALGORITHM_H
 
+#include <vector>
 #include "icetray/I3Logging.h"
 #include "trigger-sim/algorithms/TriggerService.h"
 #include "trigger-sim/algorithms/TriggerHit.h"
@@ -27,10 +28,6 @@ class ClusterTriggerAlgorithm : public TriggerService
 
   void Trigger();
 
-  int GetHash(int string, unsigned int position);
-  int GetString(int hash);
-  unsigned int GetPosition(int hash);
-
  private:
 
   double triggerWindow_;
@@ -38,9 +35,20 @@ class ClusterTriggerAlgorithm : public TriggerService
   unsigned int coherenceUp_;
   unsigned int coherenceDown_;
 
-  TriggerHitList hitQueue_;
+  // The hit queue is the range [queueStart_, queueEnd_) of hits_.  Hits
+  // only leave it at the front until a trigger, so it never needs a copy.
+  size_t queueStart_;
+  size_t queueEnd_;
+
+  // Dense string number of each hit
+  std::vector<unsigned int> stringIndex_;
+  // Coherence count of each (dense string, position) site, and the sites
+  // with a non-zero count
+  std::vector<unsigned int> siteCounts_;
+  std::vector<size_t> touchedSites_;
 
-  bool PosWindow();
+  void IndexStrings();
+  bool PosWindow(TriggerHitVector& triggerHits);
 
   SET_LOGGER("ClusterTriggerAlgorithm");
 };
@@ -0,0 +1,190 @@
+#include "trigger-sim/algorithms/CylinderHitQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+  // Limit on the number of grid cells along x and y, for tiny radii
+  const int MAX_CELLS = 256;
+}
+
+const size_t CylinderHitQueue::NONE;
+
+CylinderHitQueue::CylinderHitQueue(double radius, double height) :
+  radius_(radius),
+  height_(height),
+  positions_(NULL),
+  mask_(0),
+  head_(0),
+  size_(0),
+  unknown_(0),
+  minX_(0),
+  minY_(0),
+  cellSize_(1),
+  nCellsX_(1),
+  nCellsY_(1)
+{
+}
+
+void CylinderHitQueue::Reset(const DOMPositionTable& positions)
+{
+  positions_ = &positions;
+
+  double maxX = -std::numeric_limits<double>::infinity();
+  double maxY = -std::numeric_limits<double>::infinity();
+  minX_ = std::numeric_limits<double>::infinity();
+  minY_ = std::numeric_limits<double>::infinity();
+  for (size_t dom = 0; dom < positions.GetNumberOfDOMs(); dom++) {
+    minX_ = std::min(minX_, positions.GetX(dom));
+    minY_ = std::min(minY_, positions.GetY(dom));
+    maxX = std::max(maxX, positions.GetX(dom));
+    maxY = std::max(maxY, positions.GetY(dom));
+  }
+  if (positions.GetNumberOfDOMs() == 0)
+    minX_ = minY_ = maxX = maxY = 0;
+
+  // Cells slightly wider than the radius, so rounding in the cell
+  // numbers can't push two hits within the radius two cells apart.
+  // Without a positive radius no hit is near another one, and any cell
+  // size does.
+  cellSize_ = radius_ > 0 ? radius_*(1 + 1e-9) : 1.;
+  cellSize_ = std::max(cellSize_, std::max(maxX - minX_, maxY - minY_)/MAX_CELLS);
+  nCellsX_ = static_cast<int>(std::floor((maxX - minX_)/cellSize_)) + 1;
+  nCellsY_ = static_cast<int>(std::floor((maxY - minY_)/cellSize_)) + 1;
+
+  cellHead_.assign(static_cast<size_t>(nCellsX_)*nCellsY_, NONE);
+  cellTail_.assign(cellHead_.size(), NONE);
+  head_ = 0;
+  size_ = 0;
+  unknown_ = 0;
+
+  log_debug("CylinderHitQueue: %d x %d cells of %g m", nCellsX_, nCellsY_, cellSize_);
+}
+
+void CylinderHitQueue::Grow()
+{
+  std::vector<QueuedHit> ring(std::max<size_t>(16, 2*ring_.size()));
+  size_t mask = ring.size() - 1;
+  for (size_t seq = head_; seq != head_ + size_; seq++)
+    ring[seq & mask] = At(seq);
+  ring_.swap(ring);
+  mask_ = mask;
+}
+
+void CylinderHitQueue::PushBack(const TriggerHit& hit)
+{
+  if (!positions_)
+    log_fatal("CylinderHitQueue::PushBack called before Reset");
+  if (size_ == ring_.size())
+    Grow();
+
+  size_t seq = head_ + size_;
+  QueuedHit& queued = At(seq);
+  queued.hit = hit;
+  queued.next = NONE;
+  queued.cell = -1;
+
+  int index = positions_->GetIndex(hit.string, hit.pos);
+  if (index < 0) {
+    unknown_++;
+  } else {
+    queued.x = positions_->GetX(index);
+    queued.y = positions_->GetY(index);
+    queued.z = positions_->GetZ(index);
+
+    int cx = std::min(std::max(static_cast<int>((queued.x - minX_)/cellSize_), 0), nCellsX_ - 1);
+    int cy = std::min(std::max(static_cast<int>((queued.y - minY_)/cellSize_), 0), nCellsY_ - 1);
+    queued.cell = cy*nCellsX_ + cx;
+
+    if (cellTail_[queued.cell] == NONE)
+      cellHead_[queued.cell] = seq;
+    else
+      At(cellTail_[queued.cell]).next = seq;
+    cellTail_[queued.cell] = seq;
+  }
+  size_++;
+}
+
+void CylinderHitQueue::PopFront()
+{
+  if (size_ == 0)
+    return;
+
+  // The oldest hit of the queue is also the oldest of its cell
+  const QueuedHit& front = At(head_);
+  if (front.cell < 0) {
+    unknown_--;
+  } else {
+    cellHead_[front.cell] = front.next;
+    if (front.next == NONE)
+      cellTail_[front.cell] = NONE;
+  }
+  head_++;
+  size_--;
+}
+
+void CylinderHitQueue::Clear()
+{
+  while (size_ > 0)
+    PopFront();
+}
+
+void CylinderHitQueue::CopyHits(TriggerHitVector& hits) const
+{
+  hits.reserve(hits.size() + size_);
+  for (size_t seq = head_; seq != head_ + size_; seq++)
+    hits.push_back(At(seq).hit);
+}
+
+bool CylinderHitQueue::InVolume(const QueuedHit& center, const QueuedHit& hit) const
+{
+  double dx = hit.x - center.x;
+  double dy = hit.y - center.y;
+  double dz = fabs(hit.z - center.z);
+  double dr = sqrt(dx*dx + dy*dy);
+  return dr < radius_ && dz < (0.5*height_);
+}
+
+bool CylinderHitQueue::FindVolume(unsigned int threshold)
+{
+  if (size_ == 0)
+    return false;
+  if (unknown_ > 0)
+    log_fatal("  Warning, OMKey not part of geometry"); // trigger algorithm  does not work when the geometry entry is not there
+
+  for (size_t seq = head_; seq != head_ + size_; seq++) {
+    const QueuedHit& center = At(seq);
+    int cx = center.cell % nCellsX_;
+    int cy = center.cell / nCellsX_;
+
+    members_.clear();
+    for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, nCellsY_ - 1); y++) {
+      for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, nCellsX_ - 1); x++) {
+        for (size_t other = cellHead_[y*nCellsX_ + x]; other != NONE; other = At(other).next) {
+          if (other != seq && InVolume(center, At(other)))
+            members_.push_back(other);
+        }
+      }
+    }
+    log_debug("    There are %zd hits in this volume", members_.size() + 1);
+
+    if (members_.size() + 1 >= threshold) {
+      log_debug("    Found a volume over threshold (%d)", threshold);
+
+      // The central hit, then the others in queue order, sorted by time
+      std::sort(members_.begin(), members_.end());
+      TriggerHitVector volume;
+      volume.reserve(members_.size() + 1);
+      volume.push_back(center.hit);
+      for (std::vector<size_t>::const_iterator iter = members_.begin(); iter != members_.end(); iter++)
+        volume.push_back(At(*iter).hit);
+      std::stable_sort(volume.begin(), volume.end());
+
+      Clear();
+      for (TriggerHitVector::const_iterator iter = volume.begin(); iter != volume.end(); iter++)
+        PushBack(*iter);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,105 @@
+#ifndef CYLINDER_HIT_QUEUE_H
+#define CYLINDER_HIT_QUEUE_H
+
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+
+/**
+ * @brief Time ordered queue of the hits in the cylinder trigger window.
+ *
+ * The hits are kept in a ring buffer together with the position of their
+ * DOM, which is looked up once when the hit enters.  Each hit is also
+ * put in a cell of a 2-D (x, y) grid whose cells are at least as wide as
+ * the cylinder radius, so the hits within the radius of a hit are all in
+ * its own or in the 8 neighbouring cells.  The hits of a cell are chained
+ * in queue order, so the queue can only grow at the back and shrink at
+ * the front.
+ */
+class CylinderHitQueue
+{
+ public:
+  CylinderHitQueue(double radius, double height);
+
+  ~CylinderHitQueue() = default;
+
+  /**
+   * Empty the queue and lay out the grid over the DOMs of the table.  The
+   * table has to stay alive while the queue is in use.
+   */
+  void Reset(const DOMPositionTable& positions);
+
+  bool Empty() const { return size_ == 0; }
+  size_t Size() const { return size_; }
+  const TriggerHit& Front() const { return At(head_).hit; }
+
+  void PushBack(const TriggerHit& hit);
+  void PopFront();
+  void Clear();
+
+  /**
+   * Append the hits of the queue, in queue order.
+   */
+  void CopyHits(TriggerHitVector& hits) const;
+
+  /**
+   * Look for the first hit, in queue order, with at least threshold hits
+   * (itself included) within the cylinder around it.  If there is one,
+   * the queue is replaced by these hits in time order and true is
+   * returned.  Every hit of the queue has to be in the position table.
+   */
+  bool FindVolume(unsigned int threshold);
+
+ private:
+
+  CylinderHitQueue();
+
+  static const size_t NONE = static_cast<size_t>(-1);
+
+  struct QueuedHit
+  {
+    TriggerHit hit;
+    double x;
+    double y;
+    double z;
+    // grid cell, -1 if the DOM is not in the position table
+    int cell;
+    // sequence number of the next hit in the same cell
+    size_t next;
+  };
+
+  // Hits are numbered in the order they enter, and hit s is kept in
+  // ring_[s & mask_]
+  QueuedHit& At(size_t seq) { return ring_[seq & mask_]; }
+  const QueuedHit& At(size_t seq) const { return ring_[seq & mask_]; }
+  void Grow();
+
+  bool InVolume(const QueuedHit& center, const QueuedHit& hit) const;
+
+  double radius_;
+  double height_;
+  const DOMPositionTable* positions_;
+
+  std::vector<QueuedHit> ring_;
+  size_t mask_;
+  size_t head_;
+  size_t size_;
+  // number of queued hits that have no position
+  size_t unknown_;
+
+  double minX_;
+  double minY_;
+  double cellSize_;
+  int nCellsX_;
+  int nCellsY_;
+  // first and last hit of each cell, NONE if the cell is empty
+  std::vector<size_t> cellHead_;
+  std::vector<size_t> cellTail_;
+
+  std::vector<size_t> members_;
+
+  SET_LOGGER("CylinderHitQueue");
+};
+
+#endif // CYLINDER_HIT_QUEUE_H
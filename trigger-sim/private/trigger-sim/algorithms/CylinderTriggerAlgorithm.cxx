@@ -14,14 +14,22 @@
 
 CylinderTriggerAlgorithm::CylinderTriggerAlgorithm(double triggerWindow, unsigned int triggerThreshold, unsigned int simpleMultiplicity,
                                                    I3GeometryConstPtr Geometry, double Radius , double Height,
-                                                   int domSet, I3MapKeyVectorIntConstPtr customDomSets): 
+                                                   int domSet, I3MapKeyVectorIntConstPtr customDomSets,
+                                                   DOMPositionTableConstPtr positions): 
   TriggerService(domSet, customDomSets),
   triggerWindow_(triggerWindow),
   triggerThreshold_(triggerThreshold),
   simpleMultiplicity_(simpleMultiplicity),
   Radius_(Radius),
-  Height_(Height)
+  Height_(Height),
+  Geometry_(Geometry),
+  positions_(positions),
+  hitQueue_(Radius, Height)
 {
+  if (!positions_ && Geometry_)
+    positions_ = DOMPositionTablePtr(new DOMPositionTable(*Geometry_));
+  if (!positions_)
+    log_fatal("CylinderTriggerAlgorithm needs either a geometry or a DOM position table.");
 
   log_debug("CylinderTriggerAlgorithm configuration:");
   log_debug("  TriggerWindow = %f", triggerWindow_);
@@ -29,8 +37,7 @@ CylinderTriggerAlgorithm::CylinderTriggerAlgorithm(double triggerWindow, unsigne
   log_debug("  Radius = %g", Radius_);
   log_debug("  Height = %g", Height_);
 
-  hitQueue_.clear();
-  Geometry_ = Geometry;
+  hitQueue_.Reset(*positions_);
 }
 
 void CylinderTriggerAlgorithm::Trigger()
@@ -43,7 +50,7 @@ void CylinderTriggerAlgorithm::Trigger()
    *------------------------------------------------------------*/
   triggers_.clear();
   triggerCount_ = 0;
-  hitQueue_.clear();
+  hitQueue_.Clear();
 
   // Iterate over all the hits
   TriggerHitVector::const_iterator nextHit;
@@ -52,22 +59,22 @@ void CylinderTriggerAlgorithm::Trigger()
     log_debug("  Processing hit at time %f", nextTime);
 
     // Check for an empty queue
-    if (hitQueue_.empty()) {  
+    if (hitQueue_.Empty()) {  
       log_debug("Queue is empty, adding new hit");
-      hitQueue_.push_back(*nextHit);
+      hitQueue_.PushBack(*nextHit);
       continue;  
     }      
 
     // Check time window
-    double startTime = hitQueue_.front().time;
+    double startTime = hitQueue_.Front().time;
     double stopTime __attribute__((unused)) = startTime + triggerWindow_;
     log_debug("    Current time window = (%f, %f)", startTime, stopTime);
 
     // Slide the window until next time is in window
-    while ((nextTime - hitQueue_.front().time)  > triggerWindow_) {
+    while ((nextTime - hitQueue_.Front().time)  > triggerWindow_) {
 
       log_debug("    Hit is outside window, checking for trigger...");
-      bool timeTrigger = (hitQueue_.size() >= triggerThreshold_);
+      bool timeTrigger = (hitQueue_.Size() >= triggerThreshold_);
       log_debug("     TimeTrigger = %s", timeTrigger ? "T" : "F");
 
       bool posTrigger = PosWindow();
@@ -78,23 +85,20 @@ void CylinderTriggerAlgorithm::Trigger()
 	log_debug("  We have a trigger!");
 
 	// Copy hits in hitQueue into the vector of vectors
-	if(hitQueue_.size() > 0)
+	if(hitQueue_.Size() > 0)
 	{
-	  TriggerHitVectorPtr triggerHits(new TriggerHitVector);
-	  TriggerHitList::const_iterator queueIter;
-	  for (queueIter = hitQueue_.begin(); queueIter != hitQueue_.end(); queueIter++)
-	    triggerHits->push_back(*queueIter);
-	  triggers_.push_back(*triggerHits);
-	  triggerCount_++;
+	  TriggerHitVector triggerHits;
+	  hitQueue_.CopyHits(triggerHits);
+	  AddTrigger(triggerHits);
       	}
-	hitQueue_.clear();
+	hitQueue_.Clear();
 	break;
 
       } else {
 	// remove the head
 	log_debug("    No trigger, shift the queue");
-	if(hitQueue_.size() > 0)
-          hitQueue_.pop_front();
+	if(hitQueue_.Size() > 0)
+          hitQueue_.PopFront();
 	else
           break;
       }
@@ -102,12 +106,12 @@ void CylinderTriggerAlgorithm::Trigger()
 
     // Add nextHit to queue
     log_debug("    Hit is in window, adding it to queue");
-    hitQueue_.push_back(*nextHit);  
+    hitQueue_.PushBack(*nextHit);  
   }
 
   // After the last hit, check the queue again
   log_debug("    Last hit, checking for trigger...");
-  bool timeTrigger = (hitQueue_.size() >= triggerThreshold_);
+  bool timeTrigger = (hitQueue_.Size() >= triggerThreshold_);
   log_debug("     TimeTrigger = %s", timeTrigger ? "T" : "F");
       
   bool posTrigger = PosWindow();
@@ -117,118 +121,24 @@ void CylinderTriggerAlgorithm::Trigger()
   if ( timeTrigger && posTrigger ) {
     log_debug("  We have a trigger!");
     // Copy hits in hitQueue into the vector of vectors
-    TriggerHitVectorPtr triggerHits(new TriggerHitVector);
-    TriggerHitList::const_iterator queueIter;
-    for (queueIter = hitQueue_.begin(); queueIter != hitQueue_.end(); queueIter++)
-      triggerHits->push_back(*queueIter);
-    triggers_.push_back(*triggerHits);
-    triggerCount_++;
+    TriggerHitVector triggerHits;
+    hitQueue_.CopyHits(triggerHits);
+    AddTrigger(triggerHits);
   }
 }
 
 bool CylinderTriggerAlgorithm::PosWindow()
 {
   log_debug("    Checking position window trigger...");
+  windowCount_++;
 
-  double x1; 
-  double y1; 
-  double z1;
-  double x2; 
-  double y2; 
-  double z2;
-  double dx;
-  double dy;
-  double dz;
-  double dx2;
-  double dy2;
-  double dr2;
-  double dr;
-  
-  I3OMGeoMap::const_iterator geo_iter; 
-  TriggerHitList tempHits;
-
-  if(hitQueue_.size() >= simpleMultiplicity_)
+  if(hitQueue_.Size() >= simpleMultiplicity_)
   {
     return true;
   }
-  TriggerHitList::iterator hit1;
-  for (hit1 = hitQueue_.begin(); hit1 != hitQueue_.end(); hit1++) {
-
-    // the hit string and position
-    int hitString = hit1->string;
-    unsigned int hitPos = hit1->pos;
-    log_debug("      Central hit at (%d, %d) - time: %f", hitString, hitPos, hit1->time);
-    
-    OMKey omkey(hitString, hitPos);
-
-    /// find position ///
-    geo_iter = Geometry_->omgeo.find(omkey);
-    if(geo_iter == Geometry_->omgeo.end()){
-      log_fatal("  Warning, OMKey not part of geometry"); // trigger algorithm  does not work when the geometry entry is not there
-      continue;
-    }
-    x1 = geo_iter->second.position.GetX();
-    y1 = geo_iter->second.position.GetY();
-    z1 = geo_iter->second.position.GetZ();
-   
-    tempHits.clear();
-    tempHits.push_back(*hit1);
-
-    TriggerHitList::iterator hit2;
-    for (hit2 = hitQueue_.begin(); hit2 != hitQueue_.end(); hit2++) {
-      if (hit2 == hit1) continue;
-
-      // see if this hit is in the volume
-      unsigned int thisOM = hit2->pos;
-      int thisString = hit2->string;
-      OMKey thisKey(thisString, thisOM);
-      
-        /// find position of other DOMs///
-      geo_iter = Geometry_->omgeo.find(thisKey);
-      if(geo_iter == Geometry_->omgeo.end()){
-	log_fatal("  Warning, OMKey not part of geometry");
-	
-	continue;
-      }
-      x2 = geo_iter->second.position.GetX();
-      y2 = geo_iter->second.position.GetY();
-      z2 = geo_iter->second.position.GetZ();
-      
-      dx = (x2-x1);
-      dy = (y2-y1);
-      dz = fabs(z2-z1); 
-     
-      dx2 = dx*dx;
-      dy2 = dy*dy;
-      
-      dr2 = dx2+dy2;
-      dr = sqrt(dr2);
-      
-      if (dr < Radius_ && dz < (0.5*Height_) ) {
-	tempHits.push_back(*hit2);
- 	log_debug("      Hit at ( R = %f, Z = %f) OM(%d, %d) is in the volume - t: %f", dr, dz, thisString, thisOM, hit2->time);
-      } else {
- 	log_debug("      Hit at ( R = %f, Z = %f) OM(%d, %d) is not in the volume - t: %f", dr, dz, thisString, thisOM, hit2->time);
-      }
-    }
-    log_debug("    There are %zd hits in this volume", tempHits.size());
-   
-    // how many hits do we have?
-    if (tempHits.size() >= triggerThreshold_)
-    {
-      log_debug("    Found a volume over threshold (%d)", triggerThreshold_);
-      
-      tempHits.sort();
-      hitQueue_.clear();
-      for (TriggerHitList::iterator iter = tempHits.begin(); iter != tempHits.end(); iter++) 
-      {
-      	hitQueue_.push_back(*iter);
-      }
-      
-      return true;  
-    }
-
-  }
 
-  return false;
+  // Each hit is the center of a cylinder in turn.  The queue only
+  // compares it with the hits of the neighbouring grid cells, and
+  // keeps just the hits of the first cylinder over threshold.
+  return hitQueue_.FindVolume(triggerThreshold_);
 }
@@ -15,6 +15,8 @@
 #include "icetray/I3Logging.h"
 #include "trigger-sim/algorithms/TriggerService.h"
 #include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/algorithms/CylinderHitQueue.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
 #include <dataclasses/geometry/I3Geometry.h>
 
 class CylinderTriggerAlgorithm : public TriggerService
@@ -23,7 +25,8 @@ class CylinderTriggerAlgorithm : public TriggerService
  public:
   CylinderTriggerAlgorithm(double triggerWindow, unsigned int triggerThreshold, unsigned int simpleMultiplicity,
                            I3GeometryConstPtr Geometry, double Radius , double Height,
-                           int domSet, I3MapKeyVectorIntConstPtr customDomSets);
+                           int domSet, I3MapKeyVectorIntConstPtr customDomSets,
+                           DOMPositionTableConstPtr positions = DOMPositionTableConstPtr());
   ~CylinderTriggerAlgorithm() {};
 
   void Trigger();
@@ -36,8 +39,9 @@ class CylinderTriggerAlgorithm : public TriggerService
   double Radius_; 
   double Height_; 
   I3GeometryConstPtr Geometry_;
+  DOMPositionTableConstPtr positions_;
   
-  TriggerHitList hitQueue_;
+  CylinderHitQueue hitQueue_;
 
   bool PosWindow();
 
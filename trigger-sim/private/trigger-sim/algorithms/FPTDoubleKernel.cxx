@@ -0,0 +1,323 @@
+#include "trigger-sim/algorithms/FPTDoubleKernel.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FPT_DOUBLE_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+  // Relative margin around the squared bounds.  The squared comparison and
+  // the original sqrt/divide formula differ by a few ulp at most, anything
+  // closer than this to a bound is re-evaluated with the original formula.
+  const double MARGIN = 1e-10;
+
+  // DOMs are compared as a single 64 bit key
+  inline int64_t DOMKey(int string, unsigned int om)
+  {
+    return (static_cast<int64_t>(string) << 32) | static_cast<int64_t>(om);
+  }
+
+  // velocity >= 0, so a non-positive lower bound only rejects velocity == 0
+  // (and NaN), which the zero checks in Classify take care of.
+  constexpr double SquaredLowerBound(double velocity_min)
+  {
+    return velocity_min > 0 ? velocity_min*velocity_min : (velocity_min == 0 ? 0. : -1.);
+  }
+
+  // Result of the squared comparison for one pair
+  enum PairClass { REJECT = 0, ACCEPT = 1, AMBIGUOUS = 2 };
+
+  // The velocity bounds of an FPTDoubleKernel and their squares in units
+  // of the squared distance scaled by 1e12
+  struct RuntimeBounds
+  {
+    double min;
+    double max;
+    double min2;
+    double max2;
+  };
+
+  // The same for an FPTFixedDoubleKernel, as compile time constants
+  template <long VELOCITY_MIN, long VELOCITY_MAX>
+  struct FixedBounds
+  {
+    static constexpr double min = VELOCITY_MIN;
+    static constexpr double max = VELOCITY_MAX;
+    static constexpr double min2 = SquaredLowerBound(VELOCITY_MIN);
+    static constexpr double max2 = max*max;
+  };
+
+  // The original velocity cut for a single pair
+  template <class Bounds>
+  bool IsDouble(const Bounds& bounds, double dx, double dy, double dz, double dt)
+  {
+    double distance = sqrt( pow(dx, 2) + pow(dy, 2) + pow(dz, 2) );
+    double time = fabs(dt);
+    //in km/s
+    double velocity = 1e6*distance/time;
+    return velocity > bounds.min && velocity < bounds.max;
+  }
+
+  template <class Bounds>
+  PairClass Classify(const Bounds& bounds, double d2, double dt)
+  {
+    // Non-short-circuit operators keep this free of hard to predict branches
+    double a = 1e12*d2;
+    double t2 = dt*dt;
+    double lo = bounds.min2*t2;
+    double hi = bounds.max2*t2;
+    bool valid = (dt != 0) & (a < std::numeric_limits<double>::infinity())
+      & (t2 < std::numeric_limits<double>::infinity());
+    bool accept = (a > lo*(1 + MARGIN)) & (a < hi*(1 - MARGIN));
+    bool reject = (a < lo*(1 - MARGIN)) | (a > hi*(1 + MARGIN));
+    if (!valid)
+      return AMBIGUOUS;
+    return accept ? ACCEPT : (reject ? REJECT : AMBIGUOUS);
+  }
+
+  // Test the pairs (anchor, k) for k in [first, last) and append every k
+  // that forms a Double to partners
+  template <class Bounds>
+  void ScanScalar(const Bounds& bounds, const FPTHitArrays& hits, int anchor, int first, int last,
+                  std::vector<int>& partners)
+  {
+    const double* x = hits.x.data();
+    const double* y = hits.y.data();
+    const double* z = hits.z.data();
+    const double* t = hits.t.data();
+    const int64_t* key = hits.key.data();
+
+    for (int k = first; k < last; k++) {
+      double dx = x[k] - x[anchor];
+      double dy = y[k] - y[anchor];
+      double dz = z[k] - z[anchor];
+      double dt = t[k] - t[anchor];
+      PairClass c = Classify(bounds, dx*dx + dy*dy + dz*dz, dt);
+      if (c == REJECT || key[k] == key[anchor]) continue;
+      if (c == ACCEPT || IsDouble(bounds, dx, dy, dz, dt))
+        partners.push_back(k);
+    }
+  }
+
+#ifdef FPT_DOUBLE_KERNEL_AVX2
+  template <class Bounds>
+  __attribute__((target("avx2")))
+  void ScanAVX2(const Bounds& bounds, const FPTHitArrays& hits, int anchor, int first, int last,
+                std::vector<int>& partners)
+  {
+    const __m256d scale = _mm256_set1_pd(1e12);
+    const __m256d vmin2 = _mm256_set1_pd(bounds.min2);
+    const __m256d vmax2 = _mm256_set1_pd(bounds.max2);
+    const __m256d plus_margin = _mm256_set1_pd(1 + MARGIN);
+    const __m256d minus_margin = _mm256_set1_pd(1 - MARGIN);
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d zero = _mm256_setzero_pd();
+
+    const double* x = hits.x.data();
+    const double* y = hits.y.data();
+    const double* z = hits.z.data();
+    const double* t = hits.t.data();
+    const int64_t* key = hits.key.data();
+
+    const __m256d xa = _mm256_set1_pd(x[anchor]);
+    const __m256d ya = _mm256_set1_pd(y[anchor]);
+    const __m256d za = _mm256_set1_pd(z[anchor]);
+    const __m256d ta = _mm256_set1_pd(t[anchor]);
+    const __m256i ka = _mm256_set1_epi64x(key[anchor]);
+
+    int k = first;
+    for (; k + 4 <= last; k += 4) {
+      __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + k), xa);
+      __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + k), ya);
+      __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + k), za);
+      __m256d dt = _mm256_sub_pd(_mm256_loadu_pd(t + k), ta);
+
+      __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                 _mm256_mul_pd(dz, dz));
+      __m256d a = _mm256_mul_pd(scale, d2);
+      __m256d t2 = _mm256_mul_pd(dt, dt);
+      __m256d lo = _mm256_mul_pd(vmin2, t2);
+      __m256d hi = _mm256_mul_pd(vmax2, t2);
+
+      // Lanes where the squared comparison can be trusted
+      __m256d valid = _mm256_and_pd(_mm256_cmp_pd(dt, zero, _CMP_NEQ_OQ),
+                                    _mm256_and_pd(_mm256_cmp_pd(a, inf, _CMP_LT_OQ),
+                                                  _mm256_cmp_pd(t2, inf, _CMP_LT_OQ)));
+      __m256d accept = _mm256_and_pd(_mm256_cmp_pd(a, _mm256_mul_pd(lo, plus_margin), _CMP_GT_OQ),
+                                     _mm256_cmp_pd(a, _mm256_mul_pd(hi, minus_margin), _CMP_LT_OQ));
+      __m256d reject = _mm256_or_pd(_mm256_cmp_pd(a, _mm256_mul_pd(lo, minus_margin), _CMP_LT_OQ),
+                                    _mm256_cmp_pd(a, _mm256_mul_pd(hi, plus_margin), _CMP_GT_OQ));
+
+      int same_dom = _mm256_movemask_pd(_mm256_castsi256_pd(
+        _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + k)), ka)));
+      int accepted = _mm256_movemask_pd(_mm256_and_pd(valid, accept)) & ~same_dom;
+      int decided = _mm256_movemask_pd(_mm256_and_pd(valid, _mm256_or_pd(accept, reject)));
+      int ambiguous = ~decided & ~same_dom & 0xF;
+
+      if (!(accepted | ambiguous)) continue;
+
+      for (int lane = 0; lane < 4; lane++) {
+        int bit = 1 << lane;
+        int l = k + lane;
+        if ((accepted & bit)
+            || ((ambiguous & bit) && IsDouble(bounds, x[l] - x[anchor], y[l] - y[anchor],
+                                              z[l] - z[anchor], t[l] - t[anchor])))
+          partners.push_back(l);
+      }
+    }
+
+    // Remaining pairs
+    ScanScalar(bounds, hits, anchor, k, last, partners);
+  }
+#else
+  template <class Bounds>
+  void ScanAVX2(const Bounds& bounds, const FPTHitArrays& hits, int anchor, int first, int last,
+                std::vector<int>& partners)
+  {
+    ScanScalar(bounds, hits, anchor, first, last, partners);
+  }
+#endif
+
+  template <class Bounds>
+  void FindPartners(const Bounds& bounds, const FPTHitArrays& hits, int anchor, int first, int last,
+                    std::vector<int>& partners)
+  {
+    if (FPTDoubleKernel::HasAVX2())
+      ScanAVX2(bounds, hits, anchor, first, last, partners);
+    else
+      ScanScalar(bounds, hits, anchor, first, last, partners);
+  }
+
+  template <class Bounds>
+  void FindDoubles(const Bounds& bounds, const FPTHitArrays& hits, bool use_avx2,
+                   std::vector<int>& doubles)
+  {
+    int n_hits = hits.Size();
+    std::vector<int> partners;
+    for (int i = 0; i < n_hits; i++) {
+      partners.clear();
+      if (use_avx2)
+        ScanAVX2(bounds, hits, i, i + 1, n_hits, partners);
+      else
+        ScanScalar(bounds, hits, i, i + 1, n_hits, partners);
+      for (std::vector<int>::const_iterator k = partners.begin(); k != partners.end(); k++) {
+        doubles.push_back(i);
+        doubles.push_back(*k);
+      }
+    }
+  }
+}
+
+void FPTHitArrays::Clear()
+{
+  x.clear();
+  y.clear();
+  z.clear();
+  t.clear();
+  string.clear();
+  om.clear();
+  key.clear();
+}
+
+void FPTHitArrays::Reserve(size_t n)
+{
+  x.reserve(n);
+  y.reserve(n);
+  z.reserve(n);
+  t.reserve(n);
+  string.reserve(n);
+  om.reserve(n);
+  key.reserve(n);
+}
+
+void FPTHitArrays::PushBack(double x_, double y_, double z_, double t_, int string_, unsigned int om_)
+{
+  x.push_back(x_);
+  y.push_back(y_);
+  z.push_back(z_);
+  t.push_back(t_);
+  string.push_back(string_);
+  om.push_back(om_);
+  key.push_back(DOMKey(string_, om_));
+}
+
+FPTDoubleKernel::FPTDoubleKernel(double double_velocity_min, double double_velocity_max) :
+  double_velocity_min_(double_velocity_min),
+  double_velocity_max_(double_velocity_max)
+{
+  vmin2_ = SquaredLowerBound(double_velocity_min_);
+  vmax2_ = double_velocity_max_*double_velocity_max_;
+
+  // Also true if either bound is NaN
+  nothing_passes_ = !(double_velocity_min_ < double_velocity_max_) || !(double_velocity_max_ > 0);
+}
+
+bool FPTDoubleKernel::HasAVX2()
+{
+#ifdef FPT_DOUBLE_KERNEL_AVX2
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+#else
+  return false;
+#endif
+}
+
+bool FPTDoubleKernel::IsDouble(double dx, double dy, double dz, double dt) const
+{
+  RuntimeBounds bounds = {double_velocity_min_, double_velocity_max_, vmin2_, vmax2_};
+  return ::IsDouble(bounds, dx, dy, dz, dt);
+}
+
+void FPTDoubleKernel::FindDoubles(const FPTHitArrays& hits, std::vector<int>& doubles) const
+{
+  if (nothing_passes_ || hits.Size() < 2)
+    return;
+
+  RuntimeBounds bounds = {double_velocity_min_, double_velocity_max_, vmin2_, vmax2_};
+  ::FindDoubles(bounds, hits, HasAVX2(), doubles);
+}
+
+void FPTDoubleKernel::FindDoublesScalar(const FPTHitArrays& hits, std::vector<int>& doubles) const
+{
+  if (nothing_passes_)
+    return;
+
+  RuntimeBounds bounds = {double_velocity_min_, double_velocity_max_, vmin2_, vmax2_};
+  ::FindDoubles(bounds, hits, false, doubles);
+}
+
+void FPTDoubleKernel::FindPartners(const FPTHitArrays& hits, int anchor, int first, int last,
+                                   std::vector<int>& partners) const
+{
+  if (nothing_passes_ || first >= last)
+    return;
+
+  RuntimeBounds bounds = {double_velocity_min_, double_velocity_max_, vmin2_, vmax2_};
+  ::FindPartners(bounds, hits, anchor, first, last, partners);
+}
+
+template <long VELOCITY_MIN, long VELOCITY_MAX>
+void FPTFixedDoubleKernel<VELOCITY_MIN, VELOCITY_MAX>::FindDoubles(const FPTHitArrays& hits,
+                                                                    std::vector<int>& doubles) const
+{
+  if (hits.Size() < 2)
+    return;
+
+  ::FindDoubles(FixedBounds<VELOCITY_MIN, VELOCITY_MAX>(), hits, FPTDoubleKernel::HasAVX2(), doubles);
+}
+
+template <long VELOCITY_MIN, long VELOCITY_MAX>
+void FPTFixedDoubleKernel<VELOCITY_MIN, VELOCITY_MAX>::FindPartners(const FPTHitArrays& hits, int anchor,
+                                                                     int first, int last,
+                                                                     std::vector<int>& partners) const
+{
+  if (first >= last)
+    return;
+
+  ::FindPartners(FixedBounds<VELOCITY_MIN, VELOCITY_MAX>(), hits, anchor, first, last, partners);
+}
+
+// The velocity bounds of the configurations in FPTFixedKernels.h
+template class FPTFixedDoubleKernel<100000, 3000000>;
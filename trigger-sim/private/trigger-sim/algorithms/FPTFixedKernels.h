@@ -0,0 +1,95 @@
+#ifndef FPT_FIXED_KERNELS_H
+#define FPT_FIXED_KERNELS_H
+
+#include <vector>
+#include "trigger-sim/algorithms/FPTDoubleKernel.h"
+#include "trigger-sim/algorithms/FPTHistogram.h"
+
+/**
+ * @brief The Double kernel and direction histograms of an FPT, as set up
+ * from the trigger configuration at run time.
+ *
+ * FaintParticleTriggerAlgorithm evaluates its time windows with either
+ * this or one of the FPTFixedKernels below, which have the same interface.
+ */
+class FPTRuntimeKernels
+{
+ public:
+  typedef FPTAngleHistogram ZenithHistogram;
+  typedef FPTAngleHistogram AzimuthHistogram;
+
+  FPTRuntimeKernels(const FPTDoubleKernel& kernel, const FPTAngleBinning& zenith_binning,
+                    const FPTAngleBinning& azimuth_binning) :
+    kernel_(kernel),
+    zenith_binning_(zenith_binning),
+    azimuth_binning_(azimuth_binning)
+  {}
+
+  ZenithHistogram MakeZenithHistogram() const { return ZenithHistogram(zenith_binning_); }
+  AzimuthHistogram MakeAzimuthHistogram() const { return AzimuthHistogram(azimuth_binning_); }
+
+  void FindDoubles(const FPTHitArrays& hits, std::vector<int>& doubles) const
+  {
+    kernel_.FindDoubles(hits, doubles);
+  }
+
+  void FindPartners(const FPTHitArrays& hits, int anchor, int first, int last,
+                    std::vector<int>& partners) const
+  {
+    kernel_.FindPartners(hits, anchor, first, last, partners);
+  }
+
+ private:
+  const FPTDoubleKernel& kernel_;
+  const FPTAngleBinning& zenith_binning_;
+  const FPTAngleBinning& azimuth_binning_;
+};
+
+/**
+ * @brief The same for a configuration known at compile time: a histogram
+ * binning of BIN_SIZE whole degrees and Doubles between VELOCITY_MIN and
+ * VELOCITY_MAX km/s.
+ *
+ * The velocity bounds and the bin edges are constants in the pair loop and
+ * the histograms are fixed size arrays.  Each configuration needs its
+ * FPTFixedDoubleKernel instantiated in FPTDoubleKernel.cxx.
+ */
+template <int BIN_SIZE, long VELOCITY_MIN, long VELOCITY_MAX>
+class FPTFixedKernels
+{
+ public:
+  typedef FPTFixedAngleHistogram<0, 180, BIN_SIZE> ZenithHistogram;
+  typedef FPTFixedAngleHistogram<0, 360, BIN_SIZE> AzimuthHistogram;
+
+  /**
+   * Whether an FPT with these settings, the bin size already in whole
+   * degrees, finds the same Doubles and histograms with these kernels.
+   */
+  static bool Matches(int bin_size, double double_velocity_min, double double_velocity_max)
+  {
+    return bin_size == BIN_SIZE && double_velocity_min == VELOCITY_MIN
+      && double_velocity_max == VELOCITY_MAX;
+  }
+
+  ZenithHistogram MakeZenithHistogram() const { return ZenithHistogram(); }
+  AzimuthHistogram MakeAzimuthHistogram() const { return AzimuthHistogram(); }
+
+  void FindDoubles(const FPTHitArrays& hits, std::vector<int>& doubles) const
+  {
+    kernel_.FindDoubles(hits, doubles);
+  }
+
+  void FindPartners(const FPTHitArrays& hits, int anchor, int first, int last,
+                    std::vector<int>& partners) const
+  {
+    kernel_.FindPartners(hits, anchor, first, last, partners);
+  }
+
+ private:
+  FPTFixedDoubleKernel<VELOCITY_MIN, VELOCITY_MAX> kernel_;
+};
+
+// The FPT of the IceCube trigger configuration, config ID 33001
+typedef FPTFixedKernels<10, 100000, 3000000> FPTKernels33001;
+
+#endif // FPT_FIXED_KERNELS_H
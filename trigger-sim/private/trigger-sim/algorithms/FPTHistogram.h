@@ -0,0 +1,252 @@
+#ifndef FPT_HISTOGRAM_H
+#define FPT_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "icetray/I3Units.h"
+#include "dataclasses/I3Constants.h"
+
+/**
+ * The bin of the angle in nbins bins of bin_size degrees that start at
+ * lower, -1 if it is outside of all of them.  relative is
+ * (angle - lower)/bin_size, it may be off by a rounding error, which is
+ * fixed up against the integer bin edges.  See FPTAngleBinning.
+ */
+inline int FPTAngleBin(double angle, double relative, int lower, int bin_size, int nbins, bool closed)
+{
+  if (!(angle >= lower) || nbins == 0)
+    return -1;
+  if (!(relative < nbins + 1))
+    return -1;
+
+  // Fix up the rounding of the division against the integer bin edges,
+  // which are what CalcHistogram compares to
+  int bin = static_cast<int>(relative);
+  if (bin > 0 && angle < lower + bin*bin_size)
+    bin--;
+  else if (angle >= lower + (bin + 1)*bin_size)
+    bin++;
+
+  if (bin < nbins)
+    return bin;
+  if (bin == nbins && closed && angle < lower + bin*bin_size + 1)
+    return nbins - 1;
+  return -1;
+}
+
+/**
+ * @brief The bins of the FPT direction histograms.
+ *
+ * Bins start at lower_bound and are bin_size wide, the last one starting
+ * below upper_bound.  If the last bin ends exactly at upper_bound it is
+ * closed on the right, so that 180 and 360 degrees are counted.  This is
+ * the binning of FaintParticleTriggerAlgorithm::CalcHistogram.
+ */
+class FPTAngleBinning
+{
+ public:
+  FPTAngleBinning(int lower_bound, int upper_bound, int bin_size) :
+    lower_(lower_bound),
+    bin_size_(bin_size),
+    nbins_(0),
+    closed_(false)
+  {
+    if (bin_size_ <= 0)
+      log_fatal("Histogram bin size has to be at least 1, got %d", bin_size_);
+    if (upper_bound > lower_bound) {
+      nbins_ = (upper_bound - lower_bound + bin_size_ - 1)/bin_size_;
+      closed_ = ((upper_bound - lower_bound) % bin_size_ == 0);
+    }
+  }
+
+  /**
+   * The bin size in whole degrees for the histogram_binning setting of the
+   * FPT, which is a double in the trigger configuration.  Fractions are
+   * dropped, as the original integer CalcHistogram call did, with a warning.
+   * Fails for settings below one degree.
+   */
+  static int BinSizeFromSetting(double histogram_binning)
+  {
+    if (!(histogram_binning >= 1.) || histogram_binning > 360.)
+      log_fatal("The FPT histogram binning has to be between 1 and 360 degrees, got %f.", histogram_binning);
+    int bin_size = static_cast<int>(histogram_binning);
+    if (bin_size != histogram_binning)
+      log_warn("The FPT histogram binning %f is not a whole number of degrees, using %d.",
+               histogram_binning, bin_size);
+    return bin_size;
+  }
+
+  int GetNumberOfBins() const { return nbins_; }
+
+  /**
+   * The bin the angle falls into, or -1 if it is outside of all bins.
+   */
+  int Bin(double angle) const
+  {
+    return FPTAngleBin(angle, (angle - lower_)/bin_size_, lower_, bin_size_, nbins_, closed_);
+  }
+
+ private:
+
+  FPTAngleBinning();
+
+  int lower_;
+  int bin_size_;
+  int nbins_;
+  bool closed_;
+
+  SET_LOGGER("FPTAngleBinning");
+};
+
+/**
+ * @brief Counts angles in the bins of an FPTAngleBinning.
+ *
+ * The counts live in a fixed size array, which covers every binning of the
+ * FPT histograms (at most 360 bins of 1 degree).  Wider ranges fall back to
+ * a heap allocated array.
+ */
+class FPTAngleHistogram
+{
+ public:
+  static const int MAX_STACK_BINS = 360;
+
+  explicit FPTAngleHistogram(const FPTAngleBinning& binning) :
+    binning_(binning),
+    counts_(stack_counts_)
+  {
+    int nbins = binning_.GetNumberOfBins();
+    if (nbins > MAX_STACK_BINS) {
+      heap_counts_.assign(nbins, 0);
+      counts_ = heap_counts_.data();
+    }
+    else {
+      for (int bin = 0; bin < nbins; bin++)
+        stack_counts_[bin] = 0;
+    }
+  }
+
+  /**
+   * Adds the angle and returns the new count of its bin, 0 if it is
+   * outside of all bins.
+   */
+  unsigned int Fill(double angle)
+  {
+    int bin = binning_.Bin(angle);
+    if (bin < 0)
+      return 0;
+    return ++counts_[bin];
+  }
+
+  /**
+   * Entries in the fullest bin, 0 if there are no bins.
+   */
+  unsigned int GetMaxCount() const
+  {
+    unsigned int max_count = 0;
+    for (int bin = 0; bin < binning_.GetNumberOfBins(); bin++)
+      if (counts_[bin] > max_count)
+        max_count = counts_[bin];
+    return max_count;
+  }
+
+ private:
+
+  FPTAngleHistogram();
+  FPTAngleHistogram(const FPTAngleHistogram&);
+  FPTAngleHistogram& operator=(const FPTAngleHistogram&);
+
+  const FPTAngleBinning& binning_;
+  unsigned int stack_counts_[MAX_STACK_BINS];
+  std::vector<unsigned int> heap_counts_;
+  unsigned int* counts_;
+};
+
+/**
+ * @brief FPTAngleBinning with the bounds and bin size fixed at compile time.
+ *
+ * Gives the same bins.  It multiplies with the inverse bin size instead of
+ * dividing, FPTAngleBin fixes up the rounding of either.
+ */
+template <int LOWER, int UPPER, int BIN_SIZE>
+class FPTFixedAngleBinning
+{
+  static_assert(BIN_SIZE > 0, "Histogram bin size has to be at least 1");
+
+ public:
+  static constexpr int NBINS = UPPER > LOWER ? (UPPER - LOWER + BIN_SIZE - 1)/BIN_SIZE : 0;
+  static constexpr bool CLOSED = UPPER > LOWER && (UPPER - LOWER) % BIN_SIZE == 0;
+
+  static int GetNumberOfBins() { return NBINS; }
+
+  static int Bin(double angle)
+  {
+    return FPTAngleBin(angle, (angle - LOWER)*(1./BIN_SIZE), LOWER, BIN_SIZE, NBINS, CLOSED);
+  }
+};
+
+/**
+ * @brief FPTAngleHistogram of an FPTFixedAngleBinning.
+ *
+ * The counts are a std::array of the exact number of bins, and the loop
+ * over them has a fixed length.
+ */
+template <int LOWER, int UPPER, int BIN_SIZE>
+class FPTFixedAngleHistogram
+{
+ public:
+  typedef FPTFixedAngleBinning<LOWER, UPPER, BIN_SIZE> Binning;
+
+  FPTFixedAngleHistogram() { counts_.fill(0); }
+
+  unsigned int Fill(double angle)
+  {
+    int bin = Binning::Bin(angle);
+    if (bin < 0)
+      return 0;
+    return ++counts_[bin];
+  }
+
+  unsigned int GetMaxCount() const
+  {
+    unsigned int max_count = 0;
+    for (int bin = 0; bin < Binning::NBINS; bin++)
+      max_count = std::max(max_count, counts_[bin]);
+    return max_count;
+  }
+
+ private:
+  std::array<unsigned int, Binning::NBINS> counts_;
+};
+
+/**
+ * Zenith and azimuth in degrees of the direction (dx, dy, dz), the same
+ * values as I3Direction(dx, dy, dz).GetZenith()/I3Units::degree and
+ * GetAzimuth()/I3Units::degree, without constructing an I3Direction.
+ * This follows I3Direction::CalcSphFromCar step by step.
+ */
+inline void FPTPairDirection(double dx, double dy, double dz, double& zenith, double& azimuth)
+{
+  const double r = std::sqrt(dx*dx + dy*dy + dz*dz);
+  double theta = 0.;
+  if (r && std::abs(dz/r) <= 1.) {
+    theta = std::acos(dz/r);
+  } else {
+    if (dz < 0.) theta = I3Constants::pi;
+  }
+  if (theta < 0.) theta += 2.*I3Constants::pi;
+  double phi = 0;
+  if ((dx != 0.) || (dy != 0.)) phi = std::atan2(dy, dx);
+  if (phi < 0.) phi += 2.*I3Constants::pi;
+  double zen = I3Constants::pi - theta;
+  double azi = phi + I3Constants::pi;
+  if (zen > I3Constants::pi) zen -= I3Constants::pi - (zen - I3Constants::pi);
+  azi -= (int)(azi/(2.*I3Constants::pi))*(2.*I3Constants::pi);
+
+  zenith = zen/I3Units::degree;
+  azimuth = azi/I3Units::degree;
+}
+
+#endif // FPT_HISTOGRAM_H
@@ -0,0 +1,130 @@
+#include "trigger-sim/algorithms/FPTPairCache.h"
+#include <algorithm>
+#include <cmath>
+
+FPTPairCache::FPTPairCache(const FPTDoubleKernel& kernel, int bin_size) :
+  kernel_(kernel),
+  zenith_binning_(0, 180, bin_size),
+  azimuth_binning_(0, 360, bin_size),
+  hits_(NULL),
+  positions_(NULL),
+  first_(0),
+  last_(0),
+  number_doubles_(0),
+  zenith_counts_(zenith_binning_.GetNumberOfBins(), 0),
+  azimuth_counts_(azimuth_binning_.GetNumberOfBins(), 0),
+  pair_tests_(0)
+{
+}
+
+void FPTPairCache::Reset(const TriggerHitVector& hits, const DOMPositionTable& positions)
+{
+  hits_ = &hits;
+  positions_ = &positions;
+  arrays_.Clear();
+  arrays_.Reserve(hits.size());
+  for (std::vector<std::vector<PairBins> >::iterator iter = pairs_.begin(); iter != pairs_.end(); iter++)
+    iter->clear();
+  pairs_.resize(hits.size());
+  first_ = 0;
+  last_ = 0;
+  pair_tests_ = 0;
+  number_doubles_ = 0;
+  std::fill(zenith_counts_.begin(), zenith_counts_.end(), 0);
+  std::fill(azimuth_counts_.begin(), azimuth_counts_.end(), 0);
+}
+
+void FPTPairCache::Clear()
+{
+  for (int hit = first_; hit < last_; hit++)
+    pairs_[hit].clear();
+  number_doubles_ = 0;
+  std::fill(zenith_counts_.begin(), zenith_counts_.end(), 0);
+  std::fill(azimuth_counts_.begin(), azimuth_counts_.end(), 0);
+}
+
+void FPTPairCache::Retire(int hit)
+{
+  std::vector<PairBins>& pairs = pairs_[hit];
+  for (std::vector<PairBins>::const_iterator iter = pairs.begin(); iter != pairs.end(); iter++) {
+    if (iter->zenith >= 0) zenith_counts_[iter->zenith]--;
+    if (iter->azimuth >= 0) azimuth_counts_[iter->azimuth]--;
+  }
+  number_doubles_ -= pairs.size();
+  pairs.clear();
+}
+
+void FPTPairCache::Advance(int first, int last)
+{
+  if (!hits_)
+    log_fatal("FPTPairCache::Advance called before Reset");
+  if (first < 0 || last < first || last > static_cast<int>(hits_->size()))
+    log_fatal("Window [%d, %d) is outside of the %zu hits", first, last, hits_->size());
+
+  if (first < first_ || last < last_) {
+    // Moving backwards, start over
+    Clear();
+    arrays_.Clear();
+    first_ = first;
+    last_ = first;
+  }
+  else if (first >= last_) {
+    // Nothing to share with the previous window
+    Clear();
+    first_ = first;
+    last_ = first;
+  }
+
+  for (; first_ < first; first_++)
+    Retire(first_);
+
+  // Make the positions of the new hits available to the kernel.  Hits that
+  // were skipped between windows are never paired and need no position.
+  for (int hit = arrays_.Size(); hit < last; hit++) {
+    const TriggerHit& triggerHit = (*hits_)[hit];
+    if (hit < first_) {
+      arrays_.PushBack(NAN, NAN, NAN, triggerHit.time, triggerHit.string, triggerHit.pos);
+      continue;
+    }
+    int index = positions_->GetIndex(triggerHit.string, triggerHit.pos);
+    if (index < 0)
+      log_fatal("OMKey(%d,%u) not part of geometry", triggerHit.string, triggerHit.pos);
+    const double* pos = positions_->GetPosition(index);
+    arrays_.PushBack(pos[0], pos[1], pos[2], triggerHit.time, triggerHit.string, triggerHit.pos);
+  }
+
+  for (; last_ < last; last_++) {
+    int upper = last_;
+    partners_.clear();
+    kernel_.FindPartners(arrays_, upper, first_, upper, partners_);
+    pair_tests_ += upper - first_;
+
+    for (std::vector<int>::const_iterator iter = partners_.begin(); iter != partners_.end(); iter++) {
+      int lower = *iter;
+      // Same direction convention as FaintParticleTriggerAlgorithm::getDirection
+      double zenith, azimuth;
+      FPTPairDirection(arrays_.x[upper] - arrays_.x[lower],
+                       arrays_.y[upper] - arrays_.y[lower],
+                       arrays_.z[upper] - arrays_.z[lower], zenith, azimuth);
+      PairBins bins;
+      bins.zenith = zenith_binning_.Bin(zenith);
+      bins.azimuth = azimuth_binning_.Bin(azimuth);
+      if (bins.zenith >= 0) zenith_counts_[bins.zenith]++;
+      if (bins.azimuth >= 0) azimuth_counts_[bins.azimuth]++;
+      pairs_[lower].push_back(bins);
+      number_doubles_++;
+    }
+  }
+}
+
+unsigned int FPTPairCache::GetMaxAzimuthCount() const
+{
+  if (azimuth_counts_.empty()) return 0;
+  return *std::max_element(azimuth_counts_.begin(), azimuth_counts_.end());
+}
+
+unsigned int FPTPairCache::GetMaxZenithCount() const
+{
+  if (zenith_counts_.empty()) return 0;
+  return *std::max_element(zenith_counts_.begin(), zenith_counts_.end());
+}
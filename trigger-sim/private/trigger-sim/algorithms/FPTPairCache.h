@@ -0,0 +1,85 @@
+#ifndef FPT_PAIR_CACHE_H
+#define FPT_PAIR_CACHE_H
+
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/algorithms/FPTDoubleKernel.h"
+#include "trigger-sim/algorithms/FPTHistogram.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+
+/**
+ * @brief Rolling set of the Doubles in the current FPT time window.
+ *
+ * The windows passed to Advance have to move forward through one time
+ * ordered hit vector.  A hit pair is tested once, when the later of the two
+ * hits enters the window, and its direction bins are kept with the earlier
+ * hit.  When that hit leaves the window all of its pairs are retired.  The
+ * Double count and the zenith and azimuth histograms are updated as pairs
+ * come and go, so overlapping windows share all of their common pairs.
+ */
+class FPTPairCache
+{
+ public:
+  FPTPairCache(const FPTDoubleKernel& kernel, int bin_size);
+
+  ~FPTPairCache() = default;
+
+  /**
+   * Start over with a new hit vector.  The vector has to stay unchanged
+   * while the cache is in use.
+   */
+  void Reset(const TriggerHitVector& hits, const DOMPositionTable& positions);
+
+  /**
+   * Move the window to the hits [first, last).  Both boundaries may only
+   * increase, otherwise the cache starts over at this window.
+   */
+  void Advance(int first, int last);
+
+  unsigned int GetNumberOfDoubles() const { return number_doubles_; }
+  unsigned int GetMaxAzimuthCount() const;
+  unsigned int GetMaxZenithCount() const;
+
+  /**
+   * Number of hit pairs tested since the last Reset.
+   */
+  size_t GetNumberOfPairTests() const { return pair_tests_; }
+
+ private:
+
+  FPTPairCache();
+
+  // Direction bins of one Double, -1 if outside of the histogram
+  struct PairBins
+  {
+    short zenith;
+    short azimuth;
+  };
+
+  void Clear();
+  void Retire(int hit);
+
+  const FPTDoubleKernel& kernel_;
+  FPTAngleBinning zenith_binning_;
+  FPTAngleBinning azimuth_binning_;
+
+  const TriggerHitVector* hits_;
+  const DOMPositionTable* positions_;
+  // The hits of the window, filled as hits enter, indexed like hits_
+  FPTHitArrays arrays_;
+  // The Doubles, stored with their earlier hit
+  std::vector<std::vector<PairBins> > pairs_;
+  std::vector<int> partners_;
+
+  int first_;
+  int last_;
+  unsigned int number_doubles_;
+  std::vector<unsigned int> zenith_counts_;
+  std::vector<unsigned int> azimuth_counts_;
+  size_t pair_tests_;
+
+  SET_LOGGER("FPTPairCache");
+};
+
+#endif // FPT_PAIR_CACHE_H
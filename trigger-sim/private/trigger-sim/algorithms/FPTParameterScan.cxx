@@ -0,0 +1,265 @@
+#include "trigger-sim/algorithms/FPTParameterScan.h"
+#include "trigger-sim/algorithms/FPTTimeWindow.h"
+#include "trigger-sim/algorithms/FPTTriggerMerger.h"
+#include "trigger-sim/algorithms/FPTHistogram.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <tuple>
+
+FPTParameterScan::FPTParameterScan(const I3Geometry& geometry) :
+  positions_(new DOMPositionTable(geometry))
+{
+}
+
+FPTParameterScan::FPTParameterScan(DOMPositionTableConstPtr positions) :
+  positions_(positions)
+{
+  if (!positions_)
+    log_fatal("FPTParameterScan needs a DOM position table.");
+}
+
+void FPTParameterScan::Run(const TriggerHitVector& hits,
+                           const std::vector<FPTConfiguration>& configurations,
+                           std::vector<FPTScanResult>& results,
+                           unsigned int numThreads)
+{
+  results.assign(configurations.size(), FPTScanResult());
+  windowSets_.clear();
+  pairBins_.clear();
+  pairs_.clear();
+  hits_ = TriggerHitVectorPtr(new TriggerHitVector(hits));
+
+  // Like FaintParticleTriggerAlgorithm::Trigger, which needs two hits
+  if (hits_->size() < 2 || configurations.empty())
+    return;
+
+  for (size_t hit = 1; hit < hits_->size(); hit++)
+    if ((*hits_)[hit].time < (*hits_)[hit - 1].time)
+      log_fatal("The hits of the FPT parameter scan have to be time ordered.");
+
+  hlcBefore_.assign(hits_->size() + 1, 0);
+  for (size_t hit = 0; hit < hits_->size(); hit++)
+    hlcBefore_[hit + 1] = hlcBefore_[hit] + ((*hits_)[hit].lc ? 1 : 0);
+
+  // Build everything the configurations share before the workers start,
+  // they only read it
+  double maxTimeWindow = 0;
+  std::vector<size_t> windowSet(configurations.size());
+  std::vector<size_t> pairBins(configurations.size());
+  for (size_t config = 0; config < configurations.size(); config++) {
+    const FPTConfiguration& configuration = configurations[config];
+    maxTimeWindow = std::max(maxTimeWindow, configuration.timeWindow);
+    windowSet[config] = GetWindowSet(configuration.timeWindow, configuration.timeWindowSeparation);
+  }
+  FindPairs(maxTimeWindow);
+  for (size_t config = 0; config < configurations.size(); config++)
+    pairBins[config] = GetPairBins(FPTAngleBinning::BinSizeFromSetting(configurations[config].histogramBinning));
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t config = next++; config < configurations.size(); config = next++)
+      Evaluate(configurations[config], windowSets_[windowSet[config]],
+               pairBins_[pairBins[config]], results[config]);
+  };
+
+  std::vector<std::future<void> > workers;
+  for (unsigned int thread = 1; thread < numThreads && thread < configurations.size(); thread++)
+    workers.push_back(std::async(std::launch::async, worker));
+  worker();
+  // Rethrows what a worker threw
+  for (std::vector<std::future<void> >::iterator iter = workers.begin(); iter != workers.end(); iter++)
+    iter->get();
+}
+
+void FPTParameterScan::FindPairs(double maxTimeWindow)
+{
+  size_t nHits = hits_->size();
+  std::vector<int> index(nHits);
+  for (size_t hit = 0; hit < nHits; hit++) {
+    const TriggerHit& triggerHit = (*hits_)[hit];
+    index[hit] = positions_->GetIndex(triggerHit.string, triggerHit.pos);
+    if (index[hit] < 0)
+      log_fatal("OMKey(%d,%u) not part of geometry", triggerHit.string, triggerHit.pos);
+  }
+
+  // Hits of one window are less than a window length apart.  The margin
+  // keeps the pairs whose time difference rounds up to the window length.
+  double maxDelay = maxTimeWindow*(1 + 1e-9);
+
+  pairsBegin_.assign(nHits + 1, 0);
+  std::vector<size_t> laterCount(nHits, 0);
+  for (size_t first = 0; first < nHits; first++) {
+    pairsBegin_[first] = pairs_.size();
+    const TriggerHit& hit1 = (*hits_)[first];
+    const double* pos1 = positions_->GetPosition(index[first]);
+    for (size_t second = first + 1; second < nHits; second++) {
+      const TriggerHit& hit2 = (*hits_)[second];
+      if (!(hit2.time - hit1.time <= maxDelay))
+        break;
+      if (hit1.string == hit2.string && hit1.pos == hit2.pos)
+        continue;
+
+      const double* pos2 = positions_->GetPosition(index[second]);
+      double dx = pos2[0] - pos1[0];
+      double dy = pos2[1] - pos1[1];
+      double dz = pos2[2] - pos1[2];
+      HitPair pair;
+      pair.later = second;
+      // in km/s, the same expression as FPTDoubleKernel::IsDouble
+      pair.velocity = 1e6*sqrt(pow(dx, 2) + pow(dy, 2) + pow(dz, 2))/fabs(hit2.time - hit1.time);
+      FPTPairDirection(dx, dy, dz, pair.zenith, pair.azimuth);
+      pairs_.push_back(pair);
+      laterCount[second]++;
+    }
+  }
+  pairsBegin_[nHits] = pairs_.size();
+
+  laterBegin_.assign(nHits + 1, 0);
+  for (size_t hit = 0; hit < nHits; hit++)
+    laterBegin_[hit + 1] = laterBegin_[hit] + laterCount[hit];
+  byLater_.resize(pairs_.size());
+  std::vector<size_t> fill(laterBegin_.begin(), laterBegin_.end() - 1);
+  for (size_t pair = 0; pair < pairs_.size(); pair++)
+    byLater_[fill[pairs_[pair].later]++] = pair;
+}
+
+size_t FPTParameterScan::GetWindowSet(double timeWindow, double timeWindowSeparation)
+{
+  for (size_t set = 0; set < windowSets_.size(); set++)
+    if (windowSets_[set].timeWindow == timeWindow &&
+        windowSets_[set].timeWindowSeparation == timeWindowSeparation)
+      return set;
+
+  // Without the hit count and SLC fraction cuts these are all non-empty windows
+  FPTTimeWindow timeWindows(0, std::numeric_limits<unsigned int>::max(), -1.,
+                            timeWindow, timeWindowSeparation);
+  TriggerHitIterPairVectorPtr windows;
+  WindowSet windowSet;
+  windowSet.timeWindow = timeWindow;
+  windowSet.timeWindowSeparation = timeWindowSeparation;
+  std::tie(windows, windowSet.timeRanges) = timeWindows.FPTFixedTimeWindows(hits_, timeWindowSeparation);
+  windowSet.windows = timeWindows.GetNumberOfWindows();
+  for (TriggerHitIterPairVector::const_iterator iter = windows->begin(); iter != windows->end(); iter++)
+    windowSet.hitRanges.emplace_back(iter->first - hits_->cbegin(), iter->second - hits_->cbegin());
+  windowSets_.push_back(windowSet);
+  return windowSets_.size() - 1;
+}
+
+size_t FPTParameterScan::GetPairBins(int binning)
+{
+  for (size_t bins = 0; bins < pairBins_.size(); bins++)
+    if (pairBins_[bins].binning == binning)
+      return bins;
+
+  FPTAngleBinning zenithBinning(0, 180, binning);
+  FPTAngleBinning azimuthBinning(0, 360, binning);
+  PairBins bins;
+  bins.binning = binning;
+  bins.zenithBins = zenithBinning.GetNumberOfBins();
+  bins.azimuthBins = azimuthBinning.GetNumberOfBins();
+  bins.zenith.resize(pairs_.size());
+  bins.azimuth.resize(pairs_.size());
+  for (size_t pair = 0; pair < pairs_.size(); pair++) {
+    bins.zenith[pair] = zenithBinning.Bin(pairs_[pair].zenith);
+    bins.azimuth[pair] = azimuthBinning.Bin(pairs_[pair].azimuth);
+  }
+  pairBins_.push_back(bins);
+  return pairBins_.size() - 1;
+}
+
+void FPTParameterScan::Evaluate(const FPTConfiguration& configuration,
+                                const WindowSet& windowSet,
+                                const PairBins& bins,
+                                FPTScanResult& result) const
+{
+  result.windows = windowSet.windows;
+
+  // First and fourth cut, the same comparisons as FPTTimeWindow
+  std::vector<size_t> passing;
+  for (size_t window = 0; window < windowSet.hitRanges.size(); window++) {
+    unsigned int first = windowSet.hitRanges[window].first;
+    unsigned int last = windowSet.hitRanges[window].second;
+    unsigned int hlc_count = hlcBefore_[last] - hlcBefore_[first];
+    unsigned int slc_count = last - first - hlc_count;
+    if (hlc_count+slc_count >= configuration.hitMin && hlc_count+slc_count <= configuration.hitMax) {
+      result.hitCountPassed++;
+      double const slc_fraction = static_cast<double>(slc_count) / (slc_count + hlc_count);
+      if (slc_fraction > configuration.slcFractionMin)
+        passing.push_back(window);
+    }
+  }
+  result.slcFractionPassed = passing.size();
+
+  // The Doubles of the current window, kept up to date like FPTPairCache
+  // does: a pair enters with its later hit and leaves with its earlier one
+  const double vmin = configuration.doubleVelocityMin;
+  const double vmax = configuration.doubleVelocityMax;
+  unsigned int number_doubles = 0;
+  std::vector<unsigned int> zenith_counts(bins.zenithBins, 0);
+  std::vector<unsigned int> azimuth_counts(bins.azimuthBins, 0);
+  int first_ = 0;
+  int last_ = 0;
+
+  FPTTriggerMerger merger(configuration.maxTriggerLength);
+  for (size_t pass = 0; pass < passing.size(); pass++) {
+    size_t window = passing[pass];
+    int first = windowSet.hitRanges[window].first;
+    int last = windowSet.hitRanges[window].second;
+
+    if (first >= last_) {
+      // Nothing to share with the previous window
+      number_doubles = 0;
+      std::fill(zenith_counts.begin(), zenith_counts.end(), 0);
+      std::fill(azimuth_counts.begin(), azimuth_counts.end(), 0);
+      first_ = first;
+      last_ = first;
+    }
+    for (; first_ < first; first_++) {
+      for (size_t pair = pairsBegin_[first_]; pair < pairsBegin_[first_ + 1]; pair++) {
+        const HitPair& hitPair = pairs_[pair];
+        if (hitPair.later >= last_)
+          break;
+        if (hitPair.velocity > vmin && hitPair.velocity < vmax) {
+          number_doubles--;
+          if (bins.zenith[pair] >= 0) zenith_counts[bins.zenith[pair]]--;
+          if (bins.azimuth[pair] >= 0) azimuth_counts[bins.azimuth[pair]]--;
+        }
+      }
+    }
+    for (; last_ < last; last_++) {
+      for (size_t later = laterBegin_[last_]; later < laterBegin_[last_ + 1]; later++) {
+        size_t pair = byLater_[later];
+        const HitPair& hitPair = pairs_[pair];
+        if (pair < pairsBegin_[first_])
+          continue;
+        if (hitPair.velocity > vmin && hitPair.velocity < vmax) {
+          number_doubles++;
+          if (bins.zenith[pair] >= 0) zenith_counts[bins.zenith[pair]]++;
+          if (bins.azimuth[pair] >= 0) azimuth_counts[bins.azimuth[pair]]++;
+        }
+      }
+    }
+
+    // Second and third cut
+    bool passed = false;
+    if (number_doubles >= configuration.doubleMin) {
+      result.doublesPassed++;
+      unsigned int number_zenith = zenith_counts.empty() ? 0 :
+        *std::max_element(zenith_counts.begin(), zenith_counts.end());
+      unsigned int number_azimuth = azimuth_counts.empty() ? 0 :
+        *std::max_element(azimuth_counts.begin(), azimuth_counts.end());
+      if (number_zenith > configuration.zenithHistogramMin &&
+          number_azimuth > configuration.azimuthHistogramMin) {
+        result.directionPassed++;
+        passed = true;
+      }
+    }
+
+    merger.AddWindow(hits_->cbegin() + first, hits_->cbegin() + last,
+                     windowSet.timeRanges[window].first, windowSet.timeRanges[window].second,
+                     passed, pass == passing.size() - 1, result.triggers);
+  }
+}
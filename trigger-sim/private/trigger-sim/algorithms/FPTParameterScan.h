@@ -0,0 +1,150 @@
+#ifndef FPT_PARAMETER_SCAN_H
+#define FPT_PARAMETER_SCAN_H
+
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "dataclasses/geometry/I3Geometry.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+
+/**
+ * @brief The settings of one Faint Particle Trigger, see the parameters of
+ *        FaintParticleTriggerAlgorithm.
+ */
+struct FPTConfiguration
+{
+  double timeWindow;
+  double timeWindowSeparation;
+  double maxTriggerLength;
+  unsigned int hitMin;
+  unsigned int hitMax;
+  double doubleVelocityMin;
+  double doubleVelocityMax;
+  unsigned int doubleMin;
+  unsigned int azimuthHistogramMin;
+  unsigned int zenithHistogramMin;
+  double histogramBinning;
+  double slcFractionMin;
+
+  FPTConfiguration() :
+    timeWindow(0), timeWindowSeparation(0), maxTriggerLength(0),
+    hitMin(0), hitMax(0), doubleVelocityMin(0), doubleVelocityMax(0),
+    doubleMin(0), azimuthHistogramMin(0), zenithHistogramMin(0),
+    histogramBinning(0), slcFractionMin(0) {}
+};
+
+/**
+ * @brief What one FPTConfiguration finds on the hits of a frame.
+ *
+ * The same as GetNumberOfWindows, GetCutPassCounts and the triggers of a
+ * FaintParticleTriggerAlgorithm with that configuration.
+ */
+struct FPTScanResult
+{
+  unsigned long windows;
+  // Windows that passed the cut and all cuts applied before it
+  unsigned long hitCountPassed;
+  unsigned long slcFractionPassed;
+  unsigned long doublesPassed;
+  unsigned long directionPassed;
+  // In time order, GetNextTrigger hands them out the other way round
+  TriggerHitVectorVector triggers;
+
+  FPTScanResult() :
+    windows(0), hitCountPassed(0), slcFractionPassed(0),
+    doublesPassed(0), directionPassed(0) {}
+};
+
+/**
+ * @brief Runs many Faint Particle Trigger configurations on the hits of one frame.
+ *
+ * Tuning the FPT means running the same frames with a grid of settings.
+ * Most of the work of each run doesn't depend on the settings: the hit
+ * pairs, their velocities and directions are computed once per frame, the
+ * time windows once per window length and separation, and the direction
+ * bins once per histogram binning.  Each configuration then only counts
+ * its Doubles, rolling through the windows that pass its hit count and
+ * SLC fraction cuts, and forms its triggers.  The configurations are
+ * spread over worker threads.
+ */
+class FPTParameterScan
+{
+ public:
+  explicit FPTParameterScan(const I3Geometry& geometry);
+  explicit FPTParameterScan(DOMPositionTableConstPtr positions);
+
+  ~FPTParameterScan() = default;
+
+  /**
+   * Runs every configuration on the hits, which have to be time ordered
+   * and include the SLC hits, like the hits of a FaintParticleTriggerAlgorithm
+   * after FillHits(..., true) (see TriggerService::GetHits).  results is
+   * resized to one entry per configuration, in the same order.
+   */
+  void Run(const TriggerHitVector& hits,
+           const std::vector<FPTConfiguration>& configurations,
+           std::vector<FPTScanResult>& results,
+           unsigned int numThreads = 1);
+
+ private:
+
+  FPTParameterScan();
+
+  // A hit pair (i, j), i < j, on different DOMs
+  struct HitPair
+  {
+    int later;
+    double velocity;
+    double zenith;
+    double azimuth;
+  };
+
+  // The non-empty windows of one window length and separation
+  struct WindowSet
+  {
+    double timeWindow;
+    double timeWindowSeparation;
+    unsigned long windows;
+    std::vector<std::pair<int, int> > hitRanges;
+    std::vector<std::pair<double, double> > timeRanges;
+  };
+
+  // The direction bins of every pair for one histogram binning
+  struct PairBins
+  {
+    int binning;
+    int zenithBins;
+    int azimuthBins;
+    std::vector<short> zenith;
+    std::vector<short> azimuth;
+  };
+
+  void FindPairs(double maxTimeWindow);
+  // The indices of the window set and pair bins, built on first use
+  size_t GetWindowSet(double timeWindow, double timeWindowSeparation);
+  size_t GetPairBins(int binning);
+  void Evaluate(const FPTConfiguration& configuration,
+                const WindowSet& windowSet,
+                const PairBins& bins,
+                FPTScanResult& result) const;
+
+  DOMPositionTableConstPtr positions_;
+
+  // The hits of the current Run
+  TriggerHitVectorPtr hits_;
+  // Number of HLC hits before each hit, and in total at the end
+  std::vector<unsigned int> hlcBefore_;
+  // The pairs, grouped by their earlier hit
+  std::vector<size_t> pairsBegin_;
+  std::vector<HitPair> pairs_;
+  // Indices into pairs_ of the pairs, grouped by their later hit
+  std::vector<size_t> laterBegin_;
+  std::vector<size_t> byLater_;
+
+  std::vector<WindowSet> windowSets_;
+  std::vector<PairBins> pairBins_;
+
+  SET_LOGGER("FPTParameterScan");
+};
+
+#endif // FPT_PARAMETER_SCAN_H
@@ -4,7 +4,7 @@
  Structure as in TimWindow.cxx but for a fixed time window separation. Time windows are moved in increments of the time_window_separation parameter instead of sliding them.
  */
 FPTTimeWindow::FPTTimeWindow(unsigned int hit_min, unsigned int hit_max, double slcfraction_min, double time_window, double time_window_separation)
-    : hit_min_(hit_min), hit_max_(hit_max), slcfraction_min_(slcfraction_min), time_window_(time_window), time_window_separation_(time_window_separation)
+    : hit_min_(hit_min), hit_max_(hit_max), slcfraction_min_(slcfraction_min), time_window_(time_window), time_window_separation_(time_window_separation), windowCount_(0), hitCountPassed_(0)
 {
     FPTtimeWindowHits_ = TriggerHitListPtr(new TriggerHitList());
     FPTtriggerWindowHits_ = TriggerHitListPtr(new TriggerHitList());
@@ -14,40 +14,74 @@ std::pair<TriggerHitIterPairVectorPtr, std::vector<std::pair<double, double>>> F
     TriggerHitIterPairVectorPtr const FPTtriggerWindows(new TriggerHitIterPairVector());
     //Keep track of the window boundaries
     std::vector<std::pair<double, double>> timeWindows;
-    //Initialize the iterator
-    TriggerHitVector::const_iterator current;
+    windowCount_ = 0;
+    hitCountPassed_ = 0;
+    if (hits->empty())
+        return std::make_pair(FPTtriggerWindows, timeWindows);
+    if (time_window_separation <= 0)
+        log_fatal("The time window separation has to be positive, got %f", time_window_separation);
+
+    /*
+     The hits are time ordered, so both window boundaries only ever move forward.
+     windowBegin is the first hit with time >= startTime, windowEnd the first hit with
+     time >= startTime + time_window_, and the HLC/SLC counts are updated as hits enter
+     and leave the window.
+     */
+    TriggerHitVector::const_iterator windowBegin = hits->begin();
+    TriggerHitVector::const_iterator windowEnd = hits->begin();
+    //two counts to calculate the slc fraction
+    unsigned int hlc_count = 0;
+    unsigned int slc_count = 0;
+    double const lastTime = hits->back().time;
     double startTime = hits->begin()->time;
     //Loop over the event for which the startTime is incremented by time_window_separation
-    while (startTime < hits->back().time)
+    while (startTime < lastTime)
     {
-        //two counts to calculate the slc fraction
-        unsigned int hlc_count = 0;
-        unsigned int slc_count = 0;
-        //Loop over all hits and count the SLC and HLC hits in the corresponding time window [startTime,startTime+timewindow_)
-        for(current = hits->begin(); (current != hits->end()) && (current->time < startTime + time_window_); ++current){
-            if (current->time>=startTime){
-                if (current->lc)
-                {
-                    hlc_count++;
-                }
-                else
-                {
-                    slc_count++;
-                }
-            }
+        windowCount_++;
+        double const endTime = startTime + time_window_;
+        //Add the hits in [startTime,startTime+timewindow_) ...
+        for (; (windowEnd != hits->end()) && (windowEnd->time < endTime); ++windowEnd){
+            if (windowEnd->lc)
+                hlc_count++;
+            else
+                slc_count++;
         }
+        //... and remove the ones that are now before startTime
+        for (; (windowBegin != windowEnd) && (windowBegin->time < startTime); ++windowBegin){
+            if (windowBegin->lc)
+                hlc_count--;
+            else
+                slc_count--;
+        }
+
+        if (windowBegin == windowEnd)
+        {
+            //Empty windows never pass the cuts, move on to the first window that reaches the next hit.
+            //The start time is still advanced one step at a time so the window boundaries are exactly
+            //the ones of the step-by-step loop.
+            if (windowEnd == hits->end())
+                break;
+            double const nextTime = windowEnd->time;
+            do {
+                startTime += time_window_separation;
+                windowCount_++;
+            } while (startTime + time_window_ <= nextTime && startTime < lastTime);
+            //the window the loop stops at is counted by the next iteration, if there is one
+            windowCount_--;
+            continue;
+        }
+
         //First cut on the hit count
         if (hlc_count+slc_count >= hit_min_ && hlc_count+slc_count <= hit_max_)
         {
+            hitCountPassed_++;
             double const slc_fraction = static_cast<double>(slc_count) / (slc_count + hlc_count);
             //Fourth cut on the SLC fraction
             if (slc_fraction > slcfraction_min_)
             {
-                TriggerHitVector::const_iterator endHit;
-                endHit=current;
-                TriggerHitIterPair const FPTtriggerWindow(current - (hlc_count+slc_count), endHit);
+                TriggerHitIterPair const FPTtriggerWindow(windowBegin, windowEnd);
                 FPTtriggerWindows->push_back(FPTtriggerWindow);
-                timeWindows.emplace_back(startTime, startTime + time_window_);
+                timeWindows.emplace_back(startTime, endTime);
             }
         }
 
@@ -30,6 +30,14 @@ class FPTTimeWindow
  
   std::pair<TriggerHitIterPairVectorPtr, std::vector<std::pair<double, double>>> FPTFixedTimeWindows(const TriggerHitVectorPtr& hits,double separation);
 
+  /**
+   * Number of time windows of the last FPTFixedTimeWindows call, and of
+   * the ones that passed the first cut.  The ones that also passed the
+   * fourth cut are the ones returned.
+   */
+  unsigned long GetNumberOfWindows() const { return windowCount_; }
+  unsigned long GetNumberPassingHitCount() const { return hitCountPassed_; }
+
  private:
 
   /**
@@ -43,6 +51,9 @@ class FPTTimeWindow
   double time_window_;
   double time_window_separation_;
 
+  unsigned long windowCount_;
+  unsigned long hitCountPassed_;
+
   TriggerHitListPtr FPTtimeWindowHits_;
   TriggerHitListPtr FPTtriggerWindowHits_;
 
@@ -0,0 +1,80 @@
+#include "trigger-sim/algorithms/FPTTriggerMerger.h"
+#include <algorithm>
+
+FPTTriggerMerger::FPTTriggerMerger(double max_trigger_length) :
+  max_trigger_length_(max_trigger_length),
+  trigger_window_end_(0),
+  last_window_(false)
+{
+}
+
+void FPTTriggerMerger::Reset()
+{
+  current_.clear();
+  trigger_window_end_ = 0;
+  last_window_ = false;
+}
+
+void FPTTriggerMerger::AddWindow(TriggerHitVector::const_iterator firstHit,
+                                 TriggerHitVector::const_iterator lastHit,
+                                 double startTime, double endTime,
+                                 bool passed, bool isLast,
+                                 TriggerHitVectorVector& triggers)
+{
+  //Check if previous window was above threshold
+  if (!current_.empty()) {
+    // Only form the trigger if the current time window does not overlap with the trigger window (both defined by the time window boundaries and not the hit times), otherwise it might extend the trigger window.
+    double overlap = trigger_window_end_ - startTime;
+    if (overlap < 0)
+      Form(triggers);
+    //If it is the last time window and it overlaps with a previous triggered one , it can extend the trigger or the previous trigger needs to be formed
+    else if (isLast)
+      last_window_ = true;
+  }
+
+  if (passed) {
+    //Check if previous window was above threshold
+    if (!current_.empty()) {
+      // Set the trigger window end to the upper boundary of the current time window
+      trigger_window_end_ = endTime;
+      Merge(firstHit, lastHit);
+      if (current_.back().time > trigger_window_end_)
+        log_debug("Hit in trigger window that was not yet analyzed.");
+
+      //Check if the trigger length is exceeded at this point or if the last time window is reached
+      double trigger_length = current_.back().time - current_.front().time;
+      if (trigger_length > max_trigger_length_ || isLast)
+        Form(triggers);
+    }
+    else {
+      //No previous trigger -> write hits to trigger window
+      current_.insert(current_.end(), firstHit, lastHit);
+      // Set the trigger window end to the upper boundary of the current time window
+      trigger_window_end_ = endTime;
+      // Form a trigger if we are at the last time window.
+      if (isLast)
+        Form(triggers);
+    }
+  }
+  else if (last_window_) {
+    //form the trigger of a previous window if the last time window is not triggered
+    Merge(firstHit, lastHit);
+    Form(triggers);
+  }
+}
+
+void FPTTriggerMerger::Merge(TriggerHitVector::const_iterator firstHit,
+                             TriggerHitVector::const_iterator lastHit)
+{
+  for (TriggerHitVector::const_iterator it = firstHit; it != lastHit; ++it) {
+    // Check if the current element already exists in the trigger
+    if (std::find(current_.begin(), current_.end(), *it) == current_.end())
+      current_.push_back(*it);
+  }
+}
+
+void FPTTriggerMerger::Form(TriggerHitVectorVector& triggers)
+{
+  triggers.push_back(TriggerHitVector());
+  triggers.back().swap(current_);
+}
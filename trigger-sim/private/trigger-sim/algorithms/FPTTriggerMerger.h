@@ -0,0 +1,64 @@
+#ifndef FPT_TRIGGER_MERGER_H
+#define FPT_TRIGGER_MERGER_H
+
+#include "icetray/I3Logging.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+
+/**
+ * @brief Forms the triggers of the Faint Particle Trigger from its time windows.
+ *
+ * The windows that passed the hit count and SLC fraction cuts are added in
+ * time order, each with whether it also passed the Doubles and direction
+ * cuts.  A passing window starts a trigger, or extends the open one if the
+ * two windows overlap, until the trigger is longer than the maximum trigger
+ * length.  The trigger is formed once a window no longer overlaps it, or
+ * at the last window.
+ */
+class FPTTriggerMerger
+{
+ public:
+  /**
+   * @param max_trigger_length If the max_trigger_length is exceeded the trigger is formed.
+   */
+  explicit FPTTriggerMerger(double max_trigger_length);
+
+  ~FPTTriggerMerger() = default;
+
+  /**
+   * Drops the open trigger, for the windows of a new frame.
+   */
+  void Reset();
+
+  /**
+   * Adds the window with the hits [firstHit, lastHit) and the time range
+   * [startTime, endTime).  isLast has to be set for the last window of
+   * the frame.  The triggers this window completes are appended to
+   * triggers, at most two.
+   */
+  void AddWindow(TriggerHitVector::const_iterator firstHit,
+                 TriggerHitVector::const_iterator lastHit,
+                 double startTime, double endTime,
+                 bool passed, bool isLast,
+                 TriggerHitVectorVector& triggers);
+
+ private:
+
+  FPTTriggerMerger();
+
+  // Adds the hits that are not in the open trigger yet
+  void Merge(TriggerHitVector::const_iterator firstHit,
+             TriggerHitVector::const_iterator lastHit);
+  void Form(TriggerHitVectorVector& triggers);
+
+  double max_trigger_length_;
+
+  // The hits of the open trigger, and the end of its last window
+  TriggerHitVector current_;
+  double trigger_window_end_;
+  // The last window overlaps the open trigger
+  bool last_window_;
+
+  SET_LOGGER("FPTTriggerMerger");
+};
+
+#endif // FPT_TRIGGER_MERGER_H
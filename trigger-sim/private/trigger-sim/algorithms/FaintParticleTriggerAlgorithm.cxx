@@ -8,13 +8,24 @@
 
 #include <trigger-sim/algorithms/FaintParticleTriggerAlgorithm.h>
 #include <trigger-sim/algorithms/FPTTimeWindow.h>
+#include <trigger-sim/algorithms/FPTTriggerMerger.h>
 #include <boost/foreach.hpp>
 #include <boost/assign/std/vector.hpp>
+#include <algorithm>
+#include <chrono>
 #include "trigger-sim/algorithms/TriggerHit.h"
 #include "dataclasses/geometry/I3Geometry.h"
-#include <dataclasses/I3Direction.h>
-#include <icetray/I3Units.h>
+#include <trigger-sim/algorithms/FPTHistogram.h>
 using namespace boost::assign;
+
+namespace {
+  typedef std::chrono::steady_clock CutClock;
+
+  double Seconds(CutClock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+  }
+}
+
   double double_velocity_min_;
   double double_velocity_max_;
   unsigned int double_min_;
@@ -22,7 +33,7 @@ using namespace boost::assign;
   unsigned int zenith_histogram_min_;
   double histogram_binning_;
   double slcfraction_min_;
-FaintParticleTriggerAlgorithm::FaintParticleTriggerAlgorithm(double time_window,double time_window_separation, double max_trigger_length, unsigned int hit_min,unsigned int hit_max,double double_velocity_min,double double_velocity_max, unsigned int double_min,unsigned int azimuth_histogram_min,unsigned int zenith_histogram_min, double histogram_binning, double slcfraction_min,  I3GeometryConstPtr Geometry,int domSet, I3MapKeyVectorIntConstPtr customDomSets) : 
+FaintParticleTriggerAlgorithm::FaintParticleTriggerAlgorithm(double time_window,double time_window_separation, double max_trigger_length, unsigned int hit_min,unsigned int hit_max,double double_velocity_min,double double_velocity_max, unsigned int double_min,unsigned int azimuth_histogram_min,unsigned int zenith_histogram_min, double histogram_binning, double slcfraction_min,  I3GeometryConstPtr Geometry,int domSet, I3MapKeyVectorIntConstPtr customDomSets, DOMPositionTableConstPtr positions) : 
   TriggerService(domSet, customDomSets),  
   time_window_(time_window),
   time_window_separation_(time_window_separation),
@@ -36,9 +47,28 @@ FaintParticleTriggerAlgorithm::FaintParticleTriggerAlgorithm(double time_window,
   zenith_histogram_min_(zenith_histogram_min), 
   histogram_binning_(histogram_binning), 
   slcfraction_min_(slcfraction_min),
-  geo_(Geometry)
+  geo_(Geometry),
+  positions_(positions),
+  doubleKernel_(double_velocity_min, double_velocity_max),
+  binSize_(FPTAngleBinning::BinSizeFromSetting(histogram_binning)),
+  zenithBinning_(0, 180, binSize_),
+  azimuthBinning_(0, 360, binSize_),
+  evaluationMode_(FULL_EVALUATION),
+  useCompiledKernels_(true),
+  compiledCountDoubles_(NULL)
  
 {
+  if (!positions_ && geo_)
+    positions_ = DOMPositionTablePtr(new DOMPositionTable(*geo_));
+  if (!positions_)
+    log_fatal("FaintParticleTriggerAlgorithm needs either a geometry or a DOM position table.");
+
+  cutPassCounts_.assign(N_CUTS, 0);
+  cutTimes_.assign(N_CUTS, 0.);
+
+  // Known configurations get kernels compiled for their settings
+  if (FPTKernels33001::Matches(binSize_, double_velocity_min_, double_velocity_max_))
+    compiledCountDoubles_ = &FaintParticleTriggerAlgorithm::CountDoublesCompiled<FPTKernels33001>;
 
   log_debug("FaintParticleTriggerAlgorithm configuration:");
   log_debug("  Time Window = %f", time_window_);
@@ -72,178 +102,225 @@ void FaintParticleTriggerAlgorithm::Trigger()
   triggerCount_ = 0;
   triggerIndex_ = 0;
 
+  if (evaluationMode_ == ROLLING_PAIR_CACHE) {
+    // Only the rolling mode needs the cache, build it on first use
+    if (!pairCache_)
+      pairCache_.reset(new FPTPairCache(doubleKernel_, binSize_));
+    pairCache_->Reset(*hits_, *positions_);
+  }
+
   TriggerHitIterPairVectorPtr timeWindows;
   //Keep track of the time window boundaries to avoid overlapping triggers
   std::vector<std::pair<double, double>> timeWindowRange;
+  CutClock::time_point cutStart;
+  if (cutTiming_)
+    cutStart = CutClock::now();
   std::tie(timeWindows, timeWindowRange) = FPTtimeWindow.FPTFixedTimeWindows(hits_, time_window_separation_);
-  double trigger_window_end;
-
+  if (cutTiming_)
+    cutTimes_[HIT_COUNT_CUT] += Seconds(CutClock::now() - cutStart);
+  windowCount_ = FPTtimeWindow.GetNumberOfWindows();
+  cutPassCounts_[HIT_COUNT_CUT] = FPTtimeWindow.GetNumberPassingHitCount();
+  cutPassCounts_[SLC_FRACTION_CUT] = timeWindows->size();
   // If the vector is empty, there are no time windows for this string
   if (timeWindows->empty()) {
     log_debug("No valid time windows for this string");
     return;
   }
   log_debug("Found %zd triggered time windows", timeWindows->size());
-  TriggerHitVectorPtr timeHits_current(new TriggerHitVector);
-  //bool indicating that the last time window is analyzed and that there is an overlap with a previously triggered time window
-  bool last_window = false;
+  // Forms the triggers from the windows and whether they passed the second and third cut
+  FPTTriggerMerger merger(max_trigger_length_);
+  TriggerHitVectorVector formed;
   // Loop over the time windows and pull out the hits in each
   int timeWindowRange_ind = 0;
   for (TriggerHitIterPairVector::const_iterator timeWindowIter = timeWindows->begin(); 
        timeWindowIter != timeWindows->end(); 
        timeWindowIter++,timeWindowRange_ind++) {
-    // Create a vector of the hits in this time window
-    TriggerHitVectorPtr timeHits(new TriggerHitVector);
     // Get the window boundaries
     TriggerHitVector::const_iterator firstHit = timeWindowIter->first;
     TriggerHitVector::const_iterator lastHit  = timeWindowIter->second;
-    
-    // Iterate over the hits and pull out the ones for this window
-    for (TriggerHitVector::const_iterator hitIter = firstHit; 
-     hitIter != lastHit; 
-     hitIter++){
-      timeHits->push_back(*hitIter);
-    }
     auto [startTime, endTime] = timeWindowRange[timeWindowRange_ind];
-      
-    //Check if previous window was above threshold
-    if (timeHits_current->size()>0){
-   // Only form the trigger if the current time window does not overlap with the trigger window (both defined by the time window boundaries and not the hit times), otherwise it might extend the trigger window.
-         double overlap = trigger_window_end-startTime;
-         if ((overlap < 0) ){             
-             triggers_.push_back(*timeHits_current);
-             triggerCount_++;
-             log_debug("Trigger! Count = %d", triggerCount_);
-             timeHits_current->clear();
-            }
-        //If it is the last time window and it overlaps with a previous triggered one , it can extend the trigger or the previous trigger needs to be formed
-        else if (timeWindowIter == timeWindows->end() - 1){
-            last_window = true;
-        }
-     }
 
     //Second cut: number of Doubles
-    std::vector<int> Double_Indices = DoubleThreshold(timeHits, geo_);
-    unsigned int number_doubles = Double_Indices.size()/2;
-    if (number_doubles >= double_min_ ){
-        
-            // Calculate the direction for all Doubles, histogram them and return the count of the maximum bin
-            std::vector<double> dir = getDirection(timeHits,Double_Indices,geo_);
-            unsigned int number_azimuth = dir[0];
-            unsigned int number_zenith = dir[1];
-            //Third cut: Minimum clustering of Doubles in zenith and azimuth
-            if (number_zenith > zenith_histogram_min_ && number_azimuth > azimuth_histogram_min_) {
-
-                 //Check if previous window was above threshold
-                 if (timeHits_current->size()>0){
-                     // Set the trigger window end to the upper boundary of the current time window 
-                     trigger_window_end = endTime;
-                     for (auto it = timeHits->begin(); it != timeHits->end(); ++it) {
-                        // Check if the current element already exists in timeHits_current
-                        if (std::find(timeHits_current->begin(), timeHits_current->end(), *it) == timeHits_current->end()) {
-                            // If it doesn't exist, insert it into timeHits_current
-                            timeHits_current->push_back(*it);
-                        }
-                    }
-                     if (timeHits_current->back().time> trigger_window_end){
-                         log_debug("Hit in trigger window that was not yet analyzed.");}
-
-                     //Check if the trigger length is exceeded at this point or if the last time window is reached
-                     double trigger_length = timeHits_current->back().time - timeHits_current->front().time;
-                     if (trigger_length > max_trigger_length_|| timeWindowIter == timeWindows->end() - 1){
-                         //max trigger length exceeded -> form trigger
-                         triggers_.push_back(*timeHits_current);
-                         triggerCount_++;
-                         log_debug("Trigger! Count = %d", triggerCount_);
-                         timeHits_current->clear();
-                          }                                              
-                 }                             
-                else {
-                    
-                    
-                    //No previous trigger -> write hits to trigger window                  
-                    for (auto it = timeHits->begin(); it != timeHits->end(); ++it) {
-                            timeHits_current->push_back(*it);
-                        }   
-                    // Set the trigger window end to the upper boundary of the current time window 
-                    trigger_window_end = endTime;
-                    // Form a trigger if we are at the last time window.
-                    if (timeWindowIter == timeWindows->end() - 1) {
-                         triggers_.push_back(*timeHits_current);
-                         triggerCount_++;
-                         log_debug("Trigger! Count = %d", triggerCount_);       
-                           }
-                       }
-                    
-                }
-                else {
-                    //form the trigger of a previous window if the last time window is not triggered
-                    if (last_window){
-                        for (auto it = timeHits->begin(); it != timeHits->end(); ++it) {
-                        // Check if the current element already exists in timeHits_current
-                        if (std::find(timeHits_current->begin(), timeHits_current->end(), *it) == timeHits_current->end()) {
-                            // If it doesn't exist, insert it into timeHits_current
-                            timeHits_current->push_back(*it);
-                            }
-                        }
-                        triggers_.push_back(*timeHits_current);
-                        triggerCount_++;
-                        log_debug("Trigger! Count = %d", triggerCount_);
-                        timeHits_current->clear();
-
-                        }
-                    }
-                }
-        else {
-            //form the trigger of a previous window if the last time window is not triggered
-            if (last_window){
-                for (auto it = timeHits->begin(); it != timeHits->end(); ++it) {
-                        // Check if the current element already exists in timeHits_current
-                        if (std::find(timeHits_current->begin(), timeHits_current->end(), *it) == timeHits_current->end()) {
-                            // If it doesn't exist, insert it into timeHits_current
-                            timeHits_current->push_back(*it);
-                        }
-                }
-                triggers_.push_back(*timeHits_current);
-                triggerCount_++;
-                log_debug("Trigger! Count = %d", triggerCount_);
-                timeHits_current->clear();
-      }       
-     }
-   }
+    WindowCounts counts = CountDoubles(firstHit, lastHit);
+    bool passed = false;
+    if (counts.doubles >= double_min_) {
+      cutPassCounts_[DOUBLES_CUT]++;
+
+      //Third cut: Minimum clustering of Doubles in zenith and azimuth,
+      //the counts are the maximum bins of the direction histograms of all Doubles
+      if (counts.zenith > zenith_histogram_min_ && counts.azimuth > azimuth_histogram_min_) {
+        cutPassCounts_[DIRECTION_CUT]++;
+        passed = true;
+      }
+    }
+
+    merger.AddWindow(firstHit, lastHit, startTime, endTime, passed,
+                     timeWindowIter == timeWindows->end() - 1, formed);
+    for (TriggerHitVectorVector::iterator trigger = formed.begin(); trigger != formed.end(); trigger++) {
+      AddTrigger(*trigger);
+      log_debug("Trigger! Count = %d", triggerCount_);
+    }
+    formed.clear();
+  }
  }
 }
 
-std::vector<int> FaintParticleTriggerAlgorithm::DoubleThreshold(TriggerHitVectorPtr timeWindowHits,I3GeometryConstPtr Geometry)
+FaintParticleTriggerAlgorithm::EvaluationMode FaintParticleTriggerAlgorithm::EvaluationModeFromString(const std::string& name)
+{
+  if (name == "full")
+    return FULL_EVALUATION;
+  if (name == "rolling")
+    return ROLLING_PAIR_CACHE;
+  if (name == "early_exit")
+    return EARLY_EXIT;
+  log_fatal("Unknown FPT evaluation mode '%s'. Use 'full', 'rolling' or 'early_exit'.", name.c_str());
+  return FULL_EVALUATION;
+}
+
+std::string FaintParticleTriggerAlgorithm::GetCutName(size_t cut) const
+{
+  switch (cut) {
+    case HIT_COUNT_CUT: return "cut1_hit_count";
+    case DOUBLES_CUT: return "cut2_doubles";
+    case DIRECTION_CUT: return "cut3_direction";
+    case SLC_FRACTION_CUT: return "cut4_slc_fraction";
+    default: return TriggerService::GetCutName(cut);
+  }
+}
+
+FaintParticleTriggerAlgorithm::WindowCounts FaintParticleTriggerAlgorithm::CountDoubles(TriggerHitVector::const_iterator firstHit,
+                                                                                        TriggerHitVector::const_iterator lastHit)
+{
+  if (evaluationMode_ == ROLLING_PAIR_CACHE) {
+    CutClock::time_point cutStart;
+    if (cutTiming_)
+      cutStart = CutClock::now();
+    // The windows only move forward, so the cache only has to add the pairs of new hits
+    pairCache_->Advance(firstHit - hits_->begin(), lastHit - hits_->begin());
+    WindowCounts counts;
+    counts.doubles = pairCache_->GetNumberOfDoubles();
+    counts.azimuth = pairCache_->GetMaxAzimuthCount();
+    counts.zenith = pairCache_->GetMaxZenithCount();
+    if (cutTiming_)
+      cutTimes_[DOUBLES_CUT] += Seconds(CutClock::now() - cutStart);
+    return counts;
+  }
+  if (useCompiledKernels_ && compiledCountDoubles_)
+    return (this->*compiledCountDoubles_)(firstHit, lastHit);
+  return CountDoublesWith(FPTRuntimeKernels(doubleKernel_, zenithBinning_, azimuthBinning_), firstHit, lastHit);
+}
+
+template <class Kernels>
+FaintParticleTriggerAlgorithm::WindowCounts FaintParticleTriggerAlgorithm::CountDoublesCompiled(TriggerHitVector::const_iterator firstHit,
+                                                                                                TriggerHitVector::const_iterator lastHit)
+{
+  return CountDoublesWith(Kernels(), firstHit, lastHit);
+}
+
+template <class Kernels>
+FaintParticleTriggerAlgorithm::WindowCounts FaintParticleTriggerAlgorithm::CountDoublesWith(const Kernels& kernels,
+                                                                                            TriggerHitVector::const_iterator firstHit,
+                                                                                            TriggerHitVector::const_iterator lastHit)
+{
+  WindowCounts counts;
+  CutClock::time_point cutStart;
+  if (cutTiming_)
+    cutStart = CutClock::now();
+  if (evaluationMode_ == EARLY_EXIT) {
+    counts = CountDoublesEarlyExit(kernels, firstHit, lastHit);
+    if (cutTiming_)
+      cutTimes_[DOUBLES_CUT] += Seconds(CutClock::now() - cutStart);
+    return counts;
+  }
+
+  // The Doubles of the window, as DoubleThreshold finds them
+  std::vector<int> Double_Indices;
+  FillWindowArrays(firstHit, lastHit);
+  kernels.FindDoubles(windowArrays_, Double_Indices);
+  counts.doubles = Double_Indices.size()/2;
+  counts.azimuth = 0;
+  counts.zenith = 0;
+  if (cutTiming_) {
+    CutClock::time_point cutEnd = CutClock::now();
+    cutTimes_[DOUBLES_CUT] += Seconds(cutEnd - cutStart);
+    cutStart = cutEnd;
+  }
+  if (counts.doubles >= double_min_) {
+    // Histogram the directions of all Doubles like getDirection and take the counts of the maximum bins
+    typename Kernels::ZenithHistogram hist_zenith = kernels.MakeZenithHistogram();
+    typename Kernels::AzimuthHistogram hist_azimuth = kernels.MakeAzimuthHistogram();
+    for (std::vector<int>::const_iterator ind = Double_Indices.begin(); ind != Double_Indices.end(); ind += 2) {
+      double zenith, azimuth;
+      FPTPairDirection(windowArrays_.x[ind[1]] - windowArrays_.x[ind[0]],
+                       windowArrays_.y[ind[1]] - windowArrays_.y[ind[0]],
+                       windowArrays_.z[ind[1]] - windowArrays_.z[ind[0]], zenith, azimuth);
+      hist_zenith.Fill(zenith);
+      hist_azimuth.Fill(azimuth);
+    }
+    counts.azimuth = hist_azimuth.GetMaxCount();
+    counts.zenith = hist_zenith.GetMaxCount();
+    if (cutTiming_)
+      cutTimes_[DIRECTION_CUT] += Seconds(CutClock::now() - cutStart);
+  }
+  return counts;
+}
+
+template <class Kernels>
+FaintParticleTriggerAlgorithm::WindowCounts FaintParticleTriggerAlgorithm::CountDoublesEarlyExit(const Kernels& kernels,
+                                                                                                 TriggerHitVector::const_iterator firstHit,
+                                                                                                 TriggerHitVector::const_iterator lastHit)
+{
+  /*Count the Doubles row by row and stream their directions into the histograms.
+Histogram counts only grow, so the loop stops as soon as both cuts are passed, or
+when the pairs that are left can no longer pass the second or the third cut.
+*/
+  WindowCounts counts;
+  counts.doubles = 0;
+  counts.azimuth = 0;
+  counts.zenith = 0;
+
+  FillWindowArrays(firstHit, lastHit);
+
+  typename Kernels::ZenithHistogram hist_zenith = kernels.MakeZenithHistogram();
+  typename Kernels::AzimuthHistogram hist_azimuth = kernels.MakeAzimuthHistogram();
+  std::vector<int> partners;
+  int n_hits = windowArrays_.Size();
+  for (int ind_hit_1 = 0; ind_hit_1 < n_hits; ind_hit_1++) {
+    partners.clear();
+    kernels.FindPartners(windowArrays_, ind_hit_1, ind_hit_1 + 1, n_hits, partners);
+    for (std::vector<int>::const_iterator ind_hit_2 = partners.begin(); ind_hit_2 != partners.end(); ind_hit_2++) {
+      counts.doubles++;
+      double zenith, azimuth;
+      FPTPairDirection(windowArrays_.x[*ind_hit_2] - windowArrays_.x[ind_hit_1],
+                       windowArrays_.y[*ind_hit_2] - windowArrays_.y[ind_hit_1],
+                       windowArrays_.z[*ind_hit_2] - windowArrays_.z[ind_hit_1], zenith, azimuth);
+      counts.zenith = std::max(counts.zenith, hist_zenith.Fill(zenith));
+      counts.azimuth = std::max(counts.azimuth, hist_azimuth.Fill(azimuth));
+      if (counts.doubles >= double_min_ && counts.zenith > zenith_histogram_min_ && counts.azimuth > azimuth_histogram_min_)
+        return counts;
+    }
+
+    // Pairs of the rows that are still to come
+    unsigned long long remaining = static_cast<unsigned long long>(n_hits - ind_hit_1 - 1)*(n_hits - ind_hit_1 - 2)/2;
+    if (counts.doubles + remaining < double_min_)
+      return counts;
+    if (counts.doubles >= double_min_ &&
+        (counts.zenith + remaining <= zenith_histogram_min_ || counts.azimuth + remaining <= azimuth_histogram_min_))
+      return counts;
+  }
+  return counts;
+}
+
+std::vector<int> FaintParticleTriggerAlgorithm::DoubleThreshold(TriggerHitVector::const_iterator firstHit, TriggerHitVector::const_iterator lastHit, I3GeometryConstPtr Geometry)
 {
  /*Calculate all hit pair combinations in the time window except for combinations of the same element and commutative combinations.
-If the hit pair satisfies a velocity cut it is called a Double. The indices of the Doubles are returned
+If the hit pair satisfies a velocity cut it is called a Double. The indices of the Doubles, counted from firstHit, are returned
 */
     std::vector<int> Doubles;
-    int ind_hit_1 = -1;
-    
-    for (TriggerHitVector::const_iterator hitIter1 = timeWindowHits->begin(); hitIter1 != timeWindowHits->end(); hitIter1++) {   
-        ind_hit_1++;
-        int ind_hit_2 = ind_hit_1;
-            for (TriggerHitVector::const_iterator hitIter2 = hitIter1+1; hitIter2 != timeWindowHits->end(); hitIter2++) {
-                ind_hit_2++;
-                TriggerHit hit1 = *hitIter1;
-                TriggerHit hit2 = *hitIter2;
-                OMKey omkey1(hit1.string, hit1.pos);
-                OMKey omkey2(hit2.string, hit2.pos);
-                if (omkey1 != omkey2){
-
-                    double distance = getDistance(*hitIter1, *hitIter2, geo_);
-                    double time = abs(hit2.time - hit1.time);
-                    //in km/s
-                    double velocity = 1e6*distance/time;
-                    if (velocity> double_velocity_min_ && velocity <double_velocity_max_){
-                        Doubles.push_back(ind_hit_1);
-                        Doubles.push_back(ind_hit_2);
-                        }                    
-                    }
-                }                    
-            }             
+
+    // Let the (vectorized) kernel run the pair loop
+    FillWindowArrays(firstHit, lastHit);
+    doubleKernel_.FindDoubles(windowArrays_, Doubles);
     return Doubles;
 }
 
@@ -252,74 +329,62 @@ If the hit pair satisfies a velocity cut it is called a Double. The indices of t
 double FaintParticleTriggerAlgorithm::getDistance(TriggerHit hit1, TriggerHit hit2,I3GeometryConstPtr Geometry)
 {
   //function from SLOP trigger to calculate the distance between two OMs
-
-  I3OMGeoMap::const_iterator geo_iterator_1 = geo_->omgeo.find(OMKey(hit1.string, hit1.pos));
-  I3OMGeoMap::const_iterator geo_iterator_2 = geo_->omgeo.find(OMKey(hit2.string, hit2.pos));
-  double x1 = geo_iterator_1->second.position.GetX();
-  double y1 = geo_iterator_1->second.position.GetY();
-  double z1 = geo_iterator_1->second.position.GetZ();
-  double x2 = geo_iterator_2->second.position.GetX();
-  double y2 = geo_iterator_2->second.position.GetY();
-  double z2 = geo_iterator_2->second.position.GetZ(); 
-  double diff = sqrt( pow(x2 - x1, 2) + pow(y2 - y1, 2) + pow(z2 - z1, 2) );
+  const double* pos1 = positions_->GetPosition(GetDOMIndex(hit1));
+  const double* pos2 = positions_->GetPosition(GetDOMIndex(hit2));
+  double diff = sqrt( pow(pos2[0] - pos1[0], 2) + pow(pos2[1] - pos1[1], 2) + pow(pos2[2] - pos1[2], 2) );
   return diff;
 }
 
-std::vector<double> FaintParticleTriggerAlgorithm::getDirection(TriggerHitVectorPtr timeWindowHits, std::vector<int> Double_Indices,I3GeometryConstPtr Geometry)
+std::vector<double> FaintParticleTriggerAlgorithm::getDirection(TriggerHitVector::const_iterator firstHit, const std::vector<int>& Double_Indices,I3GeometryConstPtr Geometry)
 {
     /*Calculate the direction for each Double and histogram the values with specified binning parameter. The value of the bin with the maximum number of entries for zenith and azimuth is returned.
     */
-    std::vector<double> final_zen_azi;
-    std::vector<double> Zenith_values;
-    std::vector<double> Azimuth_values;
+    FPTAngleHistogram hist_zenith(zenithBinning_);
+    FPTAngleHistogram hist_azimuth(azimuthBinning_);
     int loop_end = Double_Indices.size();
     for (int j = 0; j <= loop_end-2; j+= 2) {
-        TriggerHit hit1 = (*timeWindowHits)[Double_Indices[j]];
-        TriggerHit hit2 = (*timeWindowHits)[Double_Indices[j+1]]; 
-        I3OMGeoMap::const_iterator geo_iterator_1 = geo_->omgeo.find(OMKey(hit1.string, hit1.pos));
-        I3OMGeoMap::const_iterator geo_iterator_2 = geo_->omgeo.find(OMKey(hit2.string, hit2.pos));
-
-        double x1 = geo_iterator_1->second.position.GetX();
-        double y1 = geo_iterator_1->second.position.GetY();
-        double z1 = geo_iterator_1->second.position.GetZ();
-        double x2 = geo_iterator_2->second.position.GetX();
-        double y2 = geo_iterator_2->second.position.GetY();
-        double z2 = geo_iterator_2->second.position.GetZ();
-        I3Direction dir1((x2-x1),(y2-y1),(z2-z1));
-        Zenith_values.push_back(dir1.GetZenith()/I3Units::degree);
-        Azimuth_values.push_back(dir1.GetAzimuth()/I3Units::degree);
-
-      
+        const double* pos1 = positions_->GetPosition(GetDOMIndex(firstHit[Double_Indices[j]]));
+        const double* pos2 = positions_->GetPosition(GetDOMIndex(firstHit[Double_Indices[j+1]]));
+        double zenith, azimuth;
+        FPTPairDirection((pos2[0]-pos1[0]),(pos2[1]-pos1[1]),(pos2[2]-pos1[2]), zenith, azimuth);
+        hist_zenith.Fill(zenith);
+        hist_azimuth.Fill(azimuth);
     }
-    std::vector<double> hist_zenith = CalcHistogram(Zenith_values, 0, 180, histogram_binning_);
-    std::vector<double> hist_azimuth = CalcHistogram(Azimuth_values, 0, 360, histogram_binning_);
-    final_zen_azi.insert(final_zen_azi.end(), hist_azimuth.begin(), hist_azimuth.end());
-    final_zen_azi.insert(final_zen_azi.end(), hist_zenith.begin(), hist_zenith.end());     
+    std::vector<double> final_zen_azi;
+    final_zen_azi.push_back(hist_azimuth.GetMaxCount());
+    final_zen_azi.push_back(hist_zenith.GetMaxCount());
     return final_zen_azi;
 }
 
+void FaintParticleTriggerAlgorithm::FillWindowArrays(TriggerHitVector::const_iterator firstHit,
+                                                     TriggerHitVector::const_iterator lastHit)
+{
+  // Structure-of-arrays form of the window for the kernel, resolving each DOM once
+  windowArrays_.Clear();
+  windowArrays_.Reserve(lastHit - firstHit);
+  for (TriggerHitVector::const_iterator hitIter = firstHit; hitIter != lastHit; hitIter++) {
+    const double* pos = positions_->GetPosition(GetDOMIndex(*hitIter));
+    windowArrays_.PushBack(pos[0], pos[1], pos[2], hitIter->time, hitIter->string, hitIter->pos);
+  }
+}
+
+int FaintParticleTriggerAlgorithm::GetDOMIndex(const TriggerHit& hit) const
+{
+  int index = positions_->GetIndex(hit.string, hit.pos);
+  if (index < 0)
+    log_fatal("OMKey(%d,%u) not part of geometry", hit.string, hit.pos);
+  return index;
+}
+
 
 std::vector<double> FaintParticleTriggerAlgorithm::CalcHistogram(std::vector<double> Angles, int lower_bound, int upper_bound, int bin_size) {
-    // Histogram the input values
-    std::vector<int> hist_vals;
-    std::vector<double> mean_angle_vals, Returnval;
-
-    for (int j = lower_bound; j < upper_bound; j += bin_size) {
-        // Include 180 and 360° in the last bins 160-180. 
-        int upper_bin_size = j + bin_size;
-        if (j == upper_bound - bin_size) {
-            upper_bin_size = j + bin_size + 1;
-        }
-        int hist_counter = 0;
-        std::vector<double> angle_values;
-        for (double k : Angles) {
-            if (k >= j && k < upper_bin_size) {
-                hist_counter += 1;
-                angle_values.push_back(k);
-            }
-        }
-        hist_vals.push_back(hist_counter);
+    // Histogram the input values in a single pass. 180 and 360° are included in the last bins (e.g. 160-180).
+    FPTAngleBinning binning(lower_bound, upper_bound, bin_size);
+    FPTAngleHistogram histogram(binning);
+    for (double k : Angles) {
+        histogram.Fill(k);
     }
-    Returnval.push_back((double)*std::max_element(hist_vals.begin(), hist_vals.end()));
+    std::vector<double> Returnval;
+    Returnval.push_back((double)histogram.GetMaxCount());
     return Returnval;
 }
\ No newline at end of file
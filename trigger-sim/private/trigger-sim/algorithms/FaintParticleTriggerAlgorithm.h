@@ -10,10 +10,16 @@
 #ifndef FAINT_PARTICLE_TRIGGER_ALGORITHM_H
 #define FAINT_PARTICLE_TRIGGER_ALGORITHM_H
 
+#include <memory>
 #include "icetray/I3Logging.h"
 #include "trigger-sim/algorithms/TriggerHit.h"
 #include "dataclasses/geometry/I3Geometry.h"
 #include "trigger-sim/algorithms/TriggerService.h"
+#include "trigger-sim/utilities/DOMPositionTable.h"
+#include "trigger-sim/algorithms/FPTDoubleKernel.h"
+#include "trigger-sim/algorithms/FPTHistogram.h"
+#include "trigger-sim/algorithms/FPTFixedKernels.h"
+#include "trigger-sim/algorithms/FPTPairCache.h"
 
 /**
 The FaintParticleTriggerAlgorithm looks for faint signatures of particles dominantly producing SLC hits and receives also SLC hits as an input. Four cuts are calculated for each time window. All cuts are described on https://wiki.icecube.wisc.edu/index.php/Faint_Particle_Trigger. Cuts 1 and 4 are calculated in the FPTTimeWindow.h class. 
@@ -37,25 +43,67 @@ class FaintParticleTriggerAlgorithm : public TriggerService
  * @param double_min The minimum number of Doubles required for triggering.
  * @param azimuth_histogram_min The minimum number of entries in the azimuth histogram. (DC version)
  * @param zenith_histogram_min The minimum number of entries in the zenith histogram.(DC version)
- * @param histogram_binning The binning value for the azimuth and zenith histograms.
+ * @param histogram_binning The binning value for the azimuth and zenith histograms, in whole degrees (at least 1).
  * @param slcfraction_min The minimum slc fraction of the time window that is requried for triggering.
  * @param Geometry Pointer to the I3Geometry
  * @param domSet The DOMSet
  * @param customDomSets 
+ * @param positions Dense DOM position table built from Geometry. Built here if not given.
  */
 
  public:
-  FaintParticleTriggerAlgorithm(double time_window,double time_window_separation, double max_trigger_length,  unsigned int hit_min,unsigned int hit_max,double double_velocity_min,double double_velocity_max, unsigned int double_min,unsigned int azimuth_histogram_min,unsigned int zenith_histogram_min, double histogram_binning, double slcfraction_min, I3GeometryConstPtr Geometry,int domSet, I3MapKeyVectorIntConstPtr customDomSets);
+  FaintParticleTriggerAlgorithm(double time_window,double time_window_separation, double max_trigger_length,  unsigned int hit_min,unsigned int hit_max,double double_velocity_min,double double_velocity_max, unsigned int double_min,unsigned int azimuth_histogram_min,unsigned int zenith_histogram_min, double histogram_binning, double slcfraction_min, I3GeometryConstPtr Geometry,int domSet, I3MapKeyVectorIntConstPtr customDomSets, DOMPositionTableConstPtr positions = DOMPositionTableConstPtr());
 
 
   ~FaintParticleTriggerAlgorithm() {};
 
+  /**
+   * How the Doubles and direction histograms of the time windows are computed.
+   * All modes give the same triggers.
+   */
+  enum EvaluationMode {
+    FULL_EVALUATION = 0,    // every window from scratch
+    ROLLING_PAIR_CACHE = 1, // overlapping windows share their hit pairs
+    EARLY_EXIT = 2          // stop the pair loop as soon as the cuts are decided
+  };
+
+  void SetEvaluationMode(EvaluationMode mode) { evaluationMode_ = mode; }
+  EvaluationMode GetEvaluationMode() const { return evaluationMode_; }
+
+  /**
+   * Parses the mode names used in module parameters ("full", "rolling", "early_exit").
+   */
+  static EvaluationMode EvaluationModeFromString(const std::string& name);
+
+  /**
+   * Whether the histogram binning and the Double velocities are those of a
+   * configuration with compiled kernels (see FPTFixedKernels.h).  These are
+   * used for 'full' and 'early_exit' unless switched off, and give the
+   * same triggers as the run time ones.
+   */
+  bool HasCompiledKernels() const { return compiledCountDoubles_ != NULL; }
+  void SetUseCompiledKernels(bool use) { useCompiledKernels_ = use; }
+
   void Trigger();
 
+  /**
+   * The cuts are numbered as above, but applied in the order 1, 4, 2, 3,
+   * so the pass count of a cut is of the windows that passed it and the
+   * cuts before it in that order.  Cuts 1 and 4 are decided in one loop
+   * over the windows, its time is counted for cut 1.  With 'rolling' and
+   * 'early_exit' the Doubles and their directions are found together, and
+   * their time is counted for cut 2.
+   */
+  std::string GetCutName(size_t cut) const;
+
 
-  std::vector<int> DoubleThreshold(TriggerHitVectorPtr timeWindowHits, I3GeometryConstPtr Geometry);
+  /**
+   * The Doubles and direction histograms of the time window [firstHit, lastHit)
+   * of the hits, without copying them.  The Double indices count from firstHit.
+   */
+  std::vector<int> DoubleThreshold(TriggerHitVector::const_iterator firstHit, TriggerHitVector::const_iterator lastHit, I3GeometryConstPtr Geometry);
   double getDistance(TriggerHit hit1,TriggerHit hit2,I3GeometryConstPtr Geometry);
-  std::vector<double> getDirection(TriggerHitVectorPtr timeWindowHits, std::vector<int> Double_Indices, I3GeometryConstPtr Geometry);
+  std::vector<double> getDirection(TriggerHitVector::const_iterator firstHit, const std::vector<int>& Double_Indices, I3GeometryConstPtr Geometry);
   std::vector<double> CalcHistogram(std::vector<double> Angles, int lower_bound, int upper_bound, int bin_size);
  private:
 
@@ -72,6 +120,60 @@ class FaintParticleTriggerAlgorithm : public TriggerService
   double histogram_binning_;
   double slcfraction_min_;
   I3GeometryConstPtr geo_;
+  DOMPositionTableConstPtr positions_;
+  FPTDoubleKernel doubleKernel_;
+  // Scratch buffer for the hits of the current time window
+  FPTHitArrays windowArrays_;
+  // histogram_binning_ in whole degrees
+  int binSize_;
+  // Bins of the zenith and azimuth histograms of the third cut
+  FPTAngleBinning zenithBinning_;
+  FPTAngleBinning azimuthBinning_;
+  EvaluationMode evaluationMode_;
+  // Only built for ROLLING_PAIR_CACHE
+  std::unique_ptr<FPTPairCache> pairCache_;
+  bool useCompiledKernels_;
+
+  enum Cut {
+    HIT_COUNT_CUT = 0,
+    DOUBLES_CUT = 1,
+    DIRECTION_CUT = 2,
+    SLC_FRACTION_CUT = 3,
+    N_CUTS = 4
+  };
+
+  // What the second and third cut need to know about a time window.  With
+  // EARLY_EXIT the counts are only complete enough to decide both cuts.
+  struct WindowCounts {
+    unsigned int doubles;
+    unsigned int azimuth;
+    unsigned int zenith;
+  };
+
+  WindowCounts CountDoubles(TriggerHitVector::const_iterator firstHit,
+                            TriggerHitVector::const_iterator lastHit);
+  // FULL_EVALUATION and EARLY_EXIT with the given kernels
+  template <class Kernels>
+  WindowCounts CountDoublesWith(const Kernels& kernels,
+                                TriggerHitVector::const_iterator firstHit,
+                                TriggerHitVector::const_iterator lastHit);
+  template <class Kernels>
+  WindowCounts CountDoublesEarlyExit(const Kernels& kernels,
+                                     TriggerHitVector::const_iterator firstHit,
+                                     TriggerHitVector::const_iterator lastHit);
+  template <class Kernels>
+  WindowCounts CountDoublesCompiled(TriggerHitVector::const_iterator firstHit,
+                                    TriggerHitVector::const_iterator lastHit);
+
+  typedef WindowCounts (FaintParticleTriggerAlgorithm::*CountFunction)(TriggerHitVector::const_iterator,
+                                                                       TriggerHitVector::const_iterator);
+  // CountDoublesCompiled for the kernels matching the configuration, NULL if there are none
+  CountFunction compiledCountDoubles_;
+
+  void FillWindowArrays(TriggerHitVector::const_iterator firstHit,
+                        TriggerHitVector::const_iterator lastHit);
+
+  int GetDOMIndex(const TriggerHit& hit) const;
 
   SET_LOGGER("FaintParticleTriggerAlgorithm");
 };
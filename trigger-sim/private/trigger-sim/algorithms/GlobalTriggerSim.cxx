@@ -17,6 +17,8 @@
 #include <dataclasses/I3Time.h>
 #include "trigger-sim/utilities/ReadoutWindowUtil.h"
 #include <boost/foreach.hpp>
+#include <algorithm>
+#include <cmath>
 using namespace std;
 
 typedef std::map<I3TriggerStatus::Subdetector, I3TriggerReadoutConfig> roconfigmap_t;
@@ -85,100 +87,81 @@ GlobalTriggerSim::Merge(const I3TriggerPairVector& tpTriggers){
     log_debug("passed a null pointer, null iterator, empty hierarchy, or incomplete tree.");
     return I3TriggerHierarchyPtr(new I3TriggerHierarchy() );
   }
-  
+
   /**
-   * Each trigger has a throughput trigger as a parent, so if the size of
-   * the tree is two, this means there is only one trigger in the event.
+   * Sweep over the throughput triggers in order of their start time.
+   * A trigger that starts inside the current window joins it, otherwise
+   * it opens a new one.  Windows without a start time are never merged.
    */
-  if(tpTriggers.size() == 1){
-    // trivial case
-    I3TriggerHierarchyPtr th(new I3TriggerHierarchy() );
-    I3TriggerHierarchy::iterator tt_iter = th->insert( th->begin(), tpTriggers.front().first);
-    th->append_child( tt_iter, tpTriggers.front().second );
-    return th;
-  }
+  vector<size_t> order;
+  order.reserve(tpTriggers.size());
+  for(size_t i = 0; i < tpTriggers.size(); i++)
+    if(!std::isnan(tpTriggers[i].first.GetTriggerTime()))
+      order.push_back(i);
+  size_t nTimed(order.size());
+  for(size_t i = 0; i < tpTriggers.size(); i++)
+    if(std::isnan(tpTriggers[i].first.GetTriggerTime()))
+      order.push_back(i);
+
+  stable_sort(order.begin(), order.begin() + nTimed,
+              [&tpTriggers](size_t a, size_t b){
+                return tpTriggers[a].first.GetTriggerTime() < tpTriggers[b].first.GetTriggerTime();
+              });
 
   I3TriggerHierarchyPtr mergedTriggers(new I3TriggerHierarchy() );
 
-  BOOST_FOREACH( const I3TriggerPair& tpair, tpTriggers ){
-    
-    I3TriggerHierarchy::iterator overlap_iter = FindOverlap( mergedTriggers, tpair.first );
- 
-    if( overlap_iter == mergedTriggers->end() ){
-      // no overlap in the tree
-      I3TriggerHierarchy::iterator tt_iter = mergedTriggers->insert( mergedTriggers->begin() , tpair.first);
-      mergedTriggers->append_child( tt_iter, tpair.second );
-    }else{
-      // found an overlap
-      // if it's already a MERGED we only need to add the child and expand the window
-      if( overlap_iter->GetTriggerKey().GetType() == TriggerKey::MERGED ){
-      	I3TriggerHierarchy::iterator tt_iter = mergedTriggers->append_child(overlap_iter, tpair.first);
-	mergedTriggers->append_child( tt_iter, tpair.second );	
-
-	double t1( overlap_iter->GetTriggerTime() + overlap_iter->GetTriggerLength() );
-	double t2( tpair.first.GetTriggerTime() + tpair.first.GetTriggerLength() );	
+  size_t first(0);
+  while( first < order.size() ){
+    const I3Trigger& tt = tpTriggers[order[first]].first;
+    double earliest_time( tt.GetTriggerTime() );
+    double length( tt.GetTriggerLength() );
+
+    size_t last(first + 1);
+    if( first < nTimed ){
+      for( ; last < nTimed; last++){
+	const I3Trigger& next = tpTriggers[order[last]].first;
+	if( !(next.GetTriggerTime() <= earliest_time + length) )
+	  break;
+
+	// the window grows the same way as when the triggers are
+	// merged one at a time
+	double t1( earliest_time + length );
+	double t2( next.GetTriggerTime() + next.GetTriggerLength() );
 	double latest_time( t1 < t2 ? t2 : t1 );
-	
-	double st1( overlap_iter->GetTriggerTime() );
-	double st2( tpair.first.GetTriggerTime() );
-	double earliest_time( st1 < st2 ? st1 : st2 );
-	// set the times
-	overlap_iter->SetTriggerTime( earliest_time );
-	overlap_iter->SetTriggerLength( latest_time - earliest_time );
+
+	double st1( earliest_time );
+	double st2( next.GetTriggerTime() );
+	earliest_time = st1 < st2 ? st1 : st2;
+	length = latest_time - earliest_time;
       }
-      if( overlap_iter->GetTriggerKey().GetType() == TriggerKey::THROUGHPUT ){
-	// need to create a merged trigger and reparent
-	// there are only two TT to worry about
-	
-	double st1( overlap_iter->GetTriggerTime() );
-	double st2( tpair.first.GetTriggerTime() );
-	double earliest_time( st1 < st2 ? st1 : st2 );
-
-	double lt1( overlap_iter->GetTriggerTime() + overlap_iter->GetTriggerLength() );
-	double lt2( tpair.first.GetTriggerTime() + tpair.first.GetTriggerLength() );
-	double latest_time( lt1 < lt2 ? lt2 : lt1 );
-
-	//need to create a merged trigger
-	TriggerKey mKey(TriggerKey::GLOBAL, TriggerKey::MERGED);
-	I3Trigger mTrigger;
-	mTrigger.GetTriggerKey() = mKey;
-	mTrigger.SetTriggerFired(true);
-	mTrigger.SetTriggerTime( earliest_time );
-	mTrigger.SetTriggerLength( latest_time - earliest_time );
-	 
-	// insert the merged trigger into the tree
-	I3TriggerHierarchy::iterator m_iter = 
-	  mergedTriggers->insert( mergedTriggers->begin() , mTrigger);
-
-	// append the TT as children ( don't forget the grand children )
-	I3TriggerHierarchy::iterator tt_iter = 
-	  mergedTriggers->append_child( m_iter, tpair.first );
-	mergedTriggers->append_child( tt_iter, tpair.second );
-
-	tt_iter = mergedTriggers->append_child( m_iter, *overlap_iter );
-	mergedTriggers->append_child( tt_iter, *(mergedTriggers->child( overlap_iter, 0 ) ) );
-
-	mergedTriggers->erase_children( overlap_iter );
-	mergedTriggers->erase( overlap_iter );
+    }
 
+    // the newest window goes in front
+    if( last - first == 1 ){
+      I3TriggerHierarchy::iterator tt_iter = mergedTriggers->insert( mergedTriggers->begin() , tt);
+      mergedTriggers->append_child( tt_iter, tpTriggers[order[first]].second );
+    }else{
+      TriggerKey mKey(TriggerKey::GLOBAL, TriggerKey::MERGED);
+      I3Trigger mTrigger;
+      mTrigger.GetTriggerKey() = mKey;
+      mTrigger.SetTriggerFired(true);
+      mTrigger.SetTriggerTime( earliest_time );
+      mTrigger.SetTriggerLength( length );
+
+      I3TriggerHierarchy::iterator m_iter =
+	mergedTriggers->insert( mergedTriggers->begin() , mTrigger);
+
+      // append the TT as children ( don't forget the grand children ),
+      // the second one first, like when the merged trigger is made
+      // from a pair of throughput triggers
+      swap(order[first], order[first + 1]);
+      for(size_t i = first; i < last; i++){
+	I3TriggerHierarchy::iterator tt_iter =
+	  mergedTriggers->append_child( m_iter, tpTriggers[order[i]].first );
+	mergedTriggers->append_child( tt_iter, tpTriggers[order[i]].second );
       }
-      //need a check that it's one or the other
-    }    
+    }
+    first = last;
   }
   return mergedTriggers;
 }
-
-
-I3TriggerHierarchy::iterator GlobalTriggerSim::FindOverlap(I3TriggerHierarchyConstPtr tree, const I3Trigger& t ){
-  
-  I3TriggerHierarchy::fixed_depth_iterator fd_iter;
-  for(fd_iter = tree->begin_fixed(tree->begin(),0);
-      tree->is_valid(fd_iter) ;  ++fd_iter ){
-    if( t.GetTriggerTime() >= fd_iter->GetTriggerTime() && 
-	t.GetTriggerTime() <= fd_iter->GetTriggerTime() + fd_iter->GetTriggerLength() ){
-      // there's an overlap
-      return I3TriggerHierarchy::iterator(fd_iter);
-    } 
-  }
-  return tree->end();
-}
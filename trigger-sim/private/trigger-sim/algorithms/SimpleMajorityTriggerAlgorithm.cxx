@@ -11,6 +11,7 @@
 
 #include <trigger-sim/algorithms/SimpleMajorityTriggerAlgorithm.h>
 #include <trigger-sim/algorithms/TimeWindow.h>
+#include <cmath>
 #include <boost/foreach.hpp>
 #include <boost/assign/std/vector.hpp>
 
@@ -21,7 +22,9 @@ SimpleMajorityTriggerAlgorithm::SimpleMajorityTriggerAlgorithm(double triggerWin
                                                                int domSet, 
                                                                I3MapKeyVectorIntConstPtr customDomSets): 
   TriggerService(domSet, customDomSets),
-  triggerWindow_(triggerWindow),  triggerThreshold_(triggerThreshold)
+  triggerWindow_(triggerWindow),  triggerThreshold_(triggerThreshold),
+  stream_(triggerThreshold, triggerWindow),
+  lastPushedTime_(NAN)
 {
   log_debug("SimpleMajorityTriggerAlgorithm configuration:");
   log_debug("  TriggerWindow = %f", triggerWindow_);
@@ -44,6 +47,7 @@ void SimpleMajorityTriggerAlgorithm::Trigger()
 
   // Get time windows
   TriggerHitIterPairVectorPtr timeWindows = timeWindow.SlidingTimeWindows(hits_);
+  windowCount_ = timeWindows->size();
 
   // If the vector is empty, there are no time windows for this string
   if (timeWindows->empty()) {
@@ -57,24 +61,56 @@ void SimpleMajorityTriggerAlgorithm::Trigger()
        timeWindowIter != timeWindows->end(); 
        timeWindowIter++) {
 
-    // Create a vector of the hits in this time window
-    TriggerHitVectorPtr timeHits(new TriggerHitVector);
-
     // Get the window boundaries
     TriggerHitVector::const_iterator firstHit = timeWindowIter->first;
     TriggerHitVector::const_iterator lastHit  = timeWindowIter->second;
 
-    // Iterate over the hits and pull out the ones for this window
-    for (TriggerHitVector::const_iterator hitIter = firstHit; 
-	 hitIter != lastHit; 
-	 hitIter++)
-      timeHits->push_back(*hitIter);
+    // Create a vector of the hits in this time window
+    TriggerHitVector timeHits(firstHit, lastHit);
 
-    log_debug("Time window (%f, %f) has %zd hits", firstHit->time, (--lastHit)->time, timeHits->size());
+    log_debug("Time window (%f, %f) has %zd hits", firstHit->time, (--lastHit)->time, timeHits.size());
 
-    triggers_.push_back(*timeHits);
-    triggerCount_++;
+    AddTrigger(timeHits);
     log_debug("Trigger! Count = %d", triggerCount_);
   } 
 }
 
+void SimpleMajorityTriggerAlgorithm::PushHits(const TriggerHit* hits, size_t nHits)
+{
+  StartPush();
+  for (size_t i = 0; i < nHits; i++) {
+    if (AcceptPushedHit(hits[i]) && stream_.Push(hits[i], streamTrigger_)) {
+      AddTrigger(streamTrigger_);
+      // Like Trigger, every window that triggered
+      windowCount_++;
+    }
+  }
+  log_debug("Keeping %zd hits for the open time windows", stream_.Size());
+}
+
+void SimpleMajorityTriggerAlgorithm::Flush()
+{
+  StartPush();
+  if (stream_.Flush(streamTrigger_)) {
+    AddTrigger(streamTrigger_);
+    windowCount_++;
+  }
+  lastPushedTime_ = NAN;
+}
+
+void SimpleMajorityTriggerAlgorithm::StartPush()
+{
+  ClearTriggers();
+  if (std::isnan(lastPushedTime_)) {
+    hits_->clear();
+    ClearStatistics();
+  }
+}
+
+bool SimpleMajorityTriggerAlgorithm::AcceptPushedHit(const TriggerHit& hit)
+{
+  if (hit.time < lastPushedTime_)
+    log_fatal("The pushed hits are not time ordered.");
+  lastPushedTime_ = hit.time;
+  return domSet_ && InDOMSet(OMKey(hit.string, hit.pos));
+}
@@ -15,6 +15,7 @@
 #include "icetray/I3Logging.h"
 #include "trigger-sim/algorithms/TriggerService.h"
 #include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/algorithms/SlidingTimeWindowStream.h"
 
 /**
 
@@ -46,6 +47,9 @@
    A time window with multiple independent clusters of hits will only produce a single
    trigger, but all hits in the time window will be used to define the length of the
    trigger.
+
+   In streaming mode (PushHits/Flush) only the hits of the open windows are kept,
+   and a trigger is formed when the hit after it arrives, like in pDAQ.
    
  */
 
@@ -61,11 +65,34 @@ class SimpleMajorityTriggerAlgorithm : public TriggerService
 
   void Trigger();
 
+  /**
+   * Streaming mode, for hits that come in time ordered chunks rather than
+   * one frame at a time.  The hits have to be selected for LC already,
+   * the DOM set of the trigger is applied here.  Each call replaces the
+   * triggers with the ones it completed.  Flush ends the stream and
+   * closes the triggers that are still open.  The instrumentation counts
+   * the whole stream, from its first PushHits to Flush.
+   */
+  void PushHits(const TriggerHit* hits, size_t nHits);
+  void Flush();
+
  private:
 
+  // Starts the triggers of a PushHits or Flush call.  When a stream
+  // starts it also drops the hits of the last frame and resets the
+  // instrumentation.
+  void StartPush();
+  // Checks the order of a pushed hit and whether it is in the DOM set
+  bool AcceptPushedHit(const TriggerHit& hit);
+
   double triggerWindow_;
   unsigned int triggerThreshold_;
 
+  SlidingTimeWindowStream stream_;
+  TriggerHitVector streamTrigger_;
+  // time of the last pushed hit, NaN at the start of a stream
+  double lastPushedTime_;
+
   SET_LOGGER("SimpleMajorityTriggerAlgorithm");
 };
 
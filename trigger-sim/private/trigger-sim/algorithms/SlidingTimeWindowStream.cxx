@@ -0,0 +1,137 @@
+#include "trigger-sim/algorithms/SlidingTimeWindowStream.h"
+#include <algorithm>
+
+SlidingTimeWindowStream::SlidingTimeWindowStream(unsigned int threshold, double window) :
+  threshold_(threshold),
+  window_(window),
+  windowStart_(0),
+  stopTime_(0),
+  count_(0),
+  trigger_(false),
+  triggerStart_(0)
+{
+}
+
+/**
+   The steps are the ones of TimeWindow::SlidingTimeWindows for a hit
+   that is not the last one: the sliding time window is the hits
+   [windowStart_, nextHit], and while a trigger is active it runs from
+   triggerStart_ up to the hit before nextHit.
+ */
+bool SlidingTimeWindowStream::Push(const TriggerHit& hit, TriggerHitVector& trigger)
+{
+  if (!hits_.empty() && hit.time < hits_.back().time)
+    log_fatal("The hits are not time ordered.");
+
+  hits_.push_back(hit);
+  size_t nextHit = hits_.size() - 1;
+  double nextTime = hit.time;
+
+  if (nextHit == 0) {
+    // the first hit starts the first window
+    windowStart_ = 0;
+    stopTime_ = nextTime + window_;
+    count_ = 1;
+    trigger_ = false;
+    return false;
+  }
+
+  bool formed = false;
+  if (nextTime <= stopTime_) {
+    // in window, increment counter
+    count_++;
+    log_debug("    Hit inside window, counter = %d", count_);
+  } else {
+    // First check if the current window is above threshold
+    if (count_ >= threshold_) {
+      if (!trigger_)
+        triggerStart_ = windowStart_;
+      trigger_ = true;
+    }
+
+    // Slide until either the next hit is inside or count goes to one
+    bool inWindow = false;
+    while ((!inWindow) && (count_ > 1)) {
+      windowStart_++;
+      count_--;
+      stopTime_ = hits_[windowStart_].time + window_;
+      if (nextTime <= stopTime_)
+        inWindow = true;
+    }
+
+    if (!inWindow) {
+      // the next hit starts a new window on its own
+      windowStart_ = nextHit;
+      stopTime_ = nextTime + window_;
+    } else {
+      count_++;
+    }
+
+    if (trigger_) {
+      bool overlap = (windowStart_ < nextHit) || Repeated(nextHit);
+      if (((count_ < threshold_) && (!overlap)) || (count_ == 1 && threshold_ == 1)) {
+        log_debug("form a trigger...");
+        MakeTrigger(triggerStart_, nextHit - 1, trigger);
+        trigger_ = false;
+        formed = true;
+      }
+    }
+  }
+
+  DropOldHits();
+  return formed;
+}
+
+bool SlidingTimeWindowStream::Flush(TriggerHitVector& trigger)
+{
+  bool formed = false;
+  if (!hits_.empty() && (trigger_ || count_ >= threshold_)) {
+    MakeTrigger(trigger_ ? triggerStart_ : windowStart_, hits_.size() - 1, trigger);
+    formed = true;
+  }
+
+  hits_.clear();
+  windowStart_ = 0;
+  count_ = 0;
+  trigger_ = false;
+  triggerStart_ = 0;
+  return formed;
+}
+
+bool SlidingTimeWindowStream::Repeated(size_t hit) const
+{
+  // Equal hits have equal times, and so are right before hit
+  for (size_t other = hit; other > triggerStart_ && hits_[other - 1].time == hits_[hit].time; other--) {
+    if (hits_[other - 1] == hits_[hit])
+      return true;
+  }
+  return false;
+}
+
+void SlidingTimeWindowStream::MakeTrigger(size_t first, size_t last, TriggerHitVector& trigger) const
+{
+  // Same hits as TimeWindow::AddTriggerWindow: from the first hit at the
+  // time of the first trigger hit to the first hit at the time of the last
+  // trigger hit.
+  TriggerHitVector::const_iterator beginHit =
+    std::lower_bound(hits_.begin(), hits_.begin() + first + 1, hits_[first]);
+  TriggerHitVector::const_iterator endHit =
+    std::lower_bound(hits_.begin(), hits_.begin() + last + 1, hits_[last]);
+  trigger.assign(beginHit, endHit + 1);
+}
+
+void SlidingTimeWindowStream::DropOldHits()
+{
+  // The windows never go back before their start, but a trigger takes in
+  // the earlier hits at the time of its first hit.
+  size_t start = trigger_ ? triggerStart_ : windowStart_;
+  size_t keep = std::lower_bound(hits_.begin(), hits_.begin() + start + 1, hits_[start]) - hits_.begin();
+
+  // Only once half of the hits are old, so that every hit is moved a
+  // bounded number of times
+  if (keep == 0 || 2*keep < hits_.size())
+    return;
+  hits_.erase(hits_.begin(), hits_.begin() + keep);
+  windowStart_ -= keep;
+  triggerStart_ = trigger_ ? triggerStart_ - keep : 0;
+}
@@ -0,0 +1,65 @@
+#ifndef SLIDING_TIME_WINDOW_STREAM_H
+#define SLIDING_TIME_WINDOW_STREAM_H
+
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "icetray/I3Logging.h"
+
+/**
+ * @brief The sliding time window of TimeWindow, for hits that arrive one
+ * at a time.
+ *
+ * Like in pDAQ the stream of hits has no end, so there is no special case
+ * for the last hit of a frame.  A trigger is formed when the hit that
+ * closes it arrives, or when the stream is flushed.  Only the hits the
+ * windows can still reach are kept.
+ */
+class SlidingTimeWindowStream
+{
+ public:
+
+  SlidingTimeWindowStream(unsigned int threshold, double window);
+
+  ~SlidingTimeWindowStream() = default;
+
+  /**
+   * Add the next hit, which may not be earlier than the ones before.  If
+   * it closes a trigger, the hits of the trigger are put in trigger and
+   * true is returned.
+   */
+  bool Push(const TriggerHit& hit, TriggerHitVector& trigger);
+
+  /**
+   * End the stream.  A trigger that is still open, or a window over
+   * threshold, is closed with the hits up to the last one.  Afterwards
+   * the stream starts over.
+   */
+  bool Flush(TriggerHitVector& trigger);
+
+  /**
+   * Number of hits kept for the open windows
+   */
+  size_t Size() const { return hits_.size(); }
+
+ private:
+
+  SlidingTimeWindowStream();
+
+  bool Repeated(size_t hit) const;
+  void MakeTrigger(size_t first, size_t last, TriggerHitVector& trigger) const;
+  void DropOldHits();
+
+  unsigned int threshold_;
+  double window_;
+
+  // The kept hits.  The indices below point into them.
+  TriggerHitVector hits_;
+  size_t windowStart_;
+  double stopTime_;
+  unsigned int count_;
+  bool trigger_;
+  size_t triggerStart_;
+
+  SET_LOGGER("SlidingTimeWindowStream");
+};
+
+#endif // SLIDING_TIME_WINDOW_STREAM_H
@@ -248,18 +248,70 @@ void SlowMonopoleTriggerAlgorithm::CheckTriggerStatus(TriggerHitVector *two_hit_
     int list_size = two_hit_list__->size();
     if(list_size >= 3)
     {
-        for(TriggerHitVector::iterator iter_1 = two_hit_list__->begin(); 
-	    iter_1 != two_hit_list__->end() -2 ; iter_1++ )
+        const TriggerHitVector& hits = *two_hit_list__;
+
+        // one geometry lookup per hit
+        std::vector<I3Position> positions;
+        positions.reserve(list_size);
+        BOOST_FOREACH(const TriggerHit& hit, hits)
+            positions.push_back(getPosition(hit, geo));
+
+        if(IsTimeOrdered(hits))
         {
-        	for(TriggerHitVector::iterator iter_2 = iter_1 + 1; 
-		    iter_2 != two_hit_list__->end() - 1 ; iter_2++ )
-        	{
-        		for(TriggerHitVector::iterator iter_3 = iter_2 + 1 ; 
-			    iter_3 != two_hit_list__->end(); iter_3++ )
-        		{
-        			CheckTriple(*iter_1, *iter_2, *iter_3, geo);
-        		}
-        	}
+            // CheckTriple only accepts a triple if iter_2 is within
+            // (t_min_, t_max_) of iter_1 and iter_3 within (t_min_, t_max_)
+            // of iter_2, so look for them in these windows only.  The
+            // triples are checked in the same order as by the full loop.
+            std::vector<int> first(list_size);
+            std::vector<int> last(list_size);
+            std::vector<int> offset(list_size + 1, 0);
+            for(int i = 0; i < list_size; i++)
+            {
+                GetTimeWindow(hits, i, &first[i], &last[i]);
+                offset[i + 1] = offset[i] + last[i] - first[i];
+            }
+
+            // distances of the hits to the ones in their window
+            std::vector<double> distances(offset[list_size]);
+            for(int i = 0; i < list_size; i++)
+                for(int j = first[i]; j < last[i]; j++)
+                    distances[offset[i] + j - first[i]] = getDistance(positions[i], positions[j]);
+
+            for(int i = 0; i < list_size; i++)
+            {
+                for(int j = first[i]; j < last[i]; j++)
+                {
+                    double p_diff1 = distances[offset[i] + j - first[i]];
+                    for(int k = first[j]; k < last[j]; k++)
+                    {
+                        CheckTriple(hits[i], hits[j], hits[k], p_diff1,
+                                    distances[offset[j] + k - first[j]],
+                                    getDistance(positions[i], positions[k]));
+                    }
+                }
+            }
+        }
+        else
+        {
+            // popping the last pair for the muon time window can leave the
+            // list out of time order, so check every triple in that case
+            for(int i = 0; i < list_size - 2; i++)
+            {
+                for(int j = i + 1; j < list_size - 1; j++)
+                {
+                    if(!InTimeWindow(hits[j].time - hits[i].time))
+                        continue;
+                    double p_diff1 = getDistance(positions[i], positions[j]);
+                    for(int k = j + 1; k < list_size; k++)
+                    {
+                        if(!InTimeWindow(hits[k].time - hits[j].time))
+                            continue;
+                        CheckTriple(hits[i], hits[j], hits[k], p_diff1,
+                                    getDistance(positions[j], positions[k]),
+                                    getDistance(positions[i], positions[k]));
+                    }
+                }
+            }
         }
     }
 
@@ -297,27 +349,64 @@ void SlowMonopoleTriggerAlgorithm::CheckTriggerStatus(TriggerHitVector *two_hit_
         TriggerHitVector trig_vec;
         trig_vec.push_back(start);
         trig_vec.push_back(end);
-        triggers_.push_back(trig_vec);
-        triggerCount_++;
+        AddTrigger(trig_vec);
     }
     trigger_container_vector.clear();
     two_hit_list__->clear();
 }
 
-void SlowMonopoleTriggerAlgorithm::CheckTriple(TriggerHit hit1, 
-				      TriggerHit hit2,  
-				      TriggerHit hit3, 
-				      const I3GeometryConstPtr &geo)
+bool SlowMonopoleTriggerAlgorithm::IsTimeOrdered(const TriggerHitVector& hits)
+{
+  for(size_t i = 1; i < hits.size(); i++)
+    if(!(hits[i].time >= hits[i-1].time))
+      return false;
+  return true;
+}
+
+void SlowMonopoleTriggerAlgorithm::GetTimeWindow(const TriggerHitVector& hits, int i, 
+					int *first, int *last)
+{
+  // The time differences to hit i grow with the index, so both ends of
+  // the window are found by bisection.  They are compared the same way
+  // as in CheckTriple, so the window has exactly the hits it accepts.
+  double t = hits[i].time;
+  int lo = i + 1;
+  int hi = hits.size();
+  while(lo < hi)
+    {
+      int mid = lo + (hi - lo)/2;
+      if(hits[mid].time - t > t_min_)
+	hi = mid;
+      else
+	lo = mid + 1;
+    }
+  *first = lo;
+
+  hi = hits.size();
+  while(lo < hi)
+    {
+      int mid = lo + (hi - lo)/2;
+      if(hits[mid].time - t < t_max_)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  *last = lo;
+}
+
+void SlowMonopoleTriggerAlgorithm::CheckTriple(const TriggerHit& hit1, 
+				      const TriggerHit& hit2,  
+				      const TriggerHit& hit3, 
+				      double p_diff1, 
+				      double p_diff2, 
+				      double p_diff3)
 {
   double t_diff1 = hit2.time - hit1.time;
   double t_diff2 = hit3.time - hit2.time;
-  if((t_diff1 > t_min_) && (t_diff2 > t_min_) && (t_diff1 < t_max_) && (t_diff2 < t_max_))
+  if(InTimeWindow(t_diff1) && InTimeWindow(t_diff2))
     {
       double t_diff3 = hit3.time - hit1.time;
       
-      double p_diff1 = getDistance(hit1, hit2, geo);
-      double p_diff2 = getDistance(hit2, hit3, geo);
-      double p_diff3 = getDistance(hit1, hit3, geo);
       log_debug("    ->step2 - p_diff1: %f, p_diff2: %f, p_diff3: %f", 
 		p_diff1, p_diff2, p_diff3);
       
@@ -423,19 +512,24 @@ void SlowMonopoleTriggerAlgorithm::CheckTriple(TriggerHit hit1,
     }
 }
 
-double SlowMonopoleTriggerAlgorithm::getDistance(TriggerHit hit1, 
-					TriggerHit hit2, 
-					const I3GeometryConstPtr &geo)
+I3Position SlowMonopoleTriggerAlgorithm::getPosition(const TriggerHit& hit, 
+					    const I3GeometryConstPtr &geo)
 {
-  I3OMGeoMap::const_iterator geo_iterator_1 = geo->omgeo.find(OMKey(hit1.string, hit1.pos));
-  I3OMGeoMap::const_iterator geo_iterator_2 = geo->omgeo.find(OMKey(hit2.string, hit2.pos));
-  
-  double x1 = geo_iterator_1->second.position.GetX();
-  double y1 = geo_iterator_1->second.position.GetY();
-  double z1 = geo_iterator_1->second.position.GetZ();
-  double x2 = geo_iterator_2->second.position.GetX();
-  double y2 = geo_iterator_2->second.position.GetY();
-  double z2 = geo_iterator_2->second.position.GetZ();
+  I3OMGeoMap::const_iterator geo_iterator = geo->omgeo.find(OMKey(hit.string, hit.pos));
+  if(geo_iterator == geo->omgeo.end())
+    log_fatal("DOM (%d, %u) is not in the geometry.", hit.string, hit.pos);
+  return geo_iterator->second.position;
+}
+
+double SlowMonopoleTriggerAlgorithm::getDistance(const I3Position& pos1, 
+					const I3Position& pos2)
+{
+  double x1 = pos1.GetX();
+  double y1 = pos1.GetY();
+  double z1 = pos1.GetZ();
+  double x2 = pos2.GetX();
+  double y2 = pos2.GetY();
+  double z2 = pos2.GetZ();
   
   double diff = sqrt( pow(x2 - x1, 2) + pow(y2 - y1, 2) + pow(z2 - z1, 2) );
   
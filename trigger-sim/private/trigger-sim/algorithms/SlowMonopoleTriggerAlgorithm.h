@@ -4,12 +4,18 @@
 #include "dataclasses/physics/I3Trigger.h"
 #include "dataclasses/physics/I3Particle.h"
 #include <dataclasses/geometry/I3Geometry.h>
+#include <dataclasses/status/I3DetectorStatus.h>
+#include <dataclasses/status/I3TriggerStatus.h>
 #include "trigger-sim/algorithms/TriggerHit.h"
 #include "trigger-sim/algorithms/TriggerContainer.h"
 #include "trigger-sim/algorithms/TriggerService.h"
 
 /*
  * slow monopole trigger
+ *
+ * Every hit has to be on a DOM of the geometry.  The positions of a pair
+ * list are looked up when it is checked for triples, and Trigger fails
+ * with log_fatal for a hit on a DOM that is missing.
  */
 
 class SlowMonopoleTriggerAlgorithm : public TriggerService
@@ -40,9 +46,15 @@ private:
 		    const I3GeometryConstPtr &geo);
     bool HLCPairCheck(TriggerHit hit1, TriggerHit hit2);
     void CheckTriggerStatus(TriggerHitVector *two_hit_list__, const I3GeometryConstPtr &geo);
-    void CheckTriple(TriggerHit hit1, TriggerHit hit2, TriggerHit hit3, 
-		     const I3GeometryConstPtr &geo);
-    double getDistance(TriggerHit hit1, TriggerHit hit2, const I3GeometryConstPtr &geo);
+    void CheckTriple(const TriggerHit& hit1, const TriggerHit& hit2, const TriggerHit& hit3, 
+		     double p_diff1, double p_diff2, double p_diff3);
+    bool InTimeWindow(double t_diff) const { return (t_diff > t_min_) && (t_diff < t_max_); }
+    // Indices [first, last) of the hits after hit i that are within
+    // (t_min_, t_max_) of it.  The hits have to be time ordered.
+    void GetTimeWindow(const TriggerHitVector& hits, int i, int *first, int *last);
+    static bool IsTimeOrdered(const TriggerHitVector& hits);
+    static I3Position getPosition(const TriggerHit& hit, const I3GeometryConstPtr &geo);
+    static double getDistance(const I3Position& pos1, const I3Position& pos2);
 
     //----------------------------------
     // Variables available at instantiation
@@ -1,13 +1,11 @@
 #include "trigger-sim/algorithms/TimeWindow.h"
-#include <boost/foreach.hpp>
+#include <algorithm>
 
 using namespace std;
 
 TimeWindow::TimeWindow(unsigned int threshold, double window) 
   : threshold_(threshold), window_(window) 
 {
-  timeWindowHits_ = TriggerHitListPtr( new TriggerHitList() );
-  triggerWindowHits_ = TriggerHitListPtr( new TriggerHitList() );
 }
 
 TimeWindow::~TimeWindow() {}
@@ -20,132 +18,67 @@ TimeWindow::~TimeWindow() {}
    of each valid time window:
       std::vector<pair<TriggerHitVector::const_iterator,TriqggerHitVector::const_iterator> >
 
+   The sliding time window is the hits [windowStart, nextHit] and, while a trigger
+   is active, the trigger window is the hits from triggerStart up to the one before
+   nextHit, so both are tracked as indices into the hits.
  */
 TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVectorPtr hits)
+{
+  return SlidingTimeWindows(*hits);
+}
+
+TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(const TriggerHitVector& hits)
 {
   // The return variable is a std::vector of pairs, each pair is the begin/end iterators for the time window
   TriggerHitIterPairVectorPtr triggerWindows(new TriggerHitIterPairVector());
 
-  // Initialize the trigger condition
-  bool trigger = false;
-
-  // Keep track of hits in the sliding time window
-  timeWindowHits_->clear();
-
-  // Keep track of hits in the current trigger window
-  triggerWindowHits_->clear();
-
-  // Create the begin/end pointers
-  TriggerHitVector::const_iterator beginHit;
-  TriggerHitVector::const_iterator endHit;
-
-  // Outer loop over all hits except the last
-  // The iteration of startingHit is controlled by the sliding of the time window
-  TriggerHitVector::const_iterator startingHit = hits->begin();
-  if(startingHit==hits->end())
-  {
+  if (hits.empty())
     return triggerWindows;
+
+  for (size_t hit = 1; hit < hits.size(); hit++) {
+    if (hits[hit].time < hits[hit - 1].time)
+      log_fatal("The hits are not time ordered.");
   }
- // while (startingHit != hits->end()) {
 
-  // Define the times of this trigger window
-  double startTime = startingHit->time;
+  // Initialize the trigger condition
+  bool trigger = false;
+  size_t triggerStart = 0;
+
+  // Define the times of the first time window
+  size_t windowStart = 0;
+  double startTime = hits[windowStart].time;
   double stopTime  = startTime + window_;
   log_debug("New starting hit! TimeWindow = (%f, %f)", startTime, stopTime);
 
-  // Push the startingHit into the timeWindowHits if its empty
-  //if (timeWindowHits_->empty())
-  timeWindowHits_->push_back(*startingHit);
+  // The number of hits within the sliding time window
+  unsigned int count = 1;
 
-  DumpHits(*timeWindowHits_, " TimeWindowHits:", "   ");
-
-  // Initialize the counter (including startingHit)
-  unsigned int count = timeWindowHits_->size(); // holds the number of hits within the sliding timewindow
-//  unsigned int trigger_hit_count=0;
-
-  // Initialize the begin/end pointers if the trigger is not active
-  if (!trigger) {
-    beginHit = startingHit;
-    endHit = hits->end();
-  }
-
-  // Inner loop over all later hits
-  TriggerHitVector::const_iterator nextHit;
-  for (nextHit = startingHit + 1; nextHit != hits->end(); nextHit++) {
+  // Loop over all later hits
+  size_t lastHit = hits.size() - 1;
+  for (size_t nextHit = 1; nextHit <= lastHit; nextHit++) {
 
     // The time of the next hit
-    double nextTime = nextHit->time;
+    double nextTime = hits[nextHit].time;
     log_debug("  NextTime = %f", nextTime);
 
     // Check if it falls in the time window
-    if (nextTime < startTime)
-    {
-      log_debug("ERROR HITS NOT TIMEORDERED_");
-      // error, hits should be time ordered
-    } 
-    else if (nextTime <= stopTime)
+    if (nextTime <= stopTime)
     {
       // in window, increment counter
-      timeWindowHits_->push_back(*nextHit);
-      count = timeWindowHits_->size();
+      count++;
 
-      if(trigger)
+      if (nextHit == lastHit) // we are at the last hit, this is in simulation only.... form a trigger if there is one...
       {
-      	triggerWindowHits_->push_back(*nextHit);
-
-
-
-      //   trigger_hit_count=triggerWindowHits_->size();
+	log_debug("Last hit and still in window");
+	if (trigger || count >= threshold_)
+	{
+	  if (!trigger)
+	    triggerStart = windowStart;
+	  AddTriggerWindow(hits, triggerStart, nextHit, *triggerWindows);
+	}
       }
 
-      if(nextHit == (hits->end()-1)) // we are at the last hit, this is in simulation only.... form a trigger if there is one...
-      {
-      	log_debug("special case;;;;;; we are at the last hit adn still in window");
-      	if(trigger || (!trigger && (timeWindowHits_->size() >= threshold_)) )
-      	{
-	  log_debug("yeah"); 
-
-	  if(!trigger)
-	  {
-	    CopyHits(*timeWindowHits_, *triggerWindowHits_); 
-	  }
-
-      	  double trigger_start=triggerWindowHits_->front().time;
-      	  double trigger_end=triggerWindowHits_->back().time;
-
-      	  for(beginHit=hits->begin(); beginHit!=hits->end(); beginHit++)
-      	  {
-      	    if(beginHit->time == trigger_start)
-      	    {
-	      log_debug("trigger_start: %f", trigger_start);
-      	      break;
-      	    }
-      	  }
-      	  for(endHit=hits->begin(); endHit!=hits->end(); endHit++)
-      	  {
-      	    if(endHit->time == trigger_end)
-      	    {
-	      log_debug("trigger_end: %f", trigger_end);
-      	      break;
-      	    }
-      	  }
-
-
-       //   beginHit=triggerWindowHits_->begin();
-	//  endHit=(triggerWindowHits_->end()-1);
-
-	  TriggerHitIterPair triggerWindow(beginHit, (endHit+1));
-	  triggerWindows->push_back(triggerWindow);
-	  DumpHits(*triggerWindowHits_, "      TriggerWindowHits:", "      ");
-	 }
-
-       //  break; // break the whole loop
-
-       }  
-
-
       log_debug("    Hit inside window, counter = %d", count);
-      DumpHits(*timeWindowHits_, "    TimeWindowHits:", "      ");
     } else {
       // Hit is beyond window, must slide window
       log_debug("    Hit outside window, sliding...");
@@ -153,134 +86,62 @@ TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVectorPtr h
       // First check if the current window is above threshold
       if (count >= threshold_) { 
 	log_debug("      Window is above threshold");
-	// First time we are above threshold, so no trigger yet, 
-	// then define beginHit for this trigger!!
-	if(!trigger){
-	 // beginHit =  startingHit;
-	  CopyHits(*timeWindowHits_, *triggerWindowHits_); 
-      //    trigger_hit_count=triggerWindowHits_->size();
-	  DumpHits(*triggerWindowHits_, "      TriggerWindowHits:", "      ");
-
-
-	  log_debug("StartTime of trigger: %lf",beginHit->time);
-	}
+	// First time we are above threshold, so the trigger starts with this window
+	if (!trigger)
+	  triggerStart = windowStart;
 	trigger = true;
-	//endHit = nextHit;  
       }
 
-      // Copy new hits into the triggerWindowHits
-
       // Now slide the window
-      //  slide until either next hit is inside or count goes to zero
+      //  slide until either next hit is inside or count goes to one
       bool inWindow = true;
       if (nextTime > stopTime)
-      {
-	 inWindow=false;
-      }
-
-      log_debug("nextTime: %f, stopTime: %f", nextTime, stopTime);
+	inWindow = false;
 
       while ((!inWindow) && (count > 1))
       {
-	//startingHit++;
-        timeWindowHits_->pop_front();
-        count = timeWindowHits_->size();
-      	log_debug("nextTime: %f, stopTime: %f", nextTime, stopTime);
+	windowStart++;
+	count--;
 	// new time window
-	startTime = timeWindowHits_->front().time;
+	startTime = hits[windowStart].time;
 	stopTime = startTime + window_;
 	log_debug("      New TimeWindow = (%f, %f)  Count = %d", startTime, stopTime, count);
-	DumpHits(*timeWindowHits_, "      TimeWindowHits:", "        ");
 
-	if (nextTime <= stopTime) {
+	if (nextTime <= stopTime)
 	  inWindow = true;
-	}
       }
 
-      if(!inWindow) // the prior while loop broke because count was 1
+      if (!inWindow) // the prior while loop broke because count was 1
       {
-	timeWindowHits_->pop_front();
-
-	timeWindowHits_->push_back(*nextHit);
-	startTime = timeWindowHits_->front().time;
+	// the next hit starts a new window on its own
+	windowStart = nextHit;
+	startTime = nextTime;
 	stopTime = startTime + window_;
-
-	count = timeWindowHits_->size();
-
-
       }
       else // Hit really falls into the window and count is bigger than 1
       {
-	// just push it back
-	timeWindowHits_->push_back(*nextHit);
-	count = timeWindowHits_->size();
+	count++;
       }
 
-      if(trigger)
+      if (trigger)
       {
-	log_debug("am in trigger...");
-
-	DumpHits(*triggerWindowHits_, "  overlap..     TriggerWindowHits:", "        ");
-
-	bool overlap = Overlap(*timeWindowHits_, *triggerWindowHits_);
-	if( ((count < threshold_) && (!overlap)) || (count==1 && threshold_== 1) || nextHit == (hits->end()-1))
+	// The time window and the trigger window share a hit if the time window
+	// has more hits than nextHit, or if nextHit is a repeat of a trigger hit.
+	bool overlap = (windowStart < nextHit) || Repeated(hits, triggerStart, nextHit);
+	if ( ((count < threshold_) && (!overlap)) || (count==1 && threshold_== 1) || nextHit == lastHit)
 	{
 	  log_debug("form a trigger...");
-	  if( nextHit == (hits->end()-1) && (overlap)) // if we overlap we have to take it - simulation/daq issue
-	  {
-	    triggerWindowHits_->push_back(*nextHit);
-	  }
-      /*    for(int i = 0; i < (int)triggerWindowHits_->size(); i++)
-	  {
-
-
-
-	  }*/
-
-	  double trigger_start=triggerWindowHits_->front().time;
-	  double trigger_end=triggerWindowHits_->back().time;
-
-	  for(beginHit=hits->begin(); beginHit!=hits->end(); beginHit++)
-	  {
-	    if(beginHit->time == trigger_start)
-	    {
-	      break;
-	    }
-	  }
-	  for(endHit=hits->begin(); endHit!=hits->end(); endHit++)
-	  {
-	    if(endHit->time == trigger_end)
-	    {
-	      break;
-	    }
-	  }
-
-
-       //   beginHit=triggerWindowHits_->begin();
-	//  endHit=(triggerWindowHits_->end()-1);
-
-	  TriggerHitIterPair triggerWindow(beginHit, (endHit+1));
-	  triggerWindows->push_back(triggerWindow);
-	  DumpHits(*triggerWindowHits_, "       TriggerWindowHits:", "        ");
-	  trigger=false;
-	  triggerWindowHits_->clear();
-
-
-	}
-	else
-	{
-	  triggerWindowHits_->push_back(*nextHit);
-
+	  // if we overlap we have to take the last hit - simulation/daq issue
+	  size_t triggerStop = (nextHit == lastHit && overlap) ? nextHit : nextHit - 1;
+	  AddTriggerWindow(hits, triggerStart, triggerStop, *triggerWindows);
+	  trigger = false;
 	}
-
+	// otherwise nextHit joins the trigger window
       }
-      // Check for overlap
     } // end time window check
 
-  } // end inner loop
-  timeWindowHits_->clear();
-  log_debug("      Reached end of inner loop...");
-  DumpHits(*timeWindowHits_, "       TimeWindowHits:", "        ");
+  } // end loop
+  log_debug("      Reached end of loop...");
 
   return triggerWindows;
 }
@@ -366,45 +227,26 @@ TriggerHitIterPairVectorPtr TimeWindow::FixedTimeWindows(TriggerHitVectorPtr hit
   return triggerWindows;
 }
 
-TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVector& hits)
-{
-
-  TriggerHitVectorPtr hitsPtr(new TriggerHitVector(hits));
-  return SlidingTimeWindows(hitsPtr);
-
-}
-
-void TimeWindow::DumpHits(TriggerHitList& hits, const string& head, const string& pad)
-{
-
-  log_debug("%s", head.c_str());
-  int n = 0;
-  BOOST_FOREACH( const TriggerHit& hit __attribute__((unused)), hits ) {
-    log_debug("%sHit %d @ Time %f", pad.c_str(), n, hit.time);
-    n++;
-  }
-
-}
-
-void TimeWindow::CopyHits(TriggerHitList& sourceHits, TriggerHitList& destHits)
+bool TimeWindow::Repeated(const TriggerHitVector& hits, size_t first, size_t hit)
 {
-
-  // Copy from source to dest IFF source does not already exist in dest
-  BOOST_FOREACH( TriggerHit sourceHit, sourceHits ) {
-    if (find(destHits.begin(), destHits.end(), sourceHit) == destHits.end())
-      destHits.push_back(sourceHit);
+  // Equal hits have equal times, and so are right before hit
+  for (size_t other = hit; other > first && hits[other - 1].time == hits[hit].time; other--) {
+    if (hits[other - 1] == hits[hit])
+      return true;
   }
-
+  return false;
 }
 
-bool TimeWindow::Overlap(TriggerHitList& hits1, TriggerHitList& hits2)
+void TimeWindow::AddTriggerWindow(const TriggerHitVector& hits, size_t first, size_t last,
+                                  TriggerHitIterPairVector& triggerWindows)
 {
-  bool overlap = false;
-  BOOST_FOREACH( TriggerHit hit1, hits1 ) {
-    if (find(hits2.begin(), hits2.end(), hit1) != hits2.end()) {
-      overlap = true;
-      break;
-    }
-  }
-  return overlap;
+  // The window runs from the first hit at the time of the first trigger
+  // hit to the first hit at the time of the last trigger hit.
+  TriggerHitVector::const_iterator beginHit =
+    std::lower_bound(hits.begin(), hits.begin() + first + 1, hits[first]);
+  TriggerHitVector::const_iterator endHit =
+    std::lower_bound(hits.begin(), hits.begin() + last + 1, hits[last]);
+  log_debug("trigger_start: %f trigger_end: %f", beginHit->time, endHit->time);
+
+  triggerWindows.push_back(TriggerHitIterPair(beginHit, endHit + 1));
 }
@@ -1,7 +1,6 @@
 #ifndef TIME_WINDOW_H
 #define TIME_WINDOW_H
 
-#include <string>
 #include "trigger-sim/algorithms/TriggerHit.h"
 #include "icetray/I3Logging.h"
 
@@ -21,10 +20,11 @@ class TimeWindow
   ~TimeWindow();
 
   /**
-   * Sliding time windows
+   * Sliding time windows.  The hits have to be time ordered, and the
+   * windows point into them.
    */
   TriggerHitIterPairVectorPtr SlidingTimeWindows(TriggerHitVectorPtr hits);
-  TriggerHitIterPairVectorPtr SlidingTimeWindows(TriggerHitVector& hits);
+  TriggerHitIterPairVectorPtr SlidingTimeWindows(const TriggerHitVector& hits);
 
   /**
    * Fixed time windows
@@ -38,16 +38,19 @@ class TimeWindow
    */
   TimeWindow();
 
-  void DumpHits(TriggerHitList& hits, const std::string& head, const std::string& pad);
-  void CopyHits(TriggerHitList& sourceHits, TriggerHitList& destHits);
-  bool Overlap(TriggerHitList& hits1, TriggerHitList& hits2);
+  /**
+   * Whether a hit before hit, from first on, is equal to it
+   */
+  static bool Repeated(const TriggerHitVector& hits, size_t first, size_t hit);
+  /**
+   * Save the window of the trigger with the hits [first, last]
+   */
+  static void AddTriggerWindow(const TriggerHitVector& hits, size_t first, size_t last,
+                               TriggerHitIterPairVector& triggerWindows);
 
   unsigned int threshold_;
   double window_;
 
-  TriggerHitListPtr timeWindowHits_;
-  TriggerHitListPtr triggerWindowHits_;
-
   SET_LOGGER("TimeWindow");
 };
 
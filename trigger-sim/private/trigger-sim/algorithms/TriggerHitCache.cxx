@@ -0,0 +1,63 @@
+#include "trigger-sim/algorithms/TriggerHitCache.h"
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+TriggerHitCache::TriggerHitCache() :
+  pulses_(false)
+{}
+
+void TriggerHitCache::Reset(DOMSetTableConstPtr domSets, bool pulses)
+{
+  domSets_ = domSets;
+  pulses_ = pulses;
+  hits_.clear();
+}
+
+TriggerHitCache::CachedHit TriggerHitCache::Prototype(const OMKey& dom) const
+{
+  CachedHit cached;
+  cached.hit.pos = dom.GetOM();
+  cached.hit.string = dom.GetString();
+  cached.pmt = dom.GetPMT();
+  cached.domSetMask = 0;
+  cached.hasMask = domSets_ && dom.GetPMT() == 0;
+  if (cached.hasMask) {
+    if (domSets_->Contains(dom))
+      cached.domSetMask = domSets_->GetMask(dom);
+    else
+      log_error_stream("DOM" << dom << " is not in DOMSet configured from frame!");
+  }
+  return cached;
+}
+
+void TriggerHitCache::Fill(I3DOMLaunchSeriesMapConstPtr launches, DOMSetTableConstPtr domSets)
+{
+  Reset(domSets, false);
+  BOOST_FOREACH(const I3DOMLaunchSeriesMap::value_type& mapItem, *launches){
+    if (mapItem.second.empty()) continue;
+    CachedHit cached = Prototype(mapItem.first);
+
+    BOOST_FOREACH(const I3DOMLaunch& launch, mapItem.second){
+      cached.hit.time = launch.GetStartTime();
+      cached.hit.lc = launch.GetLCBit();
+      hits_.push_back(cached);
+    }
+  }
+  std::stable_sort(hits_.begin(), hits_.end());
+}
+
+void TriggerHitCache::Fill(I3RecoPulseSeriesMapConstPtr pulses, DOMSetTableConstPtr domSets)
+{
+  Reset(domSets, true);
+  BOOST_FOREACH(const I3RecoPulseSeriesMap::value_type& mapItem, *pulses){
+    if (mapItem.second.empty()) continue;
+    CachedHit cached = Prototype(mapItem.first);
+
+    BOOST_FOREACH(const I3RecoPulse& pulse, mapItem.second){
+      cached.hit.time = pulse.GetTime();
+      cached.hit.lc = pulse.GetFlags() & I3RecoPulse::LC;
+      hits_.push_back(cached);
+    }
+  }
+  std::stable_sort(hits_.begin(), hits_.end());
+}
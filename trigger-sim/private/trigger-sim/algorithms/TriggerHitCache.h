@@ -0,0 +1,76 @@
+#ifndef TRIGGER_HIT_CACHE_H
+#define TRIGGER_HIT_CACHE_H
+
+#include <vector>
+#include <stdint.h>
+#include "icetray/I3Logging.h"
+#include "icetray/OMKey.h"
+#include "dataclasses/physics/I3DOMLaunch.h"
+#include "dataclasses/physics/I3RecoPulse.h"
+#include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/utilities/DOMSetTable.h"
+
+/**
+ * @brief The hits of one frame and one source, extracted once for all triggers.
+ *
+ * Every launch (or pulse) of the map becomes one hit, whatever its LC bit or
+ * DOM set, and the hits are sorted by time.  Hits with equal times keep the
+ * order of the map.  TriggerService::FillHits picks the hits of its DOM set
+ * and LC selection from here instead of going through the map again.
+ *
+ * The lc field of a hit is the LC bit of its launch, or the LC flag of its
+ * pulse.  If the cache is filled with a DOMSetTable, it keeps the DOM set
+ * mask of the table next to each hit, so the DOM set test is a single AND.
+ * Hits of DOMs the table can't answer for (PMT keys) have no mask.
+ */
+class TriggerHitCache
+{
+ public:
+
+  TriggerHitCache();
+
+  ~TriggerHitCache() = default;
+
+  /**
+   * Replace the hits with the launches of this frame.
+   */
+  void Fill(I3DOMLaunchSeriesMapConstPtr launches, DOMSetTableConstPtr domSets);
+
+  /**
+   * Replace the hits with the pulses of this frame.
+   */
+  void Fill(I3RecoPulseSeriesMapConstPtr pulses, DOMSetTableConstPtr domSets);
+
+  bool HasPulses() const { return pulses_; }
+  const DOMSetTableConstPtr& GetDOMSetTable() const { return domSets_; }
+
+  size_t Size() const { return hits_.size(); }
+  const TriggerHit& GetHit(size_t i) const { return hits_[i].hit; }
+  OMKey GetOMKey(size_t i) const { return OMKey(hits_[i].hit.string, hits_[i].hit.pos, hits_[i].pmt); }
+  bool HasDOMSetMask(size_t i) const { return hits_[i].hasMask; }
+  uint32_t GetDOMSetMask(size_t i) const { return hits_[i].domSetMask; }
+
+ private:
+
+  struct CachedHit
+  {
+    TriggerHit hit;
+    uint32_t domSetMask;
+    unsigned char pmt;
+    bool hasMask;
+
+    bool operator<(const CachedHit& rhs) const { return hit < rhs.hit; }
+  };
+
+  void Reset(DOMSetTableConstPtr domSets, bool pulses);
+  // A hit of the DOM, without time and LC bit
+  CachedHit Prototype(const OMKey& dom) const;
+
+  DOMSetTableConstPtr domSets_;
+  bool pulses_;
+  std::vector<CachedHit> hits_;
+
+  SET_LOGGER("TriggerHitCache");
+};
+
+#endif // TRIGGER_HIT_CACHE_H
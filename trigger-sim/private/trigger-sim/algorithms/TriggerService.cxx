@@ -11,30 +11,85 @@
 
 #include "trigger-sim/algorithms/TriggerService.h"
 #include <algorithm>
+#include <cmath>
 #include <boost/foreach.hpp>
 
 TriggerService::TriggerService(int domSet, 
                                I3MapKeyVectorIntConstPtr customDomSets):
   domSet_(domSet), customDomSets_(customDomSets),
   hits_(new TriggerHitVector()), triggers_(TriggerHitVectorVector()), 
-  triggerCount_(0), triggerIndex_(0)
+  triggerCount_(0), triggerIndex_(0),
+  windowCount_(0), cutTiming_(false)
 {}
 
+void TriggerService::SetDOMSetTable(DOMSetTableConstPtr domSetTable)
+{
+  if(domSetTable && domSetTable->GetDOMSets() != customDomSets_)
+    log_fatal("The DOMSetTable was built from different DOMSets than this trigger uses.");
+  domSetTable_ = domSetTable;
+}
+
 void TriggerService::FillHits(I3DOMLaunchSeriesMapConstPtr launches,
                               I3RecoPulseSeriesMapConstPtr pulses,
                               bool useSLC)
 {
-  // Reset the current hits 
-  hits_->clear();
+  // Reset the current hits and the triggers of the previous frame
+  ClearFrame();
 
   // And then load the individuals
   if(launches->size()) Extract(launches,useSLC);
   if(pulses->size()) Extract(pulses,useSLC);
 
-  std::sort(hits_->begin(), hits_->end());
+  // stable, so that hits with equal times are ordered like in a TriggerHitCache
+  std::stable_sort(hits_->begin(), hits_->end());
   return;
 }
 
+void TriggerService::FillHits(const TriggerHitCache& cache, bool useSLC)
+{
+  ClearFrame();
+
+  if(!domSet_) return;
+
+  // The cache is already time ordered, so the selection is too.
+  // Its masks can be used if it was filled with our DOM set table
+  // and the DOM set has a bit, or no DOMs at all.
+  const uint32_t domSetBit = domSetTable_ ? domSetTable_->GetBit(domSet_) : 0;
+  const bool masked = domSetTable_ && cache.GetDOMSetTable() == domSetTable_ &&
+    (domSetBit || domSetTable_->HasAllDOMSets());
+  const bool pulses = cache.HasPulses();
+  for(size_t i = 0; i < cache.Size(); i++){
+    const TriggerHit& hit = cache.GetHit(i);
+
+    // the same LC selection as in Extract
+    if(pulses ? (!hit.lc || useSLC) : !(hit.lc || useSLC)) continue;
+
+    if(masked && cache.HasDOMSetMask(i)){
+      if(!(cache.GetDOMSetMask(i) & domSetBit)) continue;
+    }
+    else if(!InDOMSet(cache.GetOMKey(i)))
+      continue;
+
+    hits_->push_back(hit);
+  }
+}
+
+void TriggerService::FillHits(const TriggerHit* hits, size_t nHits, bool useSLC)
+{
+  ClearFrame();
+
+  if(!domSet_) return;
+
+  // the same selection as Extract does for launches
+  for(size_t i = 0; i < nHits; i++){
+    if(!(hits[i].lc || useSLC)) continue;
+    if(!InDOMSet(OMKey(hits[i].string, hits[i].pos))) continue;
+    hits_->push_back(hits[i]);
+  }
+
+  std::stable_sort(hits_->begin(), hits_->end());
+}
+
 void TriggerService::Extract(I3DOMLaunchSeriesMapConstPtr launches, bool useSLC)
 {
   BOOST_FOREACH(auto mapItem, *launches){
@@ -43,7 +98,7 @@ void TriggerService::Extract(I3DOMLaunchSeriesMapConstPtr launches, bool useSLC)
     BOOST_FOREACH(const I3DOMLaunch& launch, mapItem.second){
       if(!(launch.GetLCBit() || useSLC)) continue;
       
-      if( !(domSet_ && DOMSetFunctions::InDOMSet(omKey, domSet_, customDomSets_)))
+      if( !(domSet_ && InDOMSet(omKey)))
         continue;
       
       TriggerHitPtr hit(new TriggerHit);
@@ -63,7 +118,7 @@ void TriggerService::Extract(I3RecoPulseSeriesMapConstPtr pulses, bool useSLC)
     BOOST_FOREACH(const I3RecoPulse& pulse, mapItem.second){
       if( !(pulse.GetFlags() & I3RecoPulse::LC)||useSLC) continue;
       
-      if( !(domSet_ && DOMSetFunctions::InDOMSet(omKey, domSet_, customDomSets_)) )
+      if( !(domSet_ && InDOMSet(omKey)) )
           continue;
       
       TriggerHitPtr hit(new TriggerHit);
@@ -76,6 +131,18 @@ void TriggerService::Extract(I3RecoPulseSeriesMapConstPtr pulses, bool useSLC)
 }
 
 
+void TriggerService::ClearStatistics()
+{
+  windowCount_ = 0;
+  std::fill(cutPassCounts_.begin(), cutPassCounts_.end(), 0);
+  std::fill(cutTimes_.begin(), cutTimes_.end(), 0.);
+}
+
+std::string TriggerService::GetCutName(size_t cut) const
+{
+  return "cut" + std::to_string(cut + 1);
+}
+
 unsigned int TriggerService::GetNumberOfTriggers() {
   return triggerCount_;
 }
@@ -90,4 +157,36 @@ TriggerHitVectorPtr TriggerService::GetNextTrigger() {
   return hits;
 }
 
+bool TriggerService::GetNextTriggerRecord(TriggerRecord& record) {
+  if (triggerCount_ == 0)
+    return false;
+  triggerCount_--;
+  log_debug("Returning trigger window %d", triggerCount_);
+
+  const TriggerHitVector& hits = triggers_.at(triggerCount_);
+  record.hits = hits.empty() ? NULL : &hits.front();
+  record.nHits = hits.size();
+  record.startTime = hits.empty() ? NAN : hits.front().time;
+  record.stopTime = hits.empty() ? NAN : hits.back().time;
+  return true;
+}
+
+void TriggerService::ClearFrame() {
+  hits_->clear();
+  ClearTriggers();
+  ClearStatistics();
+}
+
+void TriggerService::ClearTriggers() {
+  triggers_.clear();
+  triggerCount_ = 0;
+  triggerIndex_ = 0;
+}
+
+void TriggerService::AddTrigger(TriggerHitVector& hits) {
+  triggers_.push_back(TriggerHitVector());
+  triggers_.back().swap(hits);
+  triggerCount_++;
+}
+
 
@@ -120,14 +120,20 @@ void I3GlobalTriggerSim::DAQ(I3FramePtr frame)
 {
    log_debug("Entering I3GlobalTriggerSim::DAQ()");
 
-   const I3DetectorStatus& detStat = frame->Get<I3DetectorStatus>();
-
-   GlobalTriggerSim gts(detStat);
-   I3TriggerReadoutConfig roc;
-   roc.readoutTimeMinus = i3ReadoutWindowBefore_;
-   roc.readoutTimePlus = i3ReadoutWindowAfter_;
-   roc.readoutTimeOffset = i3ReadoutWindowOffset_;
-   gts.SetDefaultReadoutConfig(roc);
+   I3DetectorStatusConstPtr detStat = frame->Get<I3DetectorStatusConstPtr>("I3DetectorStatus");
+   if(!detStat)
+     log_fatal("No I3DetectorStatus found in the frame");
+
+   if(detStat != detectorStatus_){
+     detectorStatus_ = detStat;
+     gts_ = boost::shared_ptr<GlobalTriggerSim>(new GlobalTriggerSim(*detStat));
+     I3TriggerReadoutConfig roc;
+     roc.readoutTimeMinus = i3ReadoutWindowBefore_;
+     roc.readoutTimePlus = i3ReadoutWindowAfter_;
+     roc.readoutTimeOffset = i3ReadoutWindowOffset_;
+     gts_->SetDefaultReadoutConfig(roc);
+   }
+   GlobalTriggerSim& gts = *gts_;
 
    I3TriggerHierarchyConstPtr i3Triggers = frame->Get<I3TriggerHierarchyConstPtr>(i3TriggName_);
 
@@ -20,6 +20,8 @@
 #include "trigger-sim/utilities/ReadoutWindowUtil.h"
 
 #include <boost/foreach.hpp>
+#include <algorithm>
+#include <cmath>
 
 I3_MODULE(I3Pruner);
 
@@ -46,23 +48,85 @@ void I3Pruner::Configure()
    GetParameter("GlobalTriggerName",triggerName_);
 }
 
+namespace{
+  typedef std::vector<std::pair<double,double> > IntervalVector;
+
+  // Sort the readout windows and merge the ones that overlap,
+  // so that at most one of them can hold a given time.
+  void MergeIntervals(IntervalVector& intervals){
+    if(intervals.empty())
+      return;
+    sort(intervals.begin(), intervals.end());
+    size_t last = 0;
+    for(size_t i = 1; i < intervals.size(); i++){
+      if(intervals[i].first <= intervals[last].second)
+        intervals[last].second = max(intervals[last].second, intervals[i].second);
+      else
+        intervals[++last] = intervals[i];
+    }
+    intervals.resize(last + 1);
+  }
+
+  bool StartsAfter(double time, const std::pair<double,double>& interval){
+    return time < interval.first;
+  }
+
+  bool InIntervals(const IntervalVector& intervals, double time){
+    // the last interval that starts before or at this time
+    IntervalVector::const_iterator i =
+      upper_bound(intervals.begin(), intervals.end(), time, StartsAfter);
+    if(i == intervals.begin())
+      return false;
+    --i;
+    return time >= i->first && time <= i->second;
+  }
+}
+
 void I3Pruner::DAQ(I3FramePtr frame){
 
   // Get the geometry
   const I3Geometry& geometry = frame->Get<I3Geometry>();
 
   // Get the detector status
-  const I3DetectorStatus& status = frame->Get<I3DetectorStatus>();
+  I3DetectorStatusConstPtr status = frame->Get<I3DetectorStatusConstPtr>("I3DetectorStatus");
+  if (!status)
+    log_fatal("No I3DetectorStatus found in the frame");
 
   // Create the ReadoutWindowUtil helper class
-  ReadoutWindowUtil rwUtil(status);
+  if (status != detectorStatus_) {
+    detectorStatus_ = status;
+    rwUtil_ = boost::shared_ptr<ReadoutWindowUtil>(new ReadoutWindowUtil(*status));
+  }
+  const ReadoutWindowUtil& rwUtil = *rwUtil_;
 
   // Get the trigger hierarchy
   I3TriggerHierarchyConstPtr gTrigger = frame->Get<I3TriggerHierarchyConstPtr>(triggerName_);
   
-  I3TriggerHierarchy::iterator th_iter;
   if (gTrigger && gTrigger->size()) {
 
+    // Collect the readout windows of the subdetector triggers (inice or icetop)
+    // once for the whole frame.  Invalid windows don't keep any hits.
+    IntervalVector iniceIntervals;
+    IntervalVector icetopIntervals;
+    I3TriggerHierarchy::iterator th_iter;
+    for (th_iter = gTrigger->begin(); th_iter != gTrigger->end(); th_iter++) {
+
+      bool triggerIsInIce = th_iter->GetTriggerKey().GetSource() == TriggerKey::IN_ICE;
+      bool triggerIsIceTop = th_iter->GetTriggerKey().GetSource() == TriggerKey::ICE_TOP;
+      if ( !triggerIsInIce && !triggerIsIceTop ) continue;
+
+      const I3Trigger& trigger = *th_iter;
+      std::pair<double,double> iniceReadoutWindow = rwUtil.GetInIceReadoutWindow(trigger);
+      std::pair<double,double> icetopReadoutWindow = rwUtil.GetIceTopReadoutWindow(trigger);
+
+      if (!std::isnan(iniceReadoutWindow.first) && !std::isnan(iniceReadoutWindow.second))
+	iniceIntervals.push_back(iniceReadoutWindow);
+      if (!std::isnan(icetopReadoutWindow.first) && !std::isnan(icetopReadoutWindow.second))
+	icetopIntervals.push_back(icetopReadoutWindow);
+    }
+    MergeIntervals(iniceIntervals);
+    MergeIntervals(icetopIntervals);
+
     BOOST_FOREACH(std::string dataReadoutName, dataReadoutNames_) { // suppose you have several input maps, loops through all
 
       // skip if the map isn't found in the frame
@@ -78,66 +142,22 @@ void I3Pruner::DAQ(I3FramePtr frame){
       I3DOMLaunchSeriesMap::const_iterator iter;
       for (iter = dlsInMap->begin(); iter != dlsInMap->end(); ++iter) { // loop thorugh all doms in this dataReadoutName
 
-	// get the sub-detector of these launches
-	I3OMGeo omgeo = geometry.omgeo.find(iter->first)->second;
-	bool hitIsInIce = omgeo.omtype == I3OMGeo::IceCube;
-	bool hitIsIceTop = omgeo.omtype == I3OMGeo::IceTop;
+	// get the sub-detector of these launches, only the readout
+	// windows of that sub-detector can keep them
+	const I3OMGeo& omgeo = geometry.omgeo.find(iter->first)->second;
+	const IntervalVector* intervals = NULL;
+	if (omgeo.omtype == I3OMGeo::IceCube)
+	  intervals = &iniceIntervals;
+	else if (omgeo.omtype == I3OMGeo::IceTop)
+	  intervals = &icetopIntervals;
+	if (!intervals || intervals->empty()) continue;
 
 	I3DOMLaunchSeries launch_series;
 	I3DOMLaunchSeries::const_iterator dlIter;
 	for (dlIter = iter->second.begin(); dlIter != iter->second.end(); ++dlIter) { // loop through the launches per dom
-
-	  bool keepHit = false;
-	  double hitTime = dlIter->GetStartTime();
-
-	  // check the trigger hierarchy for a readout window that includes this hit
-	  for (th_iter = gTrigger->begin(); th_iter != gTrigger->end(); th_iter++) {
-
-	    // make sure this is a subdetector trigger (inice or icetop)
-	    bool triggerIsInIce = th_iter->GetTriggerKey().GetSource() == TriggerKey::IN_ICE;
-	    bool triggerIsIceTop = th_iter->GetTriggerKey().GetSource() == TriggerKey::ICE_TOP;
-
-	    if ( triggerIsInIce || triggerIsIceTop ) {
-
-	      // Get the readout windows
-	      const I3Trigger& trigger = *th_iter;
-	      std::pair<double,double> iniceReadoutWindow = rwUtil.GetInIceReadoutWindow(trigger);
-	      std::pair<double,double> icetopReadoutWindow = rwUtil.GetIceTopReadoutWindow(trigger);
-			 
-	      // Get the times (initalize to inice)
-	      double earliestTime = iniceReadoutWindow.first;
-	      double latestTime = iniceReadoutWindow.second;
-	      if (hitIsIceTop) {
-		earliestTime = icetopReadoutWindow.first;
-		latestTime = icetopReadoutWindow.second;
-	      }
-
-	      // See if this hit should be kept
-	      if (hitIsInIce && earliestTime != NAN && latestTime != NAN) {
-		// This is an inice hit and the inice readout window is valid
-		if ( (hitTime >= earliestTime) && (hitTime <= latestTime) )
-		  keepHit = true;
-	      }
-
-	      if (hitIsIceTop && earliestTime != NAN && latestTime != NAN) {
-		// This is an icetop hit and the icetop readout window is valid
-		if ( (hitTime >= earliestTime) && (hitTime <= latestTime) )
-		  keepHit = true;
-	      }
-
-	    }
- 
-	    // if we know we want it, break the iteration over sub-detector triggers
-	    if (keepHit) break;
-
-	  } // end loop over triggers
-
-	  // now see if we kept this hit
-	  if (keepHit) {
-	    //only push back events within the readout time window
+	  //only push back events within the readout time window
+	  if (InIntervals(*intervals, dlIter->GetStartTime()))
 	    launch_series.push_back(*dlIter);             
-	  }
-
 	} // end loop over hits
 
 	if (launch_series.size()) {
@@ -156,4 +176,3 @@ void I3Pruner::DAQ(I3FramePtr frame){
    
   PushFrame(frame,"OutBox");
 }
-
@@ -8,6 +8,10 @@
  * @date $Date: $
  * @author mlarson
  **/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <boost/foreach.hpp>
 #include <trigger-sim/modules/I3TriggerSimModule.h>
 #include <trigger-sim/algorithms/ClusterTriggerAlgorithm.h>
@@ -20,13 +24,25 @@
 typedef TriggerKey::TypeID TypeID;
 typedef TriggerKey::SourceID SourceID;
 
+namespace {
+  typedef std::chrono::steady_clock Clock;
+
+  double Seconds(Clock::duration duration){
+    return std::chrono::duration<double>(duration).count();
+  }
+}
+
 I3TriggerSimModule::I3TriggerSimModule(const I3Context& ctx) 
   : I3Module(ctx),
     iniceLaunches_("InIceRawData"),
     inicePulses_("InIceRawPulses"),
     icetopLaunches_("IceTopRawData"),
     outputName_("I3Triggers"),
-    domsetsName_("DOMSets")
+    domsetsName_("DOMSets"),
+    fptEvaluationMode_("full"),
+    numThreads_(1),
+    timeTriggerCuts_(false),
+    servicesStale_(true)
 {
   AddParameter("InIceLaunches", 
                "The name of the I3DOMLaunchSeriesMap to use as a default for in-ice data"
@@ -53,6 +69,28 @@ I3TriggerSimModule::I3TriggerSimModule(const I3Context& ctx)
                " need to run the InjectDefaultDOMSets function from trigger-sim before running"
                " this module. Defaults to DOMSets.",
                domsetsName_);
+  AddParameter("FPTEvaluationMode",
+               "How the Faint Particle Trigger evaluates its time windows. 'full' evaluates"
+               " every window from scratch, 'rolling' lets overlapping windows share their"
+               " hit pairs and 'early_exit' stops a window's pair loop as soon as its cuts"
+               " are decided. All give the same triggers. Defaults to full.",
+               fptEvaluationMode_);
+  AddParameter("NumThreads",
+               "The number of threads that run the triggers of a frame. The triggers are"
+               " independent of each other, so with more than one thread they run"
+               " concurrently. The output is the same as with one thread. Defaults to 1.",
+               numThreads_);
+  AddParameter("StatisticsName",
+               "If set, an I3MapStringDouble with this name is put in every DAQ frame with"
+               " the wall time of FillHits and Trigger, the hits, time windows and triggers"
+               " of each trigger configuration, and for triggers with cuts the windows that"
+               " passed each cut. The sums over all frames are logged in Finish and added"
+               " to the I3SummaryService if there is one. Defaults to nothing.",
+               statisticsName_);
+  AddParameter("TimeTriggerCuts",
+               "Also measure the time spent in each cut of the triggers that have cuts (FPT)."
+               " This reads the clock for every time window. Defaults to False.",
+               timeTriggerCuts_);
    AddOutBox("OutBox");
 }
 
@@ -65,6 +103,14 @@ void I3TriggerSimModule::Configure()
    GetParameter("IceTopLaunches", icetopLaunches_);
    GetParameter("OutputName", outputName_);
    GetParameter("DOMSets", domsetsName_);
+   GetParameter("FPTEvaluationMode", fptEvaluationMode_);
+   // fail early on an unknown mode
+   FaintParticleTriggerAlgorithm::EvaluationModeFromString(fptEvaluationMode_);
+   GetParameter("NumThreads", numThreads_);
+   if(numThreads_ < 1)
+     log_fatal("NumThreads has to be at least 1");
+   GetParameter("StatisticsName", statisticsName_);
+   GetParameter("TimeTriggerCuts", timeTriggerCuts_);
 }
 
 
@@ -76,6 +122,8 @@ void I3TriggerSimModule::Geometry(I3FramePtr frame)
      log_fatal("No I3Geometry found in the G-frame");
    
    geometry_ = frame->Get<I3GeometryConstPtr>("I3Geometry");
+   positions_ = DOMPositionTableConstPtr(new DOMPositionTable(*geometry_));
+   servicesStale_ = true;
    PushFrame(frame);
 }
 
@@ -91,6 +139,7 @@ void I3TriggerSimModule::DetectorStatus(I3FramePtr frame)
                " You may need to run trigger_sim.InjectDefaultDomSets",
                domsetsName_.c_str());
    domsets_ = frame->Get<I3MapKeyVectorIntConstPtr>(domsetsName_);
+   domSetTable_ = DOMSetTableConstPtr(new DOMSetTable(domsets_));
 
    //---------------------------
    // Need to copy the trigger configurations from the
@@ -100,64 +149,25 @@ void I3TriggerSimModule::DetectorStatus(I3FramePtr frame)
      log_fatal("No I3DetectorStatus found in D-frame");
    I3DetectorStatusConstPtr detStat = frame->Get<I3DetectorStatusConstPtr>("I3DetectorStatus");
    triggerConfigurations_ = I3TriggerStatusMap(detStat->triggerStatus);
+   servicesStale_ = true;
    PushFrame(frame);
 }
 
 
-void I3TriggerSimModule::DAQ(I3FramePtr frame)
+void I3TriggerSimModule::BuildServices()
 {
-  log_debug("Entering I3TriggerSimModule::DAQ()");
-
-  //---------------------------
-  // Are we initialized?
-  //---------------------------
-  if(!geometry_)
-    log_fatal("No geometry found. Did you include a GCD file?");
-  if(triggerConfigurations_.size() == 0)
-    log_fatal("No trigger configurations found. Did you include a GCD file?");
+  log_debug("Building the trigger services");
 
   //---------------------------
-  // Create the output hierarchy
-  //---------------------------
-  I3TriggerHierarchyPtr hierarchy;
-  if (frame->Has(outputName_)){
-    hierarchy = I3TriggerHierarchyPtr(new I3TriggerHierarchy(frame->Get<I3TriggerHierarchy>(outputName_)));
-    frame->Delete(outputName_);
-  }
-  else 
-    hierarchy = I3TriggerHierarchyPtr(new I3TriggerHierarchy());
-
-  //---------------------------
-  // Read the various sets of launches and pulses
-  //---------------------------
-  I3DOMLaunchSeriesMapConstPtr inice_launches;
-  if(frame->Has(iniceLaunches_))
-    inice_launches = frame->Get<I3DOMLaunchSeriesMapConstPtr>(iniceLaunches_);
-  else
-    inice_launches = I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap());
-  
-  I3DOMLaunchSeriesMapConstPtr icetop_launches;
-  if(frame->Has(icetopLaunches_))
-    icetop_launches = frame->Get<I3DOMLaunchSeriesMapConstPtr>(icetopLaunches_);
-  else
-    icetop_launches = I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap());
-  
-  I3RecoPulseSeriesMapConstPtr inice_pulses;
-  if(frame->Has(inicePulses_))
-    inice_pulses = frame->Get<I3RecoPulseSeriesMapConstPtr>(inicePulses_);
-  else
-    inice_pulses = I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap());
-    
-  //---------------------------
-  // Start triggering.
-  // Loop over all of the trigger configurations
-  // in order to run the right algorithm.
+  // Parse the trigger configurations once.  The
+  // services are kept until the next G- or D-frame.
   //---------------------------
+  services_.clear();
   BOOST_FOREACH(auto triggerPair, triggerConfigurations_){
     TriggerKey trigger_key = triggerPair.first;
     I3TriggerStatus trigger_config = triggerPair.second;
     
-    log_trace_stream("Running over trigger key " << trigger_key << std::endl;);
+    log_trace_stream("Building the service for trigger key " << trigger_key << std::endl;);
     
     //****************************
     // Get the domset now so that we can handle a
@@ -215,7 +225,8 @@ void I3TriggerSimModule::DAQ(I3FramePtr frame)
                                                             radius, 
                                                             height,
                                                             domset, 
-                                                            domsets_);
+                                                            domsets_,
+                                                            positions_);
         break;
       }
       case TypeID::SLOW_PARTICLE:
@@ -268,7 +279,7 @@ void I3TriggerSimModule::DAQ(I3FramePtr frame)
         trigger_config.GetTriggerConfigValue("zenith_histogram_min", zenith_histogram_min);
         trigger_config.GetTriggerConfigValue("histogram_binning", histogram_binning);
         trigger_config.GetTriggerConfigValue("slcfraction_min", slcfraction_min);
-        service = std::make_unique<FaintParticleTriggerAlgorithm>(time_window,
+        auto fpt = std::make_unique<FaintParticleTriggerAlgorithm>(time_window,
                                                                  time_window_separation,
                                                                  max_trigger_length,
                                                                  hit_min,
@@ -282,7 +293,10 @@ void I3TriggerSimModule::DAQ(I3FramePtr frame)
                                                                  slcfraction_min,                                                       
                                                                  geometry_,
                                                                  domset,
-                                                                 domsets_);
+                                                                 domsets_,
+                                                                 positions_);
+        fpt->SetEvaluationMode(FaintParticleTriggerAlgorithm::EvaluationModeFromString(fptEvaluationMode_));
+        service = std::move(fpt);
         break;
       }
     default:
@@ -290,47 +304,178 @@ void I3TriggerSimModule::DAQ(I3FramePtr frame)
       continue;
     }
 
-    //*****************************
-    // Add the hits and trigger.
-    //*****************************
-    switch (trigger_key.GetSource()){
-      case SourceID::IN_ICE:
-            if (trigger_key.GetType()==TypeID::SIMPLE_MULTIPLICITY || trigger_key.GetType()==TypeID::VOLUME||trigger_key.GetType()==TypeID::STRING ||trigger_key.GetType()==TypeID::SLOW_PARTICLE)  {
-                service->FillHits(inice_launches, I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()),false);
-                break;
-            }
-            if (trigger_key.GetType()==TypeID::FAINT_PARTICLE){
-                service->FillHits(inice_launches,I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()),true);
-                break;
-
-            }
-      case SourceID::ICE_TOP:
-        service->FillHits(icetop_launches, I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap()),false);
-        break;
-      case SourceID::IN_ICE_PULSES:
-        service->FillHits(I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap()), inice_pulses,false);
-        break;
-      default:
-        log_fatal_stream("Triggering for SourceID " << trigger_key.GetSource() << " is not implemented.");
-        continue;
-    }
-    
-    //*****************************
-    // Run this trigger
-    //*****************************
-    service->Trigger();
+    service->SetDOMSetTable(domSetTable_);
+    service->SetCutTiming(timeTriggerCuts_);
+    services_.push_back(ConfiguredService{trigger_key, std::move(service),
+                                          ServiceStatistics(), &statistics_[trigger_key]});
+  }
+  servicesStale_ = false;
+}
+
+
+void I3TriggerSimModule::RunService(ConfiguredService& configured)
+{
+  const TriggerKey& trigger_key = configured.key;
+  TriggerService* service = configured.service.get();
+  
+  log_trace_stream("Running over trigger key " << trigger_key << std::endl;);
+
+  //*****************************
+  // Add the hits and trigger.
+  //*****************************
+  Clock::time_point start = Clock::now();
+  switch (trigger_key.GetSource()){
+    case SourceID::IN_ICE:
+          if (trigger_key.GetType()==TypeID::SIMPLE_MULTIPLICITY || trigger_key.GetType()==TypeID::VOLUME||trigger_key.GetType()==TypeID::STRING ||trigger_key.GetType()==TypeID::SLOW_PARTICLE)  {
+              service->FillHits(iniceLaunchHits_, false);
+              break;
+          }
+          if (trigger_key.GetType()==TypeID::FAINT_PARTICLE){
+              service->FillHits(iniceLaunchHits_, true);
+              break;
+
+          }
+    case SourceID::ICE_TOP:
+      service->FillHits(icetopLaunchHits_, false);
+      break;
+    case SourceID::IN_ICE_PULSES:
+      service->FillHits(inicePulseHits_, false);
+      break;
+    default:
+      log_fatal_stream("Triggering for SourceID " << trigger_key.GetSource() << " is not implemented.");
+      return;
+  }
+  
+  //*****************************
+  // Run this trigger
+  //*****************************
+  Clock::time_point filled = Clock::now();
+  service->Trigger();
+  Clock::time_point triggered = Clock::now();
+
+  //*****************************
+  // Count what it did
+  //*****************************
+  ServiceStatistics& statistics = configured.frameStatistics;
+  statistics.frames = 1;
+  statistics.hits = service->GetNumberOfHits();
+  statistics.windows = service->GetNumberOfWindows();
+  statistics.triggers = service->GetNumberOfTriggers();
+  statistics.fillHitsTime = Seconds(filled - start);
+  statistics.triggerTime = Seconds(triggered - filled);
+  const std::vector<unsigned long>& passCounts = service->GetCutPassCounts();
+  if(statistics.cutNames.size() != passCounts.size()){
+    statistics.cutNames.clear();
+    for(size_t cut = 0; cut < passCounts.size(); cut++)
+      statistics.cutNames.push_back(service->GetCutName(cut));
+  }
+  statistics.cutPassCounts.assign(passCounts.begin(), passCounts.end());
+  statistics.cutTimes.assign(service->GetCutTimes().begin(), service->GetCutTimes().end());
+  configured.statistics->Add(statistics);
+}
+
+
+void I3TriggerSimModule::DAQ(I3FramePtr frame)
+{
+  log_debug("Entering I3TriggerSimModule::DAQ()");
+
+  //---------------------------
+  // Are we initialized?
+  //---------------------------
+  if(!geometry_)
+    log_fatal("No geometry found. Did you include a GCD file?");
+  if(triggerConfigurations_.size() == 0)
+    log_fatal("No trigger configurations found. Did you include a GCD file?");
+
+  //---------------------------
+  // Create the output hierarchy
+  //---------------------------
+  I3TriggerHierarchyPtr hierarchy;
+  if (frame->Has(outputName_)){
+    hierarchy = I3TriggerHierarchyPtr(new I3TriggerHierarchy(frame->Get<I3TriggerHierarchy>(outputName_)));
+    frame->Delete(outputName_);
+  }
+  else 
+    hierarchy = I3TriggerHierarchyPtr(new I3TriggerHierarchy());
+
+  //---------------------------
+  // Read the various sets of launches and pulses
+  //---------------------------
+  I3DOMLaunchSeriesMapConstPtr inice_launches;
+  if(frame->Has(iniceLaunches_))
+    inice_launches = frame->Get<I3DOMLaunchSeriesMapConstPtr>(iniceLaunches_);
+  else
+    inice_launches = I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap());
+  
+  I3DOMLaunchSeriesMapConstPtr icetop_launches;
+  if(frame->Has(icetopLaunches_))
+    icetop_launches = frame->Get<I3DOMLaunchSeriesMapConstPtr>(icetopLaunches_);
+  else
+    icetop_launches = I3DOMLaunchSeriesMapConstPtr(new I3DOMLaunchSeriesMap());
+  
+  I3RecoPulseSeriesMapConstPtr inice_pulses;
+  if(frame->Has(inicePulses_))
+    inice_pulses = frame->Get<I3RecoPulseSeriesMapConstPtr>(inicePulses_);
+  else
+    inice_pulses = I3RecoPulseSeriesMapConstPtr(new I3RecoPulseSeriesMap());
+
+  //---------------------------
+  // Extract and sort the hits of each source once,
+  // the triggers only select from them.
+  //---------------------------
+  iniceLaunchHits_.Fill(inice_launches, domSetTable_);
+  icetopLaunchHits_.Fill(icetop_launches, domSetTable_);
+  inicePulseHits_.Fill(inice_pulses, domSetTable_);
     
+  //---------------------------
+  // Start triggering.
+  // Loop over all of the trigger configurations
+  // in order to run the right algorithm.
+  //---------------------------
+  if(servicesStale_)
+    BuildServices();
+
+  if(numThreads_ > 1 && services_.size() > 1){
+    // The services share nothing but the hit caches, which are only read.
+    // Each worker takes the next service that is not running yet.
+    std::atomic<size_t> next_service(0);
+    auto worker = [this, &next_service](){
+      for(size_t i = next_service++; i < services_.size(); i = next_service++)
+        RunService(services_[i]);
+    };
+    std::vector<std::future<void> > workers;
+    size_t num_workers = std::min<size_t>(numThreads_, services_.size());
+    for(size_t i = 1; i < num_workers; i++)
+      workers.push_back(std::async(std::launch::async, worker));
+    worker();
+    // rethrows whatever a worker threw
+    BOOST_FOREACH(std::future<void>& result, workers)
+      result.get();
+  }
+  else{
+    BOOST_FOREACH(ConfiguredService& configured, services_)
+      RunService(configured);
+  }
+
+  if(!statisticsName_.empty())
+    PutStatistics(frame);
+
+  // Collect the triggers in the order of the configurations,
+  // however the services were run
+  BOOST_FOREACH(ConfiguredService& configured, services_){
+    const TriggerKey& trigger_key = configured.key;
+    TriggerService* service = configured.service.get();
+
     //*****************************
     // Push the results to the hierarchy
     //*****************************
-    unsigned int num_triggers = service->GetNumberOfTriggers();
-    log_debug_stream("Found " << num_triggers << " triggers for key " << trigger_key <<std::endl);
+    log_debug_stream("Found " << service->GetNumberOfTriggers() << " triggers for key " << trigger_key <<std::endl);
 
-    for(unsigned int i=0; i<num_triggers; ++i){
-      TriggerHitVectorPtr trigger_hits = service->GetNextTrigger();
+    TriggerRecord record;
+    while(service->GetNextTriggerRecord(record)){
       // Trigger time windows are defined by the hits in the time window.
-      double start_time = trigger_hits->front().time;
-      double stop_time = trigger_hits->back().time;
+      double start_time = record.startTime;
+      double stop_time = record.stopTime;
       
       // Create the trigger
       I3Trigger trigger;
@@ -350,9 +495,99 @@ void I3TriggerSimModule::DAQ(I3FramePtr frame)
 }
 
 
+void I3TriggerSimModule::PutStatistics(I3FramePtr frame) const
+{
+  I3MapStringDoublePtr statistics(new I3MapStringDouble());
+  BOOST_FOREACH(const ConfiguredService& configured, services_)
+    configured.frameStatistics.Write(*statistics, StatisticsLabel(configured.key));
+  frame->Put(statisticsName_, statistics);
+}
+
+
 void I3TriggerSimModule::Finish()
 {
    log_debug("Entering I3TriggerSimModule::Finish()");
+
+   double total_time = 0;
+   BOOST_FOREACH(const auto& entry, statistics_)
+     total_time += entry.second.fillHitsTime + entry.second.triggerTime;
+
+   I3MapStringDoublePtr summary = context_.Get<I3MapStringDoublePtr>("I3SummaryService");
+   BOOST_FOREACH(const auto& entry, statistics_){
+     const ServiceStatistics& statistics = entry.second;
+     if(statistics.frames == 0)
+       continue;
+
+     double time = statistics.fillHitsTime + statistics.triggerTime;
+     log_info_stream(entry.first << ": " << statistics.frames << " frames, "
+                     << double(statistics.hits)/statistics.frames << " hits/frame, "
+                     << statistics.windows << " windows, "
+                     << statistics.triggers << " triggers, "
+                     << statistics.fillHitsTime << " s in FillHits, "
+                     << statistics.triggerTime << " s in Trigger ("
+                     << (total_time > 0 ? 100*time/total_time : 0.) << "% of all triggers)");
+     for(size_t cut = 0; cut < statistics.cutPassCounts.size(); cut++){
+       log_info_stream("  " << statistics.cutNames[cut] << ": "
+                       << statistics.cutPassCounts[cut] << " windows passed ("
+                       << (statistics.windows > 0 ? 100.*statistics.cutPassCounts[cut]/statistics.windows : 0.)
+                       << "%), " << statistics.cutTimes[cut] << " s");
+     }
+
+     if(summary)
+       statistics.Write(*summary, GetName() + ":" + StatisticsLabel(entry.first));
+   }
+}
+
+
+I3TriggerSimModule::ServiceStatistics::ServiceStatistics() :
+  frames(0),
+  hits(0),
+  windows(0),
+  triggers(0),
+  fillHitsTime(0),
+  triggerTime(0)
+{
+}
+
+void I3TriggerSimModule::ServiceStatistics::Add(const ServiceStatistics& other)
+{
+  frames += other.frames;
+  hits += other.hits;
+  windows += other.windows;
+  triggers += other.triggers;
+  fillHitsTime += other.fillHitsTime;
+  triggerTime += other.triggerTime;
+  if(cutNames.empty()){
+    cutNames = other.cutNames;
+    cutPassCounts.assign(other.cutPassCounts.size(), 0);
+    cutTimes.assign(other.cutTimes.size(), 0.);
+  }
+  for(size_t cut = 0; cut < cutPassCounts.size() && cut < other.cutPassCounts.size(); cut++){
+    cutPassCounts[cut] += other.cutPassCounts[cut];
+    cutTimes[cut] += other.cutTimes[cut];
+  }
+}
+
+void I3TriggerSimModule::ServiceStatistics::Write(I3MapStringDouble& map, const std::string& prefix) const
+{
+  map[prefix + ":frames"] = frames;
+  map[prefix + ":hits"] = hits;
+  map[prefix + ":windows"] = windows;
+  map[prefix + ":triggers"] = triggers;
+  map[prefix + ":fill_hits_time"] = fillHitsTime;
+  map[prefix + ":trigger_time"] = triggerTime;
+  for(size_t cut = 0; cut < cutPassCounts.size(); cut++){
+    map[prefix + ":" + cutNames[cut] + "_passed"] = cutPassCounts[cut];
+    map[prefix + ":" + cutNames[cut] + "_time"] = cutTimes[cut];
+  }
+}
+
+std::string I3TriggerSimModule::StatisticsLabel(const TriggerKey& key)
+{
+  std::string label = std::string(key.GetSourceString()) + "_" + key.GetTypeString();
+  if(key.CheckConfigID())
+    label += "_" + std::to_string(key.GetConfigID());
+  return label;
 }
 
 I3_MODULE(I3TriggerSimModule);
@@ -0,0 +1,48 @@
+#include "trigger-sim/utilities/DOMPositionTable.h"
+#include <algorithm>
+#include <limits>
+
+DOMPositionTable::DOMPositionTable(const I3Geometry& geometry) :
+  minString_(std::numeric_limits<int>::max()),
+  maxString_(std::numeric_limits<int>::min()),
+  maxOM_(0)
+{
+  if (geometry.omgeo.empty()) {
+    log_warn("Building a DOM position table from an empty geometry.");
+    minString_ = 0;
+    maxString_ = -1;
+    return;
+  }
+
+  // First pass to find the extent of the (string, OM) grid
+  for (I3OMGeoMap::const_iterator iter = geometry.omgeo.begin();
+       iter != geometry.omgeo.end(); ++iter) {
+    minString_ = std::min(minString_, iter->first.GetString());
+    maxString_ = std::max(maxString_, iter->first.GetString());
+    maxOM_ = std::max(maxOM_, iter->first.GetOM());
+  }
+
+  size_t nStrings = static_cast<size_t>(maxString_ - minString_) + 1;
+  index_.assign(nStrings*(maxOM_ + 1), -1);
+  positions_.reserve(3*geometry.omgeo.size());
+
+  // Second pass to fill the table.  Multi-PMT modules have several
+  // entries per (string, OM); the triggers only know the module, so
+  // keep the first one (the map is ordered by PMT).
+  for (I3OMGeoMap::const_iterator iter = geometry.omgeo.begin();
+       iter != geometry.omgeo.end(); ++iter) {
+    size_t slot = static_cast<size_t>(iter->first.GetString() - minString_)*(maxOM_ + 1)
+      + iter->first.GetOM();
+    if (index_[slot] >= 0) continue;
+
+    index_[slot] = static_cast<int>(positions_.size()/3);
+    positions_.push_back(iter->second.position.GetX());
+    positions_.push_back(iter->second.position.GetY());
+    positions_.push_back(iter->second.position.GetZ());
+  }
+
+  log_debug("DOMPositionTable: %zu DOMs on strings %d-%d, OMs 0-%u",
+            GetNumberOfDOMs(), minString_, maxString_, maxOM_);
+}
+
+DOMPositionTable::~DOMPositionTable() {}
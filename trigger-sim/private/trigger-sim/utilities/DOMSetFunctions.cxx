@@ -54,6 +54,27 @@ bool DOMSetFunctions::InDOMSet(const OMKey& dom, const unsigned& domSet,
   return false;
 }
 
+bool DOMSetFunctions::InDOMSet(const OMKey& dom, const unsigned& domSet,
+                               const DOMSetTable &domSets)
+{
+  // the table only holds DOMs with PMT 0
+  if (dom.GetPMT() != 0)
+    return DOMSetFunctions::InDOMSet(dom, domSet, domSets.GetDOMSets());
+
+  if (!domSets.Contains(dom)) {
+	  log_error_stream("DOM" << dom << " is not in DOMSet configured from frame!");
+    return false; // this DOM will be in no DOMSet at all
+  }
+
+  uint32_t bit = domSets.GetBit(domSet);
+  if (bit)
+    return domSets.GetMask(dom) & bit;
+  if (domSets.HasAllDOMSets())
+    return false;
+  // one of the DOM sets that didn't fit into the mask
+  return DOMSetFunctions::InDOMSet(dom, domSet, domSets.GetDOMSets());
+}
+
 
 // function that returns a I3MapKeyVectorInt with the default
 // DOMSets (as configured in InDOMSet_orig below)
@@ -0,0 +1,72 @@
+#include "trigger-sim/utilities/DOMSetTable.h"
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <boost/foreach.hpp>
+
+DOMSetTable::DOMSetTable(I3MapKeyVectorIntConstPtr domSets) :
+  domSets_(domSets),
+  minString_(std::numeric_limits<int>::max()),
+  maxString_(std::numeric_limits<int>::min()),
+  maxOM_(0),
+  truncated_(false)
+{
+  if (!domSets_)
+    log_fatal("Can't build a DOMSetTable without a DOMSets map.");
+
+  // First pass to find the extent of the (string, OM) grid
+  // and the DOM set IDs that are used
+  std::set<unsigned int> ids;
+  BOOST_FOREACH(const I3MapKeyVectorInt::value_type& entry, *domSets_){
+    if (entry.first.GetPMT() != 0) continue;
+    minString_ = std::min(minString_, entry.first.GetString());
+    maxString_ = std::max(maxString_, entry.first.GetString());
+    maxOM_ = std::max(maxOM_, entry.first.GetOM());
+    BOOST_FOREACH(int setID, entry.second)
+      if (setID >= 0) ids.insert(static_cast<unsigned int>(setID));
+  }
+  if (minString_ > maxString_) {
+    log_warn("Building a DOMSetTable from an empty DOMSets map.");
+    minString_ = 0;
+    maxString_ = -1;
+    return;
+  }
+
+  BOOST_FOREACH(unsigned int id, ids){
+    if (bitDOMSets_.size() == MAX_BITS) {
+      truncated_ = true;
+      log_info("More than %u DOM sets, the ones from %u on are looked up in the map.",
+               MAX_BITS, id);
+      break;
+    }
+    bitDOMSets_.push_back(id);
+  }
+
+  size_t nStrings = static_cast<size_t>(maxString_ - minString_) + 1;
+  masks_.assign(nStrings*(maxOM_ + 1), 0);
+  known_.assign(masks_.size(), 0);
+
+  // Second pass to fill the masks
+  BOOST_FOREACH(const I3MapKeyVectorInt::value_type& entry, *domSets_){
+    int slot = GetSlot(entry.first);
+    if (slot < 0) continue;
+    known_[slot] = 1;
+    BOOST_FOREACH(int setID, entry.second)
+      if (setID >= 0)
+        masks_[slot] |= GetBit(static_cast<unsigned int>(setID));
+  }
+
+  log_debug("DOMSetTable: %zu DOM sets on strings %d-%d, OMs 0-%u",
+            bitDOMSets_.size(), minString_, maxString_, maxOM_);
+}
+
+DOMSetTable::~DOMSetTable() {}
+
+uint32_t DOMSetTable::GetBit(unsigned int domSet) const
+{
+  std::vector<unsigned int>::const_iterator iter =
+    std::lower_bound(bitDOMSets_.begin(), bitDOMSets_.end(), domSet);
+  if (iter == bitDOMSets_.end() || *iter != domSet)
+    return 0;
+  return 1u << (iter - bitDOMSets_.begin());
+}
@@ -1,22 +1,57 @@
 #include "trigger-sim/utilities/ReadoutWindowUtil.h"
 #include "dataclasses/TriggerKey.h"
+#include <algorithm>
+
+const int ReadoutWindowUtil::N_SUBDETECTORS;
+
+namespace {
+  template <class T>
+  bool KeyLess(const std::pair<TriggerKey, T>& entry, const TriggerKey& key) {
+    return entry.first < key;
+  }
+}
 
 ReadoutWindowUtil::ReadoutWindowUtil(const I3DetectorStatus& detectorStatus) 
 {
-  triggerStatus_ = detectorStatus.triggerStatus;
+  // The trigger status map is sorted by TriggerKey already
+  readouts_.reserve(detectorStatus.triggerStatus.size());
+  std::map<TriggerKey, I3TriggerStatus>::const_iterator triggerStatusIter;
+  for (triggerStatusIter = detectorStatus.triggerStatus.begin();
+       triggerStatusIter != detectorStatus.triggerStatus.end(); ++triggerStatusIter) {
+
+    const std::map<I3TriggerStatus::Subdetector, I3TriggerReadoutConfig>& readoutConfigMap =
+      triggerStatusIter->second.GetReadoutSettings();
+
+    ResolvedReadout readout;
+    for (int i = 0; i < N_SUBDETECTORS; i++) {
+      I3TriggerStatus::Subdetector subdetector = 
+        static_cast<I3TriggerStatus::Subdetector>(i + I3TriggerStatus::NOT_SPECIFIED);
+
+      // Lookup the I3TriggerReadoutConfig first for I3TriggerStatus::ALL, then for the subdetector
+      std::map<I3TriggerStatus::Subdetector, I3TriggerReadoutConfig>::const_iterator readoutConfigIter;
+      readoutConfigIter = readoutConfigMap.find(I3TriggerStatus::ALL);
+      if (readoutConfigIter == readoutConfigMap.end())
+        readoutConfigIter = readoutConfigMap.find(subdetector);
+
+      readout.found[i] = readoutConfigIter != readoutConfigMap.end();
+      if (readout.found[i])
+        readout.config[i] = readoutConfigIter->second;
+    }
+    readouts_.push_back(std::make_pair(triggerStatusIter->first, readout));
+  }
 }
 
 ReadoutWindowUtil::~ReadoutWindowUtil() {}
 
-std::pair<double,double> ReadoutWindowUtil::GetInIceReadoutWindow(const I3Trigger& trigger) {
+std::pair<double,double> ReadoutWindowUtil::GetInIceReadoutWindow(const I3Trigger& trigger) const {
   return GetReadoutWindow(I3TriggerStatus::INICE, trigger);
 }
 
-std::pair<double,double> ReadoutWindowUtil::GetIceTopReadoutWindow(const I3Trigger& trigger) {
+std::pair<double,double> ReadoutWindowUtil::GetIceTopReadoutWindow(const I3Trigger& trigger) const {
   return GetReadoutWindow(I3TriggerStatus::ICETOP, trigger);
 }
 
-double ReadoutWindowUtil::GetEarliestReadoutTime(const I3Trigger& trigger) {
+double ReadoutWindowUtil::GetEarliestReadoutTime(const I3Trigger& trigger) const {
 
   std::pair<double,double> iniceReadout = GetReadoutWindow(I3TriggerStatus::INICE, trigger);
   std::pair<double,double> icetopReadout = GetReadoutWindow(I3TriggerStatus::ICETOP, trigger);
@@ -25,7 +60,7 @@ double ReadoutWindowUtil::GetEarliestReadoutTime(const I3Trigger& trigger) {
   
 }
 
-double ReadoutWindowUtil::GetLatestReadoutTime(const I3Trigger& trigger) {
+double ReadoutWindowUtil::GetLatestReadoutTime(const I3Trigger& trigger) const {
 
   std::pair<double,double> iniceReadout = GetReadoutWindow(I3TriggerStatus::INICE, trigger);
   std::pair<double,double> icetopReadout = GetReadoutWindow(I3TriggerStatus::ICETOP, trigger);
@@ -38,7 +73,7 @@ double ReadoutWindowUtil::GetLatestReadoutTime(const I3Trigger& trigger) {
  * Return one readout window corresponding to subdetector InIce or IceTop
  *
  */
-std::pair<double,double> ReadoutWindowUtil::GetReadoutWindow(I3TriggerStatus::Subdetector subdetector, const I3Trigger& trigger) {
+std::pair<double,double> ReadoutWindowUtil::GetReadoutWindow(I3TriggerStatus::Subdetector subdetector, const I3Trigger& trigger) const {
 
   // The return window
   std::pair<double,double> readoutWindow(NAN,NAN);
@@ -46,34 +81,26 @@ std::pair<double,double> ReadoutWindowUtil::GetReadoutWindow(I3TriggerStatus::Su
   // Get the trigger key for this trigger
   const TriggerKey& triggerKey = trigger.GetTriggerKey();
 
-  // Lookup the I3TriggerStatus for this TriggerKey
-  std::map<TriggerKey, I3TriggerStatus>::const_iterator triggerStatusIter;
-  triggerStatusIter = triggerStatus_.find(triggerKey);
-  if (triggerStatusIter == triggerStatus_.end()) {
+  // Lookup the readout settings for this TriggerKey
+  std::vector<std::pair<TriggerKey, ResolvedReadout> >::const_iterator readoutIter;
+  readoutIter = std::lower_bound(readouts_.begin(), readouts_.end(), triggerKey,
+                                 KeyLess<ResolvedReadout>);
+  if (readoutIter == readouts_.end() || triggerKey < readoutIter->first) {
     // This TriggerKey is not in the I3TriggerStatus
     log_debug("TriggerKey not found in I3TriggerStatus.");
     return readoutWindow;
   }
-  I3TriggerStatus triggerStatus = triggerStatusIter->second;
-  
-  // Get the I3TriggerReadoutConfig map for this I3Trigger
-  const std::map<I3TriggerStatus::Subdetector, I3TriggerReadoutConfig> readoutConfigMap = triggerStatus.GetReadoutSettings();
-
-  // Lookup the I3TriggerReadoutConfig first for I3TriggerStatus::ALL
-  std::map<I3TriggerStatus::Subdetector, I3TriggerReadoutConfig>::const_iterator readoutConfigIter;
-  readoutConfigIter = readoutConfigMap.find(I3TriggerStatus::ALL);
-  if (readoutConfigIter == readoutConfigMap.end()) {
-
-    // Does not exist as type ALL, Now lookup the I3TriggerReadoutConfig for I3TriggerStatus::Subdetector
-    readoutConfigIter = readoutConfigMap.find(subdetector);
-    if (readoutConfigIter == readoutConfigMap.end()) {
-      // No readouts for either I3TriggerStatus::ALL or I3TriggerStatus::Subdetector for this I3Trigger
-      log_debug("No readouts for either I3TriggerStatus::ALL or I3TriggerStatus::Subdetector for this I3Trigger");
-      return readoutWindow;
-    }
 
+  // Subdetectors we don't know of can only use the settings for ALL
+  int index = subdetector - I3TriggerStatus::NOT_SPECIFIED;
+  if (index < 0 || index >= N_SUBDETECTORS)
+    index = I3TriggerStatus::ALL - I3TriggerStatus::NOT_SPECIFIED;
+  if (!readoutIter->second.found[index]) {
+    // No readouts for either I3TriggerStatus::ALL or I3TriggerStatus::Subdetector for this I3Trigger
+    log_debug("No readouts for either I3TriggerStatus::ALL or I3TriggerStatus::Subdetector for this I3Trigger");
+    return readoutWindow;
   }
-  I3TriggerReadoutConfig readoutConfig = readoutConfigIter->second;
+  const I3TriggerReadoutConfig& readoutConfig = readoutIter->second.config[index];
 
   // Get the trigger times of this I3Trigger
   double triggerStart = trigger.GetTriggerTime();
@@ -17,34 +17,28 @@
 #include "simclasses/I3MCPE.h"
 #include "simclasses/I3MCPulse.h"
 
-I3MCHitSeriesMapPtr
-Shift(I3MCHitSeriesMapConstPtr map, double dt){
-  I3MCHitSeriesMapPtr newmap(new I3MCHitSeriesMap(*map));
-  BOOST_FOREACH(I3MCHitSeriesMap::reference hs_pair, *newmap){
+void
+Shift(I3MCHitSeriesMap& map, double dt){
+  BOOST_FOREACH(I3MCHitSeriesMap::reference hs_pair, map){
     BOOST_FOREACH(I3MCHit& h, hs_pair.second){
       h.SetTime(h.GetTime() - dt);
     }
   }
-  return newmap;
 }
 
-I3MCTreePtr
-Shift(I3MCTreeConstPtr tree, double dt){
-  I3MCTreePtr new_tree(new I3MCTree(*tree));
+void
+Shift(I3MCTree& tree, double dt){
   I3MCTree::iterator t_iter;
-  for(t_iter = new_tree->begin();
-      t_iter != new_tree->end();
+  for(t_iter = tree.begin();
+      t_iter != tree.end();
       t_iter++){
     t_iter->SetTime(t_iter->GetTime() - dt);
   }
-  return new_tree;
 }
 
-I3MMCTrackListPtr 
-Shift(I3MMCTrackListConstPtr tracks, double dt){
-  I3MMCTrackListPtr new_mmctracklist(new I3MMCTrackList(*tracks)); 
-	
-  BOOST_FOREACH(I3MMCTrackList::reference track, *new_mmctracklist){ 
+void
+Shift(I3MMCTrackList& tracks, double dt){
+  BOOST_FOREACH(I3MMCTrackList::reference track, tracks){ 
     double t_0( track.GetI3Particle().GetTime() ); 
     I3Particle p( track.GetI3Particle() ); 
     p.SetTime(t_0 - dt); 
@@ -54,114 +48,92 @@ Shift(I3MMCTrackListConstPtr tracks, double dt){
     track.tc -= dt ; 
     track.tf -= dt ; 
   } 
-  return new_mmctracklist;
 }
 
-I3DOMLaunchSeriesMapPtr
-Shift(I3DOMLaunchSeriesMapConstPtr launches, double dt){
-  I3DOMLaunchSeriesMapPtr new_launchmap(new I3DOMLaunchSeriesMap(*launches));
-  
-  BOOST_FOREACH(I3DOMLaunchSeriesMap::reference pair, *new_launchmap){
+void
+Shift(I3DOMLaunchSeriesMap& launches, double dt){
+  BOOST_FOREACH(I3DOMLaunchSeriesMap::reference pair, launches){
     BOOST_FOREACH(I3DOMLaunch& l, pair.second)
       l.SetStartTime(l.GetStartTime() - dt);
   }
-  return new_launchmap;
 }
 
-I3RecoPulseSeriesMapPtr
-Shift(I3RecoPulseSeriesMapConstPtr pulses, double dt){
-  I3RecoPulseSeriesMapPtr new_pulsemap(new I3RecoPulseSeriesMap(*pulses));
-  
-  BOOST_FOREACH(I3RecoPulseSeriesMap::reference pair, *new_pulsemap){
+void
+Shift(I3RecoPulseSeriesMap& pulses, double dt){
+  BOOST_FOREACH(I3RecoPulseSeriesMap::reference pair, pulses){
     BOOST_FOREACH(I3RecoPulse& p, pair.second)
       p.SetTime(p.GetTime() - dt);
   }
-  return new_pulsemap;
 }
 
-I3TriggerHierarchyPtr
-Shift(I3TriggerHierarchyConstPtr tree, double dt){
-  I3TriggerHierarchyPtr new_tree(new I3TriggerHierarchy(*tree));
+void
+Shift(I3TriggerHierarchy& tree, double dt){
   I3TriggerHierarchy::iterator t_iter;
-  for(t_iter = new_tree->begin();
-      t_iter != new_tree->end();
+  for(t_iter = tree.begin();
+      t_iter != tree.end();
       t_iter++){
     t_iter->SetTriggerTime(t_iter->GetTriggerTime() - dt);
   }
-  return new_tree;
 }
 
-I3VectorI3TriggerPtr
-Shift(I3VectorI3TriggerConstPtr triggers, double dt){
-  I3VectorI3TriggerPtr new_triggers(new I3VectorI3Trigger(*triggers));
+void
+Shift(I3VectorI3Trigger& triggers, double dt){
   I3VectorI3Trigger::iterator t_iter;
-  for(t_iter = new_triggers->begin();
-      t_iter != new_triggers->end();
+  for(t_iter = triggers.begin();
+      t_iter != triggers.end();
       t_iter++){
     t_iter->SetTriggerTime(t_iter->GetTriggerTime() - dt);
   }
-  return new_triggers;
 }
 
-I3DoublePtr
-Shift(I3DoubleConstPtr i3double, double dt){
-  return I3DoublePtr( new I3Double( i3double->value - dt));
+void
+Shift(I3Double& i3double, double dt){
+  i3double.value -= dt;
 }
 
-I3ParticlePtr
-Shift(I3ParticleConstPtr i3particle, double dt){
-  I3ParticlePtr new_particle( new I3Particle(*i3particle) );
-  new_particle->SetTime(i3particle->GetTime() - dt);
-  return new_particle;
+void
+Shift(I3Particle& i3particle, double dt){
+  i3particle.SetTime(i3particle.GetTime() - dt);
 }
 
-I3FlasherInfoVectPtr
-Shift(I3FlasherInfoVectConstPtr oldflasher, double dt){
-  I3FlasherInfoVectPtr flasherInfoVect(new I3FlasherInfoVect());
-  I3FlasherInfoVect::const_iterator flashiter;
-  for (flashiter = oldflasher->begin(); flashiter != oldflasher->end(); flashiter++) {
-    I3FlasherInfoPtr newflasher(new I3FlasherInfo(*flashiter));
-    newflasher->SetFlashTime(flashiter->GetFlashTime() - dt);
-    flasherInfoVect->push_back(*newflasher);
+void
+Shift(I3FlasherInfoVect& flashers, double dt){
+  I3FlasherInfoVect::iterator flashiter;
+  for (flashiter = flashers.begin(); flashiter != flashers.end(); flashiter++) {
+    flashiter->SetFlashTime(flashiter->GetFlashTime() - dt);
   }
-  return flasherInfoVect;
 }
 
-I3MCPESeriesMapPtr
-Shift(I3MCPESeriesMapConstPtr map, double dt){
-  I3MCPESeriesMapPtr newmap(new I3MCPESeriesMap(*map));
-  BOOST_FOREACH(I3MCPESeriesMap::reference hs_pair, *newmap){
+void
+Shift(I3MCPESeriesMap& map, double dt){
+  BOOST_FOREACH(I3MCPESeriesMap::reference hs_pair, map){
     BOOST_FOREACH(I3MCPE& h, hs_pair.second){
       h.time = h.time - dt;
     }
   }
-  return newmap;
 }
 
-I3MCPulseSeriesMapPtr
-Shift(I3MCPulseSeriesMapConstPtr map, double dt){
-  I3MCPulseSeriesMapPtr newmap(new I3MCPulseSeriesMap(*map));
-  BOOST_FOREACH(I3MCPulseSeriesMap::reference hs_pair, *newmap){
+void
+Shift(I3MCPulseSeriesMap& map, double dt){
+  BOOST_FOREACH(I3MCPulseSeriesMap::reference hs_pair, map){
     BOOST_FOREACH(I3MCPulse& h, hs_pair.second){
       h.time = h.time - dt;
     }
   }
-  return newmap;
 }
 
-I3VectorI3ParticlePtr
-Shift(I3VectorI3ParticleConstPtr vect, double dt){
-  I3VectorI3ParticlePtr newvect(new I3VectorI3Particle(*vect));
-  BOOST_FOREACH(I3Particle p, *newvect){
+void
+Shift(I3VectorI3Particle& vect, double dt){
+  BOOST_FOREACH(I3Particle& p, vect){
     p.SetTime(p.GetTime() - dt);
   }
-  return newvect;
 }
 
 template<class T>
 bool ShiftAndReplaceInFrame(I3FramePtr frame, const std::string &key, double dt)
 {
   typedef boost::shared_ptr<const T> TConstPtr;
+  typedef boost::shared_ptr<T> TPtr;
 
   TConstPtr ptr;
   try{
@@ -181,7 +153,20 @@ bool ShiftAndReplaceInFrame(I3FramePtr frame, const std::string &key, double dt)
 
   // exists. shift it and replace it.
   frame->Delete(key);
-  frame->Put(key, Shift(ptr,dt));
+
+  // If the frame held the only other reference the object is ours now
+  // and can be shifted where it is.  Otherwise someone else (another
+  // copy of the frame, a python variable) still sees it and we have to
+  // shift a copy.
+  TPtr shifted;
+  if (ptr.unique())
+    shifted = boost::const_pointer_cast<T>(ptr);
+  else
+    shifted = TPtr(new T(*ptr));
+  ptr.reset();
+
+  Shift(*shifted, dt);
+  frame->Put(key, shifted);
   return true;
 }
 
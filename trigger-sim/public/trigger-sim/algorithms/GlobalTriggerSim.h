@@ -26,8 +26,6 @@ class GlobalTriggerSim
 {
 
  private:
-    boost::shared_ptr< std::map<TriggerKey, I3TriggerStatus> > triggerStatusMap_;
-
     boost::shared_ptr<ReadoutWindowUtil> roUtil_;
 
     I3TriggerReadoutConfig defaultReadoutConfig_;
@@ -39,17 +37,11 @@ class GlobalTriggerSim
  public:    
 
     GlobalTriggerSim(const I3DetectorStatus& d){
-      triggerStatusMap_ = boost::shared_ptr< std::map<TriggerKey, I3TriggerStatus> >
-	( new std::map<TriggerKey, I3TriggerStatus>(d.triggerStatus) );
-
       roUtil_ = boost::shared_ptr< ReadoutWindowUtil >
 	( new ReadoutWindowUtil(d) );
     };
 
     GlobalTriggerSim(I3DetectorStatusConstPtr d){
-      triggerStatusMap_ = boost::shared_ptr< std::map<TriggerKey, I3TriggerStatus> >
-	( new std::map<TriggerKey, I3TriggerStatus>(d->triggerStatus) );
-
       roUtil_ = boost::shared_ptr< ReadoutWindowUtil >
 	( new ReadoutWindowUtil(*d) );
     };
@@ -64,8 +56,6 @@ class GlobalTriggerSim
     
     I3TriggerHierarchyPtr Merge( const std::vector< std::pair<I3Trigger, I3Trigger > >& );
 
-    I3TriggerHierarchy::iterator FindOverlap(I3TriggerHierarchyConstPtr, const I3Trigger&);
-
 };
 
 #endif //GLOBALTRIGGERSIM_H
@@ -12,6 +12,8 @@
 #ifndef TRIGGER_SERVICE_H
 #define TRIGGER_SERVICE_H
 
+#include <string>
+#include <vector>
 #include "icetray/I3Logging.h"
 #include "icetray/OMKey.h"
 #include "dataclasses/physics/I3DOMLaunch.h"
@@ -19,6 +21,22 @@
 #include "dataclasses/I3Map.h"
 #include "trigger-sim/utilities/DOMSetFunctions.h"
 #include "trigger-sim/algorithms/TriggerHit.h"
+#include "trigger-sim/algorithms/TriggerHitCache.h"
+
+/**
+ * @brief A trigger found by a TriggerService.
+ *
+ * The start and stop times are the times of the first and last hit of
+ * the trigger.  The hits are not copied, they point into the service and
+ * stay valid until its hits are filled again.
+ */
+struct TriggerRecord
+{
+  double startTime;
+  double stopTime;
+  const TriggerHit* hits;
+  size_t nHits;
+};
 
 class TriggerService
 {
@@ -26,30 +44,111 @@ public:
   TriggerService(int domSet, I3MapKeyVectorIntConstPtr customDomSets);
   virtual ~TriggerService() {};
 
+  /**
+   * Use the compiled form of the DOMSets for the DOM set tests.  The table
+   * has to be built from the DOMSets this service was constructed with.
+   */
+  void SetDOMSetTable(DOMSetTableConstPtr domSetTable);
+
+  /**
+   * Replaces the hits with the ones of this frame and drops the triggers
+   * of the previous one, so that one service can run over many frames.
+   */
   void FillHits(I3DOMLaunchSeriesMapConstPtr launches,
                 I3RecoPulseSeriesMapConstPtr pulses,
                 bool useSLC);
+
+  /**
+   * Same as above, but takes the hits from a cache that was filled once
+   * for all triggers of the frame.
+   */
+  void FillHits(const TriggerHitCache& cache, bool useSLC);
+
+  /**
+   * Same as above, but for hits that were extracted elsewhere, e.g. from
+   * numpy arrays in python.  The LC bit is the one of a launch.  The hits
+   * don't have to be time ordered.
+   */
+  void FillHits(const TriggerHit* hits, size_t nHits, bool useSLC);
     
   virtual void Trigger() = 0;
 
   unsigned int GetNumberOfTriggers();
   TriggerHitVectorPtr GetNextTrigger();
 
+  /**
+   * What the last FillHits and Trigger looked at, for the instrumentation
+   * of I3TriggerSimModule.  The windows are the time windows the
+   * algorithm evaluated, 0 for algorithms that don't work on windows.
+   * Algorithms with cuts count the windows that passed each cut and all
+   * cuts applied before it, and with cut timing on also the seconds
+   * spent in each cut.
+   */
+  size_t GetNumberOfHits() const { return hits_->size(); }
+  unsigned long GetNumberOfWindows() const { return windowCount_; }
+  const std::vector<unsigned long>& GetCutPassCounts() const { return cutPassCounts_; }
+  const std::vector<double>& GetCutTimes() const { return cutTimes_; }
+  virtual std::string GetCutName(size_t cut) const;
+  void SetCutTiming(bool cutTiming) { cutTiming_ = cutTiming; }
+
+  /**
+   * Same triggers, in the same order, as GetNextTrigger but without
+   * copying their hits.  Returns false when there are no more.
+   */
+  bool GetNextTriggerRecord(TriggerRecord& record);
+
+  /**
+   * The hits of the last FillHits, time ordered and in the DOM set.
+   * E.g. the input of an FPTParameterScan.
+   */
+  const TriggerHitVector& GetHits() const { return *hits_; }
+
  protected:
   void Extract(I3DOMLaunchSeriesMapConstPtr launches,
                bool useSLC);
   void Extract(I3RecoPulseSeriesMapConstPtr pulses,
                bool useSLC);
 
+  // Drops the triggers, e.g. before adding the ones of a new frame
+  void ClearTriggers();
+
+  /**
+   * Adds a trigger with these hits.  The hits are moved, which leaves
+   * the vector empty.
+   */
+  void AddTrigger(TriggerHitVector& hits);
+
+  /**
+   * Resets the instrumentation for a new frame.  Algorithms with cuts
+   * size the counts in their constructor.
+   */
+  void ClearStatistics();
+  bool InDOMSet(const OMKey& dom) const {
+    return domSetTable_ ?
+      DOMSetFunctions::InDOMSet(dom, domSet_, *domSetTable_) :
+      DOMSetFunctions::InDOMSet(dom, domSet_, customDomSets_);
+  }
+
   int domSet_;
   I3MapKeyVectorIntConstPtr customDomSets_;
+  DOMSetTableConstPtr domSetTable_;
 
   TriggerHitVectorPtr hits_;
   TriggerHitVectorVector triggers_;
   unsigned int triggerCount_;
   unsigned int triggerIndex_;
 
+  unsigned long windowCount_;
+  std::vector<unsigned long> cutPassCounts_;
+  std::vector<double> cutTimes_;
+  bool cutTiming_;
+
   SET_LOGGER("TriggerService");
+
+ private:
+  // Drops the hits, triggers and instrumentation of the previous frame,
+  // the start of every FillHits
+  void ClearFrame();
 };
 
 #endif
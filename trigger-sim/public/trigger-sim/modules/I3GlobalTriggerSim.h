@@ -19,6 +19,9 @@
 
 #include <icetray/I3Module.h>
 #include <dataclasses/I3Time.h>
+#include <dataclasses/status/I3DetectorStatus.h>
+
+class GlobalTriggerSim;
 
 class I3GlobalTriggerSim : public I3Module
 {
@@ -60,6 +63,10 @@ private:
 
   boost::optional<std::pair<I3Time, I3Time> > time_range_;
 
+  // The readout windows are resolved once for each detector status
+  I3DetectorStatusConstPtr detectorStatus_;
+  boost::shared_ptr<GlobalTriggerSim> gts_;
+
   void PushIf(bool triggerCondition, I3FramePtr frame);
 
   SET_LOGGER("I3GlobalTriggerSim");
@@ -13,6 +13,9 @@
 #define I3PRUNER_H
 
 #include "icetray/I3ConditionalModule.h"
+#include "dataclasses/status/I3DetectorStatus.h"
+
+class ReadoutWindowUtil;
 /**
  * @brief IceTray module to remove launches outside the readout window
  */
@@ -35,6 +38,10 @@ private:
     std::vector<std::string> dataReadoutNames_;
     std::string triggerName_;
 
+    // The readout windows are resolved once for each detector status
+    I3DetectorStatusConstPtr detectorStatus_;
+    boost::shared_ptr<ReadoutWindowUtil> rwUtil_;
+
     SET_LOGGER("I3Pruner");
 
 };	// end of class I3Pruner
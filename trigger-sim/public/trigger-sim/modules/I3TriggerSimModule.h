@@ -12,6 +12,11 @@
 #ifndef I3TRIGGERSIMMODULE_H
 #define I3TRIGGERSIMMODULE_H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <icetray/I3Context.h>
 #include <icetray/I3Frame.h>
 #include <icetray/I3Module.h>
@@ -29,7 +34,10 @@
 #include <dataclasses/status/I3TriggerStatus.h>
 
 #include <trigger-sim/algorithms/TriggerHit.h>
+#include <trigger-sim/algorithms/TriggerHitCache.h>
 #include <trigger-sim/algorithms/TriggerService.h>
+#include <trigger-sim/utilities/DOMPositionTable.h>
+#include <trigger-sim/utilities/DOMSetTable.h>
 
 class I3TriggerSimModule : public I3Module
 {
@@ -44,17 +52,76 @@ class I3TriggerSimModule : public I3Module
   void Finish();
 
  private:
+  void BuildServices();
+
   std::string iniceLaunches_;
   std::string inicePulses_;
   std::string icetopLaunches_;
   std::string outputName_;
   std::string domsetsName_;
+  std::string fptEvaluationMode_;
+  unsigned int numThreads_;
+  std::string statisticsName_;
+  bool timeTriggerCuts_;
 
   I3MapKeyVectorIntConstPtr domsets_;
+  // Built once per D-frame from domsets_
+  DOMSetTableConstPtr domSetTable_;
 
   // Grab these in the Geometry() and DetectorStatus() functions
   std::map<TriggerKey, I3TriggerStatus> triggerConfigurations_;
   I3GeometryConstPtr geometry_;
+  // Built once per G-frame and shared by the pair-based triggers
+  DOMPositionTableConstPtr positions_;
+
+  // What a trigger configuration cost, summed over the DAQ frames.  The
+  // times are wall times in seconds.
+  struct ServiceStatistics
+  {
+    ServiceStatistics();
+
+    void Add(const ServiceStatistics& other);
+    // Adds an entry "<prefix>:<quantity>" for every number
+    void Write(I3MapStringDouble& map, const std::string& prefix) const;
+
+    unsigned long frames;
+    unsigned long hits;
+    unsigned long windows;
+    unsigned long triggers;
+    double fillHitsTime;
+    double triggerTime;
+    std::vector<std::string> cutNames;
+    std::vector<unsigned long> cutPassCounts;
+    std::vector<double> cutTimes;
+  };
+
+  // One service per trigger configuration, in the order of
+  // triggerConfigurations_.  They are built on the first DAQ frame after a
+  // G- or D-frame and only refilled with hits for every DAQ frame.
+  struct ConfiguredService
+  {
+    TriggerKey key;
+    std::unique_ptr<TriggerService> service;
+    // The current frame, and the sum in statistics_, which outlives the
+    // services
+    ServiceStatistics frameStatistics;
+    ServiceStatistics* statistics;
+  };
+  std::vector<ConfiguredService> services_;
+  bool servicesStale_;
+  std::map<TriggerKey, ServiceStatistics> statistics_;
+
+  // Name of a trigger configuration in the statistics
+  static std::string StatisticsLabel(const TriggerKey& key);
+  void PutStatistics(I3FramePtr frame) const;
+
+  // Fills the service with the hits of its source and runs it
+  void RunService(ConfiguredService& configured);
+
+  // The hits of the current frame, shared by all services
+  TriggerHitCache iniceLaunchHits_;
+  TriggerHitCache icetopLaunchHits_;
+  TriggerHitCache inicePulseHits_;
 
   SET_LOGGER("I3TriggerSimModule");
 };
@@ -0,0 +1,76 @@
+#ifndef DOM_POSITION_TABLE_H
+#define DOM_POSITION_TABLE_H
+/**
+ * class: DOMPositionTable
+ *
+ * Version $Id: $
+ *
+ * date: $Date: $
+ *
+ * (c) 2024 IceCube Collaboration
+ */
+
+#include <vector>
+#include "icetray/I3Logging.h"
+#include "icetray/OMKey.h"
+#include "dataclasses/geometry/I3Geometry.h"
+
+/**
+ * @brief Flat copy of the DOM positions in an I3Geometry, indexed by
+ *        (string, OM).
+ *
+ * The triggers that compare hit pairs (FPT, cylinder) need the positions
+ * of both DOMs for every pair.  Looking them up in the I3OMGeoMap means two
+ * tree walks per pair, so this table is built once per G-frame and the pair
+ * loops only touch contiguous doubles.  I3TriggerSimModule shares its table
+ * with these triggers; a trigger that is not given one builds its own
+ * from the geometry.
+ */
+class DOMPositionTable
+{
+ public:
+
+  DOMPositionTable(const I3Geometry& geometry);
+  ~DOMPositionTable();
+
+  /**
+   * Dense index of the DOM at (string, om), or -1 if it is not in the geometry.
+   */
+  int GetIndex(int string, unsigned int om) const {
+    if (string < minString_ || string > maxString_ || om > maxOM_)
+      return -1;
+    return index_[static_cast<size_t>(string - minString_)*(maxOM_ + 1) + om];
+  }
+  int GetIndex(const OMKey& omkey) const {
+    return GetIndex(omkey.GetString(), omkey.GetOM());
+  }
+
+  /**
+   * The (x, y, z) position of the DOM with the given dense index.
+   */
+  const double* GetPosition(int index) const { return &positions_[3*index]; }
+  double GetX(int index) const { return positions_[3*index]; }
+  double GetY(int index) const { return positions_[3*index + 1]; }
+  double GetZ(int index) const { return positions_[3*index + 2]; }
+
+  size_t GetNumberOfDOMs() const { return positions_.size()/3; }
+
+ private:
+
+  DOMPositionTable();
+
+  int minString_;
+  int maxString_;
+  unsigned int maxOM_;
+
+  // (string - minString_)*(maxOM_ + 1) + om -> dense DOM index, -1 if absent
+  std::vector<int> index_;
+  // x, y, z for each dense DOM index
+  std::vector<double> positions_;
+
+  SET_LOGGER("DOMPositionTable");
+};
+
+I3_POINTER_TYPEDEFS(DOMPositionTable);
+
+#endif // DOM_POSITION_TABLE_H
@@ -15,6 +15,7 @@
 #include <icetray/OMKey.h>
 #include <dataclasses/I3Map.h>
 #include <boost/assign/list_of.hpp>
+#include <trigger-sim/utilities/DOMSetTable.h>
 
 /**
  * @brief Contains functions useful for handling DOMsets.
@@ -39,6 +40,14 @@ namespace DOMSetFunctions{
   const std::vector<unsigned> DOMSETS = boost::assign::list_of(2)(3)(4)(5)(6)(7)(8)(9)(10)(11);
   bool InDOMSet(const OMKey& dom, const unsigned& domSet,
                 const I3MapKeyVectorIntConstPtr &domSets);
+
+  /**
+   * Same as above, with the DOMSets map compiled into a DOMSetTable.
+   * The answer (and the error for DOMs that are not in the map) is the
+   * same, but most queries don't touch the map.
+   */
+  bool InDOMSet(const OMKey& dom, const unsigned& domSet,
+                const DOMSetTable& domSets);
     
   I3MapKeyVectorIntPtr GetDefaultDOMSets();
 
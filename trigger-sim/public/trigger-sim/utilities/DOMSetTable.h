@@ -0,0 +1,100 @@
+#ifndef DOM_SET_TABLE_H
+#define DOM_SET_TABLE_H
+/**
+ * class: DOMSetTable
+ *
+ * Version $Id: $
+ *
+ * date: $Date: $
+ *
+ * (c) 2024 IceCube Collaboration
+ */
+
+#include <vector>
+#include <stdint.h>
+#include "icetray/I3Logging.h"
+#include "icetray/OMKey.h"
+#include "dataclasses/I3Map.h"
+
+/**
+ * @brief Compiled form of a DOMSets map (I3MapKeyVectorInt), indexed by
+ *        (string, OM).
+ *
+ * Every DOM of the map gets a 32 bit mask with one bit per DOM set it
+ * belongs to.  The bits are handed out to the DOM set IDs in increasing
+ * order, so the first 32 distinct IDs of the map have one; GetBit tells
+ * which.  The table is built once per D-frame, after which a DOM set test
+ * is an array lookup and an AND instead of a map lookup and a vector scan.
+ */
+class DOMSetTable
+{
+ public:
+
+  static const unsigned int MAX_BITS = 32;
+
+  DOMSetTable(I3MapKeyVectorIntConstPtr domSets);
+  ~DOMSetTable();
+
+  /**
+   * The map the table was built from.
+   */
+  const I3MapKeyVectorIntConstPtr& GetDOMSets() const { return domSets_; }
+
+  /**
+   * Whether the DOM is in the map.  Only DOMs with PMT 0 are in the table,
+   * which is how the DOMSets maps are keyed.
+   */
+  bool Contains(const OMKey& dom) const {
+    int slot = GetSlot(dom);
+    return slot >= 0 && known_[slot];
+  }
+
+  /**
+   * The DOM set mask of the DOM, 0 if it is not in the map.
+   */
+  uint32_t GetMask(const OMKey& dom) const {
+    int slot = GetSlot(dom);
+    return slot < 0 ? 0 : masks_[slot];
+  }
+
+  /**
+   * The mask bit of the DOM set, 0 if the DOM set has none.
+   */
+  uint32_t GetBit(unsigned int domSet) const;
+
+  /**
+   * Whether every DOM set of the map has a bit.  If so, a DOM set without
+   * a bit has no DOMs.
+   */
+  bool HasAllDOMSets() const { return !truncated_; }
+
+ private:
+
+  DOMSetTable();
+
+  int GetSlot(const OMKey& dom) const {
+    if (dom.GetPMT() != 0 || dom.GetString() < minString_ ||
+        dom.GetString() > maxString_ || dom.GetOM() > maxOM_)
+      return -1;
+    return static_cast<int>(static_cast<size_t>(dom.GetString() - minString_)*(maxOM_ + 1) + dom.GetOM());
+  }
+
+  I3MapKeyVectorIntConstPtr domSets_;
+
+  int minString_;
+  int maxString_;
+  unsigned int maxOM_;
+
+  // (string - minString_)*(maxOM_ + 1) + om -> DOM set mask
+  std::vector<uint32_t> masks_;
+  std::vector<uint8_t> known_;
+  // DOM set ID of each bit
+  std::vector<unsigned int> bitDOMSets_;
+  bool truncated_;
+
+  SET_LOGGER("DOMSetTable");
+};
+
+I3_POINTER_TYPEDEFS(DOMSetTable);
+
+#endif // DOM_SET_TABLE_H
@@ -16,11 +16,17 @@
 #include "dataclasses/TriggerKey.h"
 #include "dataclasses/status/I3DetectorStatus.h"
 #include "dataclasses/status/I3TriggerStatus.h"
+#include <utility>
+#include <vector>
 
 /**
  * @brief Utility class to provide methods to retrieve readout windows
  *        for various trigger conditions.  It's more complicated than you
  *        may think.
+ *
+ * The readout settings of every trigger are resolved once, when the
+ * utility is made from the detector status, so looking up a window
+ * doesn't touch the trigger status maps.
  */
 class ReadoutWindowUtil
 {
@@ -30,18 +36,32 @@ class ReadoutWindowUtil
   ReadoutWindowUtil(const I3DetectorStatus& detectorStatus);
   ~ReadoutWindowUtil();
 
-  std::pair<double,double> GetInIceReadoutWindow(const I3Trigger& trigger);
-  std::pair<double,double> GetIceTopReadoutWindow(const I3Trigger& trigger);
+  std::pair<double,double> GetInIceReadoutWindow(const I3Trigger& trigger) const;
+  std::pair<double,double> GetIceTopReadoutWindow(const I3Trigger& trigger) const;
 
   std::pair<double,double> GetReadoutWindow(I3TriggerStatus::Subdetector subdetector, 
-					    const I3Trigger& trigger);
+					    const I3Trigger& trigger) const;
 
-  double GetEarliestReadoutTime(const I3Trigger& trigger);
-  double GetLatestReadoutTime(const I3Trigger& trigger);
+  double GetEarliestReadoutTime(const I3Trigger& trigger) const;
+  double GetLatestReadoutTime(const I3Trigger& trigger) const;
 
  private:
 
-  std::map<TriggerKey, I3TriggerStatus> triggerStatus_;
+  // NOT_SPECIFIED, ALL, ICETOP and INICE
+  static const int N_SUBDETECTORS = 4;
+
+  /**
+   * The readout config used for each subdetector, that is the one for
+   * ALL if there is one, otherwise the subdetector's own.
+   */
+  struct ResolvedReadout
+  {
+    bool found[N_SUBDETECTORS];
+    I3TriggerReadoutConfig config[N_SUBDETECTORS];
+  };
+
+  // sorted by TriggerKey
+  std::vector<std::pair<TriggerKey, ResolvedReadout> > readouts_;
 
 };
 
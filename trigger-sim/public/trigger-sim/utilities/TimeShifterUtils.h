@@ -15,6 +15,11 @@
 I3_FORWARD_DECLARATION(I3Frame);
 
 namespace TimeShifterUtils {			    
+  /**
+   * Subtract dt from the times of the known time-like objects in the frame.
+   * An object that only the frame refers to is shifted in place, all
+   * others are copied first.
+   */
   void ShiftFrameObjects(I3FramePtr frame, 
                          double dt, 
                          const std::vector<std::string>& skip_keys,
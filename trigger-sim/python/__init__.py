@@ -82,6 +82,7 @@ def TriggerSim(tray,
                time_shift = True,
                time_shift_args = None,
                filter_mode = True,
+               num_threads = 1,
                **kwargs):
     """
     Configure triggers according to the GCD file.
@@ -97,6 +98,7 @@ def TriggerSim(tray,
         time_shift: Whether to time shift time-like frame objects.  Nearly everyone will want to keep this set at True.  It makes simulation look more like data.
         time_shift_args: dict that's forwarded to the I3TimeShifter module.
         filter_mode: Whether to filter frames that do not trigger.
+        num_threads: The number of threads that run the triggers of a frame.  The triggers are the same for any number.
 
     This ignores AMANDA triggers and only supports the following modules:
 
@@ -135,7 +137,8 @@ def TriggerSim(tray,
     # so just run it separately for now.
     #====================================
     tray.AddModule("I3TriggerSimModule",
-                   InIcePulses = "I3RecoPulseSeriesMapExtensions")
+                   InIcePulses = "I3RecoPulseSeriesMapExtensions",
+                   NumThreads = num_threads)
 
     tray.AddModule("I3GlobalTriggerSim",name + "_global_trig",
                    RunID = run_id,
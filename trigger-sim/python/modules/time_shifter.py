@@ -110,6 +110,11 @@ class I3TimeShifter(icetray.I3Module) :
         if isnan(DELTA_T) :
             raise ValueError("DELTA_T is 'NaN'")            
 
+        # Let go of the frame objects we looked at.  ShiftFrameObjects
+        # shifts an object in place when the frame holds the only
+        # reference to it, and copies it otherwise.
+        frame_object = series = None
+
         # This is where the shifting is done.
         # The code is in trigger-sim/utilities/TimeShifterUtils.h(cxx)
         # This shifts everything by type unless the user explicitly
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+
+# I3GlobalTriggerSim and I3Pruner keep the readout settings of the last
+# I3DetectorStatus they saw.  Check that they follow the detector status
+# when it changes between frames, and back again.
+
+from icecube.icetray import I3Tray
+from icecube import icetray
+from icecube import dataclasses
+from icecube.dataclasses import TriggerKey, I3TriggerStatus
+from icecube import trigger_sim
+
+DOM = icetray.OMKey(21, 30)
+SMT = TriggerKey(dataclasses.SourceID.IN_ICE, dataclasses.TypeID.SIMPLE_MULTIPLICITY, 1006)
+TRIGGER_TIME = 10000.
+TRIGGER_LENGTH = 1000.
+LAUNCH_TIMES = [5000., 7000., 10000., 15000., 18000.]
+
+def make_status(minus, plus):
+    config = I3TriggerStatus()
+    config.trigger_name = "SimpleMajorityTrigger"
+    config.readout_settings[I3TriggerStatus.Subdetector.INICE] = I3TriggerStatus.I3TriggerReadoutConfig()
+    config.readout_settings[I3TriggerStatus.Subdetector.INICE].readout_time_minus = minus
+    config.readout_settings[I3TriggerStatus.Subdetector.INICE].readout_time_plus = plus
+    config.readout_settings[I3TriggerStatus.Subdetector.INICE].readout_time_offset = 0
+    status = dataclasses.I3DetectorStatus()
+    status.trigger_status[SMT] = config
+    return status
+
+# The same status objects are put into several frames, as if they came
+# from the same D frame.  Each entry is the status and the readout window
+# it gives the trigger.
+STATUS_A = (make_status(4000., 6000.), (6000., 17000.))
+STATUS_B = (make_status(1000., 2000.), (9000., 13000.))
+STATUSES = [STATUS_A, STATUS_A, STATUS_B, STATUS_B, STATUS_A]
+
+frame_count = [0]
+
+def setup(frame):
+    frame["I3DetectorStatus"] = STATUSES[frame_count[0]][0]
+
+    geometry = dataclasses.I3Geometry()
+    omgeo = dataclasses.I3OMGeo()
+    omgeo.omtype = dataclasses.I3OMGeo.IceCube
+    geometry.omgeo[DOM] = omgeo
+    frame["I3Geometry"] = geometry
+
+    trigger = dataclasses.I3Trigger()
+    trigger.key = SMT
+    trigger.time = TRIGGER_TIME
+    trigger.length = TRIGGER_LENGTH
+    trigger.fired = True
+    triggers = dataclasses.I3TriggerHierarchy()
+    triggers.insert(trigger)
+    frame["I3Triggers"] = triggers
+
+    series = dataclasses.I3DOMLaunchSeries()
+    for time in LAUNCH_TIMES:
+        launch = dataclasses.I3DOMLaunch()
+        launch.time = time
+        series.append(launch)
+    launches = dataclasses.I3DOMLaunchSeriesMap()
+    launches[DOM] = series
+    frame["InIceRawData"] = launches
+
+def check(frame):
+    window = STATUSES[frame_count[0]][1]
+    frame_count[0] += 1
+
+    # the global triggers span the readout window of the SMT
+    global_triggers = [t for t in frame["I3TriggerHierarchy"]
+                       if t.key.source == dataclasses.SourceID.GLOBAL]
+    assert len(global_triggers), "no global triggers"
+    for t in global_triggers:
+        print("global trigger", t.key, t.time, t.time + t.length)
+        assert (t.time, t.time + t.length) == window, \
+            "global trigger from %f to %f, expected %s" % (t.time, t.time + t.length, window)
+
+    # and only the launches inside of it are kept
+    kept = [l.time for l in frame["InIceRawData"][DOM]]
+    expected = [t for t in LAUNCH_TIMES if window[0] <= t <= window[1]]
+    print("launches kept at", kept)
+    assert kept == expected, "launches kept at %s, expected %s" % (kept, expected)
+
+tray = I3Tray()
+tray.AddModule("I3InfiniteSource", stream = icetray.I3Frame.DAQ)
+tray.AddModule(setup, streams = [icetray.I3Frame.DAQ])
+tray.AddModule("I3GlobalTriggerSim",
+               I3TriggerName = "I3Triggers",
+               GlobalTriggerName = "I3TriggerHierarchy",
+               RunID = 0)
+tray.AddModule("I3Pruner", DOMLaunchSeriesMapNames = ["InIceRawData"])
+tray.AddModule(check, streams = [icetray.I3Frame.DAQ])
+tray.Execute(len(STATUSES))
+
+assert frame_count[0] == len(STATUSES), "only %d frames were checked" % frame_count[0]
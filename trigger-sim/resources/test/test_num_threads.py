@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+# Running the triggers of a frame on several threads has to give
+# exactly the triggers of the serial run, in the same order.
+from icecube.icetray import I3Tray
+
+from icecube import icetray, dataclasses, dataio, trigger_sim
+
+from os.path import expandvars
+
+from modules.inice_test_modules import TestSource
+
+def CompareTriggers(frame):
+    serial = frame["SerialTriggers"]
+    parallel = frame["ParallelTriggers"]
+    assert len(serial) == len(parallel), "Different number of triggers"
+    for s, p in zip(serial, parallel):
+        assert s.key == p.key, "Different trigger keys"
+        assert s.time == p.time, "Different trigger times"
+        assert s.length == p.length, "Different trigger lengths"
+
+tray = I3Tray()
+
+gcd_file = expandvars("$I3_TESTDATA/GCD/GeoCalibDetectorStatus_2013.56429_V1.i3.gz")
+tray.AddModule("I3InfiniteSource", prefix=gcd_file, stream=icetray.I3Frame.DAQ)
+
+tray.AddModule(TestSource, NDOMs = 500, TimeWindow = 20000.)
+
+tray.AddModule(trigger_sim.InjectDefaultDOMSets)
+
+tray.AddModule("I3TriggerSimModule", "serial",
+               OutputName = "SerialTriggers")
+
+tray.AddModule("I3TriggerSimModule", "parallel",
+               OutputName = "ParallelTriggers",
+               NumThreads = 4)
+
+tray.AddModule(CompareTriggers, streams = [icetray.I3Frame.DAQ])
+
+tray.Execute(100)
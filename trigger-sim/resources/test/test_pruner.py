@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+
+# The I3Pruner keeps the launches inside the readout windows of the
+# triggers.  Overlapping windows are merged, and triggers without a
+# readout window (NaN) must not keep anything.
+
+from icecube.icetray import I3Tray
+from icecube import icetray
+from icecube import dataclasses
+from icecube.dataclasses import TriggerKey, I3TriggerStatus
+
+INICE_DOM = icetray.OMKey(21, 30)
+ICETOP_DOM = icetray.OMKey(21, 61)
+
+SMT = TriggerKey(dataclasses.SourceID.IN_ICE, dataclasses.TypeID.SIMPLE_MULTIPLICITY, 1006)
+# only has IceTop readout settings, so no in-ice readout window
+ICETOP_ONLY = TriggerKey(dataclasses.SourceID.IN_ICE, dataclasses.TypeID.SIMPLE_MULTIPLICITY, 1011)
+# not in the detector status at all
+UNKNOWN = TriggerKey(dataclasses.SourceID.IN_ICE, dataclasses.TypeID.SIMPLE_MULTIPLICITY, 9999)
+
+LAUNCH_TIMES = [5999., 6000., 12000., 20000., 21000., 21001.,
+                30000., 40000., 50000., 60000.]
+# SMT triggers at 10000 and 14000 read out [6000, 17000] and [10000, 21000],
+# merged into [6000, 21000]; the one at 50000 reads out [46000, 56000].
+# The triggers at 30000 and 40000 have no in-ice readout window.
+EXPECTED_INICE = [6000., 12000., 20000., 21000., 50000.]
+# The IceTop window of the ICETOP_ONLY trigger at 40000 is [39000, 41000]
+EXPECTED_ICETOP = [40000.]
+
+def make_config(subdetector, minus, plus):
+    config = I3TriggerStatus()
+    config.trigger_name = "SimpleMajorityTrigger"
+    config.readout_settings[subdetector] = I3TriggerStatus.I3TriggerReadoutConfig()
+    config.readout_settings[subdetector].readout_time_minus = minus
+    config.readout_settings[subdetector].readout_time_plus = plus
+    config.readout_settings[subdetector].readout_time_offset = 0
+    return config
+
+def make_trigger(key, time, length):
+    t = dataclasses.I3Trigger()
+    t.key = key
+    t.time = time
+    t.length = length
+    t.fired = True
+    return t
+
+def setup(frame):
+    geometry = dataclasses.I3Geometry()
+    inice = dataclasses.I3OMGeo()
+    inice.omtype = dataclasses.I3OMGeo.IceCube
+    geometry.omgeo[INICE_DOM] = inice
+    icetop = dataclasses.I3OMGeo()
+    icetop.omtype = dataclasses.I3OMGeo.IceTop
+    geometry.omgeo[ICETOP_DOM] = icetop
+    frame["I3Geometry"] = geometry
+
+    status = dataclasses.I3DetectorStatus()
+    status.trigger_status[SMT] = make_config(I3TriggerStatus.Subdetector.INICE, 4000., 6000.)
+    status.trigger_status[ICETOP_ONLY] = make_config(I3TriggerStatus.Subdetector.ICETOP, 1000., 1000.)
+    frame["I3DetectorStatus"] = status
+
+    triggers = dataclasses.I3TriggerHierarchy()
+    triggers.insert(make_trigger(SMT, 10000., 1000.))
+    triggers.insert(make_trigger(SMT, 14000., 1000.))
+    triggers.insert(make_trigger(UNKNOWN, 30000., 1000.))
+    triggers.insert(make_trigger(ICETOP_ONLY, 40000., 0.))
+    triggers.insert(make_trigger(SMT, 50000., 0.))
+    frame["I3TriggerHierarchy"] = triggers
+
+    launches = dataclasses.I3DOMLaunchSeriesMap()
+    for dom in [INICE_DOM, ICETOP_DOM]:
+        series = dataclasses.I3DOMLaunchSeries()
+        for time in LAUNCH_TIMES:
+            launch = dataclasses.I3DOMLaunch()
+            launch.time = time
+            series.append(launch)
+        launches[dom] = series
+    frame["InIceRawData"] = launches
+
+def check(frame):
+    launches = frame["InIceRawData"]
+    inice = [l.time for l in launches[INICE_DOM]] if INICE_DOM in launches else []
+    icetop = [l.time for l in launches[ICETOP_DOM]] if ICETOP_DOM in launches else []
+    print("in-ice launches kept at", inice)
+    print("IceTop launches kept at", icetop)
+    assert inice == EXPECTED_INICE, "in-ice launches kept at %s" % inice
+    assert icetop == EXPECTED_ICETOP, "IceTop launches kept at %s" % icetop
+
+tray = I3Tray()
+tray.AddModule("I3InfiniteSource", stream = icetray.I3Frame.DAQ)
+tray.AddModule(setup, streams = [icetray.I3Frame.DAQ])
+tray.AddModule("I3Pruner", DOMLaunchSeriesMapNames = ["InIceRawData"])
+tray.AddModule(check, streams = [icetray.I3Frame.DAQ])
+tray.Execute(1)
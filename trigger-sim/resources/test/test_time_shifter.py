@@ -252,3 +252,37 @@ tray.AddModule(I3TimeShifter, \
                ShiftI3DoubleKeys = ["SomeTime"])
 tray.AddModule(TestShift, streams = [icetray.I3Frame.DAQ])
 tray.Execute(1)
+
+# The shifter shifts objects nothing else refers to in place, and copies
+# the ones that are still referenced elsewhere, e.g. from python.  The
+# copy is shifted, the object that is held on to has to stay as it was.
+held = {}
+def hold_frame_object(frame, key) :
+    held[key] = frame[key]
+
+def TestShared(frame) :
+    for om,ls in held["DOMLaunchMap"] :
+        for l in ls :
+            assert l.time == TIME, "held I3DOMLaunch was changed, t = %f" % l.time
+    for om,ls in frame["DOMLaunchMap"] :
+        for l in ls :
+            assert l.time == 0, "shared I3DOMLaunch t = %f" % l.time
+    assert held["SomeTime"].value == TIME, \
+        "held SomeTime was changed, value = %f" % held["SomeTime"].value
+
+tray = I3Tray()
+tray.AddModule("I3InfiniteSource")
+tray.AddModule(TestSetup, streams = [icetray.I3Frame.DAQ])
+tray.AddModule(hold_frame_object, \
+               streams = [icetray.I3Frame.DAQ], \
+               key = "DOMLaunchMap")
+tray.AddModule(hold_frame_object, \
+               streams = [icetray.I3Frame.DAQ], \
+               key = "SomeTime")
+tray.AddModule(I3TimeShifter,\
+               SkipKeys = ["NotTime"],
+               ShiftI3DoubleKeys = ["SomeTime"])
+# the unshared objects are checked by TestShift
+tray.AddModule(TestShift, streams = [icetray.I3Frame.DAQ])
+tray.AddModule(TestShared, streams = [icetray.I3Frame.DAQ])
+tray.Execute(1)
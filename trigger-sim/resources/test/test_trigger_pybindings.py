@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# The triggers run from python on numpy arrays of hits have to find
+# the same triggers as on the I3DOMLaunchSeriesMap of the same launches.
+import numpy
+
+from icecube import icetray, dataclasses, dataio, trigger_sim
+from icecube.icetray import I3Units
+
+from os.path import expandvars
+
+gcd_file = expandvars("$I3_TESTDATA/GCD/GeoCalibDetectorStatus_2013.56429_V1.i3.gz")
+geometry = dataio.I3File(gcd_file).pop_frame(icetray.I3Frame.Geometry)["I3Geometry"]
+
+def AllTriggers(service):
+    triggers = []
+    for i in range(service.GetNumberOfTriggers()):
+        triggers.append([(hit.time, hit.string, hit.om) for hit in service.GetNextTrigger()])
+    return triggers
+
+def Compare(make_service, launches, hits, useSLC):
+    from_map = make_service()
+    from_map.FillHits(launches, dataclasses.I3RecoPulseSeriesMap(), useSLC)
+    from_map.Trigger()
+
+    from_arrays = make_service()
+    from_arrays.FillHits(hits, useSLC)
+    from_arrays.Trigger()
+
+    assert from_map.GetNumberOfWindows() == from_arrays.GetNumberOfWindows(), "Different windows"
+    assert from_map.GetCutPassCounts() == from_arrays.GetCutPassCounts(), "Different cut counts"
+    triggers = AllTriggers(from_map)
+    assert triggers == AllTriggers(from_arrays), "Different triggers"
+    return len(triggers)
+
+rng = numpy.random.default_rng(1234)
+in_ice = [key for key, omgeo in geometry.omgeo.items()
+          if omgeo.omtype == dataclasses.I3OMGeo.OMType.IceCube]
+
+ntriggers = {"SMT": 0, "FPT": 0, "SLOP": 0}
+for event in range(20):
+    # noise plus a slow particle crossing a few strings
+    n = 200 + rng.integers(200)
+    doms = [in_ice[i] for i in rng.integers(len(in_ice), size = n)]
+    times = list(rng.uniform(0, 20000, n))
+    lcs = list(rng.uniform(0, 1, n) < 0.3)
+    first = rng.integers(len(in_ice) - 60)
+    t0 = rng.uniform(0, 10000)
+    for i in range(15):
+        doms.append(in_ice[first + (4*i) % 60])
+        times.append(t0 + 100*i)
+        lcs.append(i % 2 == 0)
+    # and a slow monopole going down a string of DOM set 2, one HLC pair
+    # every 50 microseconds
+    string = 1 + int(rng.integers(78))
+    om = 1 + int(rng.integers(30))
+    for i in range(8):
+        for dt, dom in [(0, icetray.OMKey(string, om + 3*i)), (200, icetray.OMKey(string, om + 3*i + 1))]:
+            doms.append(dom)
+            times.append(30000 + 50000*i + dt)
+            lcs.append(True)
+
+    launches = dataclasses.I3DOMLaunchSeriesMap()
+    for dom, time, lc in zip(doms, times, lcs):
+        launch = dataclasses.I3DOMLaunch()
+        launch.SetStartTime(time)
+        launch.SetLCBit(bool(lc))
+        if dom not in launches:
+            launches[dom] = dataclasses.I3DOMLaunchSeries()
+        launches[dom].append(launch)
+
+    hits = trigger_sim.TriggerHitsFromArrays(numpy.array(times),
+                                             numpy.array([dom.string for dom in doms]),
+                                             numpy.array([dom.om for dom in doms]),
+                                             numpy.array(lcs))
+    assert all(a.time <= b.time for a, b in zip(hits[:-1], hits[1:])), "Hits not time ordered"
+
+    ntriggers["SMT"] += Compare(lambda: trigger_sim.SimpleMajorityTrigger(5*I3Units.microsecond, 8, 2, None),
+                                launches, hits, False)
+
+    def fpt():
+        trigger = trigger_sim.FaintParticleTrigger(2000, 500, 6000, 4, 80, 1e5, 3e6, 5, 6, 5, 10, 0.,
+                                                   geometry, 2, None)
+        trigger.SetEvaluationMode(trigger_sim.FPTEvaluationMode.ROLLING_PAIR_CACHE)
+        return trigger
+    ntriggers["FPT"] += Compare(fpt, launches, hits, True)
+
+    ntriggers["SLOP"] += Compare(lambda: trigger_sim.SlowMonopoleTrigger(2500, 0, 500000, 100, None, True, 0.5, 5,
+                                                                         5000000, geometry, 2, None),
+                                 launches, hits, False)
+
+    # the time windows of the first and fourth FPT cut
+    time_window = trigger_sim.FPTTimeWindow(4, 80, 0., 2000, 500)
+    hit_ranges, time_ranges = time_window.FPTFixedTimeWindows(hits, 500)
+    assert len(hit_ranges) == len(time_ranges)
+    assert time_window.GetNumberPassingHitCount() >= len(hit_ranges)
+    for (first, end), (start, stop) in zip(hit_ranges, time_ranges):
+        assert all(start <= hit.time < stop for hit in hits[first:end]), "Hit outside of its window"
+        assert 4 <= end - first <= 80, "Window does not pass the hit count cut"
+
+print(ntriggers)
+assert ntriggers["FPT"] > 0, "Not a single FPT trigger, the comparison is trivial"
+assert ntriggers["SLOP"] > 0, "Not a single SLOP trigger, the comparison is trivial"